@@ -0,0 +1,69 @@
+/*
+ * cd4066_rc.c
+ *
+ * An RC network charging from 5V turns on a 4066 switch after about
+ * 10ms, the switch then charges a second RC network. The 4066 couples
+ * the two solver groups, they are solved in order on the caller. The
+ * third RC network is independent and is solved on the worker pool.
+ *
+ */
+
+
+#include "netlist/devices/net_lib.h"
+
+NETLIST_START(cd4066_rc)
+    /* Standard stuff */
+
+    SOLVER(Solver, 48000)
+    PARAM(Solver.PARALLEL, 1)
+    PARAM(Solver.PARALLEL_THRESHOLD, 1)
+
+    ANALOG_INPUT(V5, 5)
+
+    CD_4066_DIP(SW)
+
+    NET_C(SW.7,  GND)
+    NET_C(SW.14, V5)
+
+    /* control */
+    RES(R1, 10000)
+    CAP(C1, 1e-6)
+
+    NET_C(V5, R1.1)
+    NET_C(R1.2, C1.1)
+    NET_C(C1.2, GND)
+    NET_C(SW.13, R1.2)
+
+    /* switched */
+    RES(R2, 1000)
+    CAP(C2, 1e-6)
+
+    NET_C(SW.1, V5)
+    NET_C(SW.2, R2.1)
+    NET_C(R2.2, C2.1)
+    NET_C(C2.2, GND)
+
+    /* independent */
+    RES(R3, 1000)
+    CAP(C3, 1e-6)
+
+    NET_C(V5, R3.1)
+    NET_C(R3.2, C3.1)
+    NET_C(C3.2, GND)
+
+    // ground anything else
+
+    NET_C(SW.3, GND)
+    NET_C(SW.4, GND)
+    NET_C(SW.5, GND)
+    NET_C(SW.6, GND)
+    NET_C(SW.8, GND)
+    NET_C(SW.9, GND)
+    NET_C(SW.10, GND)
+    NET_C(SW.11, GND)
+    NET_C(SW.12, GND)
+
+    LOG(logB, R1.2)
+    LOG(logC, R2.2)
+
+NETLIST_END()
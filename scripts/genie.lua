@@ -128,6 +128,11 @@ newoption {
     description = 'Build bundled PortMidi library',
 }
 
+newoption {
+    trigger = 'with-zstd',
+    description = 'Build the Zstandard CHD codecs against the system libzstd',
+}
+
 newoption {
 	trigger = "distro",
 	description = "Choose distribution",
@@ -660,6 +665,12 @@ if not _OPTIONS["with-bundled-sqlite3"] then
 	}
 	end
 
+if _OPTIONS["with-zstd"] then
+	defines {
+		"USE_ZSTD",
+	}
+	end
+
 if _OPTIONS["NOASM"]=="1" then
 	defines {
 		"MAME_NOASM"
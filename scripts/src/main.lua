@@ -133,6 +133,12 @@ end
 		}
 	end
 
+	if _OPTIONS["with-zstd"] then
+		links {
+			"zstd",
+		}
+	end
+
 	if _OPTIONS["with-bundled-sqlite3"] then
 		links {
 			"sqllite3",
@@ -62,12 +62,14 @@ project "netlist"
 		MAME_DIR .. "src/emu/netlist/analog/nld_opamps.h",
     MAME_DIR .. "src/emu/netlist/solver/nld_solver.c",
     MAME_DIR .. "src/emu/netlist/solver/nld_solver.h",
+    MAME_DIR .. "src/emu/netlist/solver/nld_static_solvers.c",
 		MAME_DIR .. "src/emu/netlist/solver/nld_ms_direct.h",
 		MAME_DIR .. "src/emu/netlist/solver/nld_ms_direct1.h",
 		MAME_DIR .. "src/emu/netlist/solver/nld_ms_direct2.h",
 		MAME_DIR .. "src/emu/netlist/solver/nld_ms_sor.h",
     MAME_DIR .. "src/emu/netlist/solver/nld_ms_sor_math.h",
     MAME_DIR .. "src/emu/netlist/solver/nld_ms_gmres.h",
+    MAME_DIR .. "src/emu/netlist/solver/nld_ms_sparse.h",
 		MAME_DIR .. "src/emu/netlist/devices/nld_4020.c",
 		MAME_DIR .. "src/emu/netlist/devices/nld_4020.h",
 		MAME_DIR .. "src/emu/netlist/devices/nld_4066.c",
@@ -93,6 +93,12 @@ else
 	}
 end
 
+if _OPTIONS["with-zstd"] then
+	links {
+		"zstd",
+	}
+end
+
 includedirs {
 	MAME_DIR .. "src/osd",
 	MAME_DIR .. "src/lib/util",
@@ -198,6 +204,12 @@ else
 	}
 end
 
+if _OPTIONS["with-zstd"] then
+	links {
+		"zstd",
+	}
+end
+
 includedirs {
 	MAME_DIR .. "src/osd",
 	MAME_DIR .. "src/emu",
@@ -257,6 +269,12 @@ else
 	}
 end
 
+if _OPTIONS["with-zstd"] then
+	links {
+		"zstd",
+	}
+end
+
 includedirs {
 	MAME_DIR .. "src/osd",
 	MAME_DIR .. "src/lib/util",
@@ -314,6 +332,12 @@ else
 	}
 end
 
+if _OPTIONS["with-zstd"] then
+	links {
+		"zstd",
+	}
+end
+
 includedirs {
 	MAME_DIR .. "src/osd",
 	MAME_DIR .. "src/lib/util",
@@ -506,6 +530,12 @@ else
 	}
 end
 
+if _OPTIONS["with-zstd"] then
+	links {
+		"zstd",
+	}
+end
+
 includedirs {
 	MAME_DIR .. "src/osd",
 	MAME_DIR .. "src/lib/util",
@@ -560,6 +590,158 @@ files {
 	MAME_DIR .. "src/tools/pngcmp.c",
 }
 
+--------------------------------------------------
+-- blitbench
+--------------------------------------------------
+
+project("blitbench")
+uuid ("0b8f7e1c-6a3d-4d2b-9e55-3c1a7f2d9b64")
+kind "ConsoleApp"	
+
+options {
+	"ForceCPP",
+}
+
+flags {
+	"Symbols", -- always include minimum symbols for executables 	
+}
+
+if _OPTIONS["SEPARATE_BIN"]~="1" then 
+	targetdir(MAME_DIR)
+end
+
+links {
+	"ocore_" .. _OPTIONS["osd"],
+}
+
+includedirs {
+	MAME_DIR .. "src/osd",
+	MAME_DIR .. "src/emu",
+	MAME_DIR .. "src/lib/util",
+}
+
+files {
+	MAME_DIR .. "src/tools/blitbench.c",
+}
+
+--------------------------------------------------
+-- hashbench
+--------------------------------------------------
+
+project("hashbench")
+uuid ("5c2e9a41-8f3b-4e07-a6d2-71b4c0e8f395")
+kind "ConsoleApp"
+
+options {
+	"ForceCPP",
+}
+
+flags {
+	"Symbols", -- always include minimum symbols for executables
+}
+
+if _OPTIONS["SEPARATE_BIN"]~="1" then
+	targetdir(MAME_DIR)
+end
+
+links {
+	"utils",
+	"ocore_" .. _OPTIONS["osd"],
+}
+
+if _OPTIONS["with-bundled-zlib"] then
+	links {
+		"zlib",
+	}
+else
+	links {
+		"z",
+	}
+end
+
+includedirs {
+	MAME_DIR .. "src/osd",
+	MAME_DIR .. "src/lib/util",
+}
+
+files {
+	MAME_DIR .. "src/tools/hashbench.c",
+}
+
+--------------------------------------------------
+-- wavcmp
+--------------------------------------------------
+
+project("wavcmp")
+uuid ("a3d81f6e-2c47-4b95-8e0a-d64f1b7c2e58")
+kind "ConsoleApp"
+
+options {
+	"ForceCPP",
+}
+
+flags {
+	"Symbols", -- always include minimum symbols for executables
+}
+
+if _OPTIONS["SEPARATE_BIN"]~="1" then
+	targetdir(MAME_DIR)
+end
+
+links {
+	"ocore_" .. _OPTIONS["osd"],
+}
+
+includedirs {
+	MAME_DIR .. "src/osd",
+	MAME_DIR .. "src/lib/util",
+}
+
+files {
+	MAME_DIR .. "src/tools/wavcmp.c",
+}
+
+--------------------------------------------------
+-- ymbench
+--------------------------------------------------
+
+project("ymbench")
+uuid ("ceeaadd8-34d0-46b9-ad64-02997c17016c")
+kind "ConsoleApp"
+
+options {
+	"ForceCPP",
+}
+
+flags {
+	"Symbols", -- always include minimum symbols for executables
+}
+
+if _OPTIONS["SEPARATE_BIN"]~="1" then
+	targetdir(MAME_DIR)
+end
+
+links {
+	"ocore_" .. _OPTIONS["osd"],
+}
+
+-- the stand-in emu.h must be found instead of the real one
+includedirs {
+	MAME_DIR .. "src/tools/ymbench",
+	MAME_DIR .. "src/emu/sound",
+	MAME_DIR .. "src/osd",
+	MAME_DIR .. "src/lib/util",
+}
+
+files {
+	MAME_DIR .. "src/tools/ymbench.c",
+	MAME_DIR .. "src/emu/sound/ym2151.c",
+	MAME_DIR .. "src/emu/sound/fm.c",
+	MAME_DIR .. "src/emu/sound/fm2612.c",
+	MAME_DIR .. "src/emu/sound/fmopl.c",
+	MAME_DIR .. "src/emu/sound/ymdeltat.c",
+}
+
 --------------------------------------------------
 -- nltool
 --------------------------------------------------
@@ -608,6 +790,12 @@ else
 	}
 end
 
+if _OPTIONS["with-zstd"] then
+	links {
+		"zstd",
+	}
+end
+
 includedirs {
 	MAME_DIR .. "src/osd",
 	MAME_DIR .. "src/lib/util",
@@ -666,6 +854,12 @@ else
 	}
 end
 
+if _OPTIONS["with-zstd"] then
+	links {
+		"zstd",
+	}
+end
+
 includedirs {
 	MAME_DIR .. "src/osd",
 	MAME_DIR .. "src/lib",	
@@ -725,6 +919,12 @@ else
 	}
 end
 
+if _OPTIONS["with-zstd"] then
+	links {
+		"zstd",
+	}
+end
+
 includedirs {
 	MAME_DIR .. "src/osd",
 	MAME_DIR .. "src/lib",	
@@ -784,6 +984,12 @@ else
 	}
 end
 
+if _OPTIONS["with-zstd"] then
+	links {
+		"zstd",
+	}
+end
+
 includedirs {
 	MAME_DIR .. "src/osd",
 	MAME_DIR .. "src/lib",	
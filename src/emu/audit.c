@@ -23,10 +23,11 @@
 //  media_auditor - constructor
 //-------------------------------------------------
 
-media_auditor::media_auditor(const driver_enumerator &enumerator)
+media_auditor::media_auditor(const driver_enumerator &enumerator, hash_cache *cache)
 	: m_enumerator(enumerator),
 		m_validation(AUDIT_VALIDATE_FULL),
-		m_searchpath(NULL)
+		m_searchpath(NULL),
+		m_hash_cache(cache)
 {
 }
 
@@ -429,6 +430,7 @@ audit_record *media_auditor::audit_one_rom(const rom_entry *rom)
 	// find the file and checksum it, getting the file length along the way
 	emu_file file(m_enumerator.options().media_path(), OPEN_FLAG_READ | OPEN_FLAG_NO_PRELOAD);
 	file.set_restrict_to_mediapath(true);
+	file.set_hash_cache(m_hash_cache);
 	path_iterator path(m_searchpath);
 	std::string curpath;
 	while (path.next(curpath, record.name()))
@@ -607,3 +609,139 @@ audit_record::audit_record(const char *name, media_type type)
 		m_shared_device(NULL)
 {
 }
+
+
+//**************************************************************************
+//  PARALLEL AUDITING
+//**************************************************************************
+
+// number of drivers queued or being audited at once; bounds the machine
+// configs held in memory while keeping every worker thread busy
+const int AUDIT_QUEUE_DEPTH = 16;
+
+
+//-------------------------------------------------
+//  media_audit_queue - constructor
+//-------------------------------------------------
+
+media_audit_queue::media_audit_queue(driver_enumerator &enumerator, bool samples, hash_cache *cache)
+	: m_enumerator(enumerator),
+		m_samples(samples),
+		m_queue(osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI)),
+		m_hash_cache(cache),
+		m_current(NULL)
+{
+}
+
+
+//-------------------------------------------------
+//  ~media_audit_queue - destructor
+//-------------------------------------------------
+
+media_audit_queue::~media_audit_queue()
+{
+	// let anything still running finish before tearing it down
+	if (m_current != NULL)
+		free_result(m_current);
+	for (result *res = m_pending.detach_head(); res != NULL; res = m_pending.detach_head())
+	{
+		if (res->m_item != NULL)
+			while (!osd_work_item_wait(res->m_item, 100 * osd_ticks_per_second())) ;
+		free_result(res);
+	}
+	if (m_queue != NULL)
+		osd_work_queue_free(m_queue);
+}
+
+
+//-------------------------------------------------
+//  next - return the audit of the next driver in
+//  enumeration order, waiting for it if needed;
+//  the previous result is freed
+//-------------------------------------------------
+
+const media_audit_queue::result *media_audit_queue::next()
+{
+	if (m_current != NULL)
+	{
+		free_result(m_current);
+		m_current = NULL;
+	}
+
+	// make sure the head of the list has been queued, then wait for it
+	fill();
+	result *res = m_pending.detach_head();
+	if (res == NULL)
+		return NULL;
+	if (res->m_item != NULL)
+	{
+		while (!osd_work_item_wait(res->m_item, 100 * osd_ticks_per_second())) ;
+		osd_work_item_release(res->m_item);
+		res->m_item = NULL;
+	}
+
+	// keep the workers busy while the caller reports on this one
+	fill();
+	m_current = res;
+	return res;
+}
+
+
+//-------------------------------------------------
+//  fill - queue drivers until the queue is full
+//  or the enumerator runs out
+//-------------------------------------------------
+
+void media_audit_queue::fill()
+{
+	while (m_pending.count() < AUDIT_QUEUE_DEPTH && m_enumerator.next())
+	{
+		result &res = m_pending.append(*global_alloc(result));
+		res.m_next = NULL;
+		res.m_driver = &m_enumerator.driver();
+		res.m_samples = m_samples;
+		res.m_summary = media_auditor::NOTFOUND;
+		res.m_item = NULL;
+
+		// machine configs aren't safe to build on worker threads, so build this
+		// driver's and its parents' here; the audit compares against the parents
+		res.m_enumerator = global_alloc(driver_enumerator(m_enumerator.options(), *res.m_driver));
+		res.m_enumerator->next();
+		res.m_enumerator->config();
+		for (int drvindex = driver_list::find(res.m_driver->parent); drvindex != -1; drvindex = driver_list::find(driver_list::driver(drvindex).parent))
+			res.m_enumerator->config(drvindex);
+
+		res.m_auditor = global_alloc(media_auditor(*res.m_enumerator, m_hash_cache));
+		res.m_item = osd_work_item_queue(m_queue, audit_static, &res, 0);
+	}
+}
+
+
+//-------------------------------------------------
+//  free_result - free a result and everything
+//  it owns
+//-------------------------------------------------
+
+void media_audit_queue::free_result(result *res)
+{
+	if (res->m_item != NULL)
+		osd_work_item_release(res->m_item);
+	global_free(res->m_auditor);
+	global_free(res->m_enumerator);
+	global_free(res);
+}
+
+
+//-------------------------------------------------
+//  audit_static - worker callback that audits
+//  one driver
+//-------------------------------------------------
+
+void *media_audit_queue::audit_static(void *param, int threadid)
+{
+	result *res = reinterpret_cast<result *>(param);
+	res->m_summary = res->m_samples ? res->m_auditor->audit_samples() : res->m_auditor->audit_media(AUDIT_VALIDATE_FAST);
+	if (res->m_summary != media_auditor::NOTFOUND)
+		res->m_auditor->summarize(res->m_driver->name, &res->m_summary_string);
+	return NULL;
+}
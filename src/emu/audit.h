@@ -138,7 +138,7 @@ public:
 	};
 
 	// construction/destruction
-	media_auditor(const driver_enumerator &enumerator);
+	media_auditor(const driver_enumerator &enumerator, hash_cache *cache = NULL);
 
 	// getters
 	audit_record *first() const { return m_record_list.first(); }
@@ -163,6 +163,62 @@ private:
 	const driver_enumerator &   m_enumerator;
 	const char *                m_validation;
 	const char *                m_searchpath;
+	hash_cache *                m_hash_cache;
+};
+
+
+// ======================> media_audit_queue
+
+// audits each driver of an enumerator on worker threads, handing back the
+// results in enumeration order
+class media_audit_queue
+{
+public:
+	// the audit of one driver
+	class result
+	{
+		friend class media_audit_queue;
+		friend class simple_list<result>;
+
+	public:
+		// getters
+		result *next() const { return m_next; }
+		const game_driver &driver() const { return *m_driver; }
+		media_auditor::summary summary() const { return m_summary; }
+		const char *summary_string() const { return m_summary_string.c_str(); }
+
+	private:
+		// internal state
+		result *                    m_next;
+		const game_driver *         m_driver;           // driver being audited
+		driver_enumerator *         m_enumerator;       // enumerator holding just this driver
+		media_auditor *             m_auditor;          // auditor for this driver
+		bool                        m_samples;          // audit samples instead of ROMs?
+		media_auditor::summary      m_summary;          // result of the audit
+		std::string                 m_summary_string;   // details of anything that wasn't good
+		osd_work_item *             m_item;             // work item running the audit
+	};
+
+	// construction/destruction
+	media_audit_queue(driver_enumerator &enumerator, bool samples, hash_cache *cache = NULL);
+	~media_audit_queue();
+
+	// iteration
+	const result *next();
+
+private:
+	// internal helpers
+	void fill();
+	static void free_result(result *res);
+	static void *audit_static(void *param, int threadid);
+
+	// internal state
+	driver_enumerator &         m_enumerator;       // enumerator supplying drivers
+	bool                        m_samples;          // audit samples instead of ROMs?
+	osd_work_queue *            m_queue;            // queue the audits run on
+	hash_cache *                m_hash_cache;       // hashes shared by every audit, or NULL
+	simple_list<result>         m_pending;          // audits queued or running, in order
+	result *                    m_current;          // result last handed back by next()
 };
 
 
@@ -60,6 +60,22 @@ private:
 };
 
 
+//-------------------------------------------------
+//  report_archive_caches - show how well the
+//  ZIP and 7z caches did, for -verbose
+//-------------------------------------------------
+
+static void report_archive_caches()
+{
+	zip_cache_stats zipstats;
+	_7z_cache_stats _7zstats;
+	zip_file_cache_stats(&zipstats);
+	_7z_file_cache_stats(&_7zstats);
+	osd_printf_verbose("ZIP cache: %u hits, %u misses, %u evictions, %u searches\n", zipstats.hits, zipstats.misses, zipstats.evictions, zipstats.searches);
+	osd_printf_verbose("7z cache: %u hits, %u misses, %u evictions, %u searches\n", _7zstats.hits, _7zstats.misses, _7zstats.evictions, _7zstats.searches);
+}
+
+
 //**************************************************************************
 //  CLI FRONTEND
 //**************************************************************************
@@ -765,14 +781,23 @@ void cli_frontend::verifyroms(const char *gamename)
 	int notfound = 0;
 	int matched = 0;
 
-	// iterate over drivers
-	media_auditor auditor(drivlist);
-	while (drivlist.next())
+	// only trust remembered checksums when asked to; a file rewritten without
+	// changing its size or timestamp would otherwise still verify as good
+	auto_pointer<hash_cache> cache;
+	if (m_options.verify_hash_cache())
+	{
+		cache.reset(global_alloc(hash_cache(m_options)));
+		osd_printf_info("Using remembered checksums for unchanged files; run with -noverify_hash_cache to rehash them\n");
+	}
+
+	// iterate over drivers, auditing them in parallel but reporting in order
+	media_audit_queue queue(drivlist, false, cache);
+	for (const media_audit_queue::result *result = queue.next(); result != NULL; result = queue.next())
 	{
 		matched++;
 
 		// audit the ROMs in this set
-		media_auditor::summary summary = auditor.audit_media(AUDIT_VALIDATE_FAST);
+		media_auditor::summary summary = result->summary();
 
 		// if not found, count that and leave it at that
 		if (summary == media_auditor::NOTFOUND)
@@ -782,15 +807,13 @@ void cli_frontend::verifyroms(const char *gamename)
 		else
 		{
 			// output the summary of the audit
-			std::string summary_string;
-			auditor.summarize(drivlist.driver().name,&summary_string);
-			osd_printf_info("%s", summary_string.c_str());
+			osd_printf_info("%s", result->summary_string());
 
 			// output the name of the driver and its clone
-			osd_printf_info("romset %s ", drivlist.driver().name);
-			int clone_of = drivlist.clone();
+			osd_printf_info("romset %s ", result->driver().name);
+			int clone_of = driver_list::clone(result->driver());
 			if (clone_of != -1)
-				osd_printf_info("[%s] ", drivlist.driver(clone_of).name);
+				osd_printf_info("[%s] ", driver_list::driver(clone_of).name);
 
 			// switch off of the result
 			switch (summary)
@@ -819,6 +842,7 @@ void cli_frontend::verifyroms(const char *gamename)
 
 	if (!matched || strchr(gamename, '*') || strchr(gamename, '?'))
 	{
+		media_auditor auditor(drivlist, cache);
 		driver_enumerator dummy_drivlist(m_options);
 		int_map device_map;
 		while (dummy_drivlist.next())
@@ -946,7 +970,10 @@ void cli_frontend::verifyroms(const char *gamename)
 		}
 	}
 
-	// clear out any cached files
+	// remember any new checksums, then clear out any cached files
+	if (cache != NULL)
+		cache->save();
+	report_archive_caches();
 	zip_file_cache_clear();
 
 	// return an error if none found
@@ -987,14 +1014,23 @@ void cli_frontend::verifysamples(const char *gamename)
 	int notfound = 0;
 	int matched = 0;
 
-	// iterate over drivers
-	media_auditor auditor(drivlist);
-	while (drivlist.next())
+	// only trust remembered checksums when asked to; a file rewritten without
+	// changing its size or timestamp would otherwise still verify as good
+	auto_pointer<hash_cache> cache;
+	if (m_options.verify_hash_cache())
+	{
+		cache.reset(global_alloc(hash_cache(m_options)));
+		osd_printf_info("Using remembered checksums for unchanged files; run with -noverify_hash_cache to rehash them\n");
+	}
+
+	// iterate over drivers, auditing them in parallel but reporting in order
+	media_audit_queue queue(drivlist, true, cache);
+	for (const media_audit_queue::result *result = queue.next(); result != NULL; result = queue.next())
 	{
 		matched++;
 
 		// audit the samples in this set
-		media_auditor::summary summary = auditor.audit_samples();
+		media_auditor::summary summary = result->summary();
 
 		// if not found, count that and leave it at that
 		if (summary == media_auditor::NOTFOUND)
@@ -1004,15 +1040,13 @@ void cli_frontend::verifysamples(const char *gamename)
 		else if (summary != media_auditor::NONE_NEEDED)
 		{
 			// output the summary of the audit
-			std::string summary_string;
-			auditor.summarize(drivlist.driver().name,&summary_string);
-			osd_printf_info("%s", summary_string.c_str());
+			osd_printf_info("%s", result->summary_string());
 
 			// output the name of the driver and its clone
-			osd_printf_info("sampleset %s ", drivlist.driver().name);
-			int clone_of = drivlist.clone();
+			osd_printf_info("sampleset %s ", result->driver().name);
+			int clone_of = driver_list::clone(result->driver());
 			if (clone_of != -1)
-				osd_printf_info("[%s] ", drivlist.driver(clone_of).name);
+				osd_printf_info("[%s] ", driver_list::driver(clone_of).name);
 
 			// switch off of the result
 			switch (summary)
@@ -1038,7 +1072,10 @@ void cli_frontend::verifysamples(const char *gamename)
 		}
 	}
 
-	// clear out any cached files
+	// remember any new checksums, then clear out any cached files
+	if (cache != NULL)
+		cache->save();
+	report_archive_caches();
 	zip_file_cache_clear();
 
 	// return an error if none found
@@ -1356,6 +1393,7 @@ void cli_frontend::verifysoftware(const char *gamename)
 	}
 
 	// clear out any cached files
+	report_archive_caches();
 	zip_file_cache_clear();
 
 	// return an error if none found
@@ -1478,6 +1516,7 @@ void cli_frontend::verifysoftlist(const char *gamename)
 	}
 
 	// clear out any cached files
+	report_archive_caches();
 	zip_file_cache_clear();
 
 	// return an error if none found
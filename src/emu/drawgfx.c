@@ -20,6 +20,9 @@ UINT8 no_priority_size_is_wrong[2 * (sizeof(NO_PRIORITY) == 3) - 1];
 
 bitmap_ind8 drawgfx_dummy_priority_bitmap;
 
+// span helpers used by the SPAN_OP* macros
+const drawgfx_span_funcs *g_drawgfx_span = &drawgfx_span_select(true);
+
 
 
 /***************************************************************************
@@ -235,6 +238,12 @@ void gfx_element::set_layout(const gfx_layout &gl, const UINT8 *srcdata)
 		m_pen_usage.resize(m_total_elements);
 	else
 		m_pen_usage.clear();
+
+	// allocate opacity summaries for decoded graphics; RAW data can change behind our back
+	if (!m_layout_is_raw)
+		m_opacity.resize(m_total_elements * (m_origheight + 1));
+	else
+		m_opacity.clear();
 }
 
 
@@ -292,9 +301,10 @@ void gfx_element::set_source_and_total(const UINT8 *source, UINT32 total)
 	}
 	else
 	{
-		// allocate memory for the data
+		// allocate memory for the data and its opacity summaries
 		m_gfxdata_allocated.resize(m_total_elements * m_char_modulo);
 		m_gfxdata = &m_gfxdata_allocated[0];
+		m_opacity.resize(m_total_elements * (m_origheight + 1));
 	}
 }
 
@@ -369,6 +379,34 @@ void gfx_element::decode(UINT32 code)
 		m_pen_usage[code] = usage;
 	}
 
+	// (re)compute the opacity summaries; see summary_opacity() for the format
+	if (has_opacity())
+	{
+		const UINT8 *dp = m_gfxdata + code * m_char_modulo;
+		UINT16 *summary = &m_opacity[code * (m_origheight + 1)];
+		UINT32 tileusage = 0, tilemin = 0xff, tilemax = 0;
+		for (int y = 0; y < m_origheight; y++)
+		{
+			UINT32 usage = 0, minpen = 0xff, maxpen = 0;
+			if (m_color_depth <= 16)
+				for (int x = 0; x < m_origwidth; x++)
+					usage |= 1 << dp[x];
+			else
+				for (int x = 0; x < m_origwidth; x++)
+				{
+					minpen = MIN(minpen, dp[x]);
+					maxpen = MAX(maxpen, dp[x]);
+				}
+			dp += m_line_modulo;
+
+			summary[1 + y] = (m_color_depth <= 16) ? usage : (minpen | (maxpen << 8));
+			tileusage |= usage;
+			tilemin = MIN(tilemin, minpen);
+			tilemax = MAX(tilemax, maxpen);
+		}
+		summary[0] = (m_color_depth <= 16) ? tileusage : (tilemin | (tilemax << 8));
+	}
+
 	// no longer dirty
 	m_dirty[code] = 0;
 }
@@ -416,24 +454,22 @@ void gfx_element::transpen(bitmap_ind16 &dest, const rectangle &cliprect,
 	if (trans_pen > 0xff)
 		return opaque(dest, cliprect, code, color, flipx, flipy, destx, desty);
 
-	// use pen usage to optimize
+	// use the opacity summaries to optimize
 	code %= elements();
-	if (has_pen_usage())
-	{
-		// fully transparent; do nothing
-		UINT32 usage = pen_usage(code);
-		if ((usage & ~(1 << trans_pen)) == 0)
-			return;
+	int tileopacity = opacity(code, trans_pen);
 
-		// fully opaque; draw as such
-		if ((usage & (1 << trans_pen)) == 0)
-			return opaque(dest, cliprect, code, color, flipx, flipy, destx, desty);
-	}
+	// fully transparent; do nothing
+	if (tileopacity == GFX_OPACITY_TRANSPARENT)
+		return;
+
+	// fully opaque; draw as such
+	if (tileopacity == GFX_OPACITY_OPAQUE)
+		return opaque(dest, cliprect, code, color, flipx, flipy, destx, desty);
 
 	// render
 	color = colorbase() + granularity() * (color % colors());
 	DECLARE_NO_PRIORITY;
-	DRAWGFX_CORE(UINT16, PIXEL_OP_REBASE_TRANSPEN, NO_PRIORITY);
+	DRAWGFX_SPAN_CORE(UINT16, SPAN_OP_REBASE_TRANSPEN, SPAN_OP_REBASE_OPAQUE, NO_PRIORITY);
 }
 
 void gfx_element::transpen(bitmap_rgb32 &dest, const rectangle &cliprect,
@@ -444,24 +480,22 @@ void gfx_element::transpen(bitmap_rgb32 &dest, const rectangle &cliprect,
 	if (trans_pen > 0xff)
 		return opaque(dest, cliprect, code, color, flipx, flipy, destx, desty);
 
-	// use pen usage to optimize
+	// use the opacity summaries to optimize
 	code %= elements();
-	if (has_pen_usage())
-	{
-		// fully transparent; do nothing
-		UINT32 usage = pen_usage(code);
-		if ((usage & ~(1 << trans_pen)) == 0)
-			return;
+	int tileopacity = opacity(code, trans_pen);
 
-		// fully opaque; draw as such
-		if ((usage & (1 << trans_pen)) == 0)
-			return opaque(dest, cliprect, code, color, flipx, flipy, destx, desty);
-	}
+	// fully transparent; do nothing
+	if (tileopacity == GFX_OPACITY_TRANSPARENT)
+		return;
+
+	// fully opaque; draw as such
+	if (tileopacity == GFX_OPACITY_OPAQUE)
+		return opaque(dest, cliprect, code, color, flipx, flipy, destx, desty);
 
 	// render
 	const pen_t *paldata = m_palette->pens() + colorbase() + granularity() * (color % colors());
 	DECLARE_NO_PRIORITY;
-	DRAWGFX_CORE(UINT32, PIXEL_OP_REMAP_TRANSPEN, NO_PRIORITY);
+	DRAWGFX_SPAN_CORE(UINT32, SPAN_OP_REMAP_TRANSPEN, SPAN_OP_REMAP_OPAQUE, NO_PRIORITY);
 }
 
 
@@ -682,24 +716,22 @@ void gfx_element::zoom_transpen(bitmap_ind16 &dest, const rectangle &cliprect,
 	if (trans_pen > 0xff)
 		return zoom_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, scalex, scaley);
 
-	// use pen usage to optimize
+	// use the opacity summaries to optimize
 	code %= elements();
-	if (has_pen_usage())
-	{
-		// fully transparent; do nothing
-		UINT32 usage = pen_usage(code);
-		if ((usage & ~(1 << trans_pen)) == 0)
-			return;
+	int tileopacity = opacity(code, trans_pen);
 
-		// fully opaque; draw as such
-		if ((usage & (1 << trans_pen)) == 0)
-			return zoom_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, scalex, scaley);
-	}
+	// fully transparent; do nothing
+	if (tileopacity == GFX_OPACITY_TRANSPARENT)
+		return;
+
+	// fully opaque; draw as such
+	if (tileopacity == GFX_OPACITY_OPAQUE)
+		return zoom_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, scalex, scaley);
 
 	// render
 	color = colorbase() + granularity() * (color % colors());
 	DECLARE_NO_PRIORITY;
-	DRAWGFXZOOM_CORE(UINT16, PIXEL_OP_REBASE_TRANSPEN, NO_PRIORITY);
+	DRAWGFXZOOM_SPAN_CORE(UINT16, SPAN_OP_REBASE_TRANSPEN, SPAN_OP_REBASE_OPAQUE, NO_PRIORITY);
 }
 
 void gfx_element::zoom_transpen(bitmap_rgb32 &dest, const rectangle &cliprect,
@@ -714,24 +746,22 @@ void gfx_element::zoom_transpen(bitmap_rgb32 &dest, const rectangle &cliprect,
 	if (trans_pen > 0xff)
 		return zoom_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, scalex, scaley);
 
-	// use pen usage to optimize
+	// use the opacity summaries to optimize
 	code %= elements();
-	if (has_pen_usage())
-	{
-		// fully transparent; do nothing
-		UINT32 usage = pen_usage(code);
-		if ((usage & ~(1 << trans_pen)) == 0)
-			return;
+	int tileopacity = opacity(code, trans_pen);
 
-		// fully opaque; draw as such
-		if ((usage & (1 << trans_pen)) == 0)
-			return zoom_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, scalex, scaley);
-	}
+	// fully transparent; do nothing
+	if (tileopacity == GFX_OPACITY_TRANSPARENT)
+		return;
+
+	// fully opaque; draw as such
+	if (tileopacity == GFX_OPACITY_OPAQUE)
+		return zoom_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, scalex, scaley);
 
 	// render
 	const pen_t *paldata = m_palette->pens() + colorbase() + granularity() * (color % colors());
 	DECLARE_NO_PRIORITY;
-	DRAWGFXZOOM_CORE(UINT32, PIXEL_OP_REMAP_TRANSPEN, NO_PRIORITY);
+	DRAWGFXZOOM_SPAN_CORE(UINT32, SPAN_OP_REMAP_TRANSPEN, SPAN_OP_REMAP_OPAQUE, NO_PRIORITY);
 }
 
 
@@ -974,26 +1004,24 @@ void gfx_element::prio_transpen(bitmap_ind16 &dest, const rectangle &cliprect,
 	if (trans_pen > 0xff)
 		return prio_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, priority, pmask);
 
-	// use pen usage to optimize
+	// use the opacity summaries to optimize
 	code %= elements();
-	if (has_pen_usage())
-	{
-		// fully transparent; do nothing
-		UINT32 usage = pen_usage(code);
-		if ((usage & ~(1 << trans_pen)) == 0)
-			return;
+	int tileopacity = opacity(code, trans_pen);
 
-		// fully opaque; draw as such
-		if ((usage & (1 << trans_pen)) == 0)
-			return prio_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, priority, pmask);
-	}
+	// fully transparent; do nothing
+	if (tileopacity == GFX_OPACITY_TRANSPARENT)
+		return;
+
+	// fully opaque; draw as such
+	if (tileopacity == GFX_OPACITY_OPAQUE)
+		return prio_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, priority, pmask);
 
 	// high bit of the mask is implicitly on
 	pmask |= 1 << 31;
 
 	// render
 	color = colorbase() + granularity() * (color % colors());
-	DRAWGFX_CORE(UINT16, PIXEL_OP_REBASE_TRANSPEN_PRIORITY, UINT8);
+	DRAWGFX_SPAN_CORE(UINT16, SPAN_OP_REBASE_TRANSPEN_PRIORITY, SPAN_OP_REBASE_OPAQUE_PRIORITY, UINT8);
 }
 
 void gfx_element::prio_transpen(bitmap_rgb32 &dest, const rectangle &cliprect,
@@ -1004,26 +1032,24 @@ void gfx_element::prio_transpen(bitmap_rgb32 &dest, const rectangle &cliprect,
 	if (trans_pen > 0xff)
 		return prio_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, priority, pmask);
 
-	// use pen usage to optimize
+	// use the opacity summaries to optimize
 	code %= elements();
-	if (has_pen_usage())
-	{
-		// fully transparent; do nothing
-		UINT32 usage = pen_usage(code);
-		if ((usage & ~(1 << trans_pen)) == 0)
-			return;
+	int tileopacity = opacity(code, trans_pen);
 
-		// fully opaque; draw as such
-		if ((usage & (1 << trans_pen)) == 0)
-			return prio_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, priority, pmask);
-	}
+	// fully transparent; do nothing
+	if (tileopacity == GFX_OPACITY_TRANSPARENT)
+		return;
+
+	// fully opaque; draw as such
+	if (tileopacity == GFX_OPACITY_OPAQUE)
+		return prio_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, priority, pmask);
 
 	// high bit of the mask is implicitly on
 	pmask |= 1 << 31;
 
 	// render
 	const pen_t *paldata = m_palette->pens() + colorbase() + granularity() * (color % colors());
-	DRAWGFX_CORE(UINT32, PIXEL_OP_REMAP_TRANSPEN_PRIORITY, UINT8);
+	DRAWGFX_SPAN_CORE(UINT32, SPAN_OP_REMAP_TRANSPEN_PRIORITY, SPAN_OP_REMAP_OPAQUE_PRIORITY, UINT8);
 }
 
 
@@ -1267,26 +1293,24 @@ void gfx_element::prio_zoom_transpen(bitmap_ind16 &dest, const rectangle &clipre
 	if (trans_pen > 0xff)
 		return prio_zoom_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, scalex, scaley, priority, pmask);
 
-	// use pen usage to optimize
+	// use the opacity summaries to optimize
 	code %= elements();
-	if (has_pen_usage())
-	{
-		// fully transparent; do nothing
-		UINT32 usage = pen_usage(code);
-		if ((usage & ~(1 << trans_pen)) == 0)
-			return;
+	int tileopacity = opacity(code, trans_pen);
 
-		// fully opaque; draw as such
-		if ((usage & (1 << trans_pen)) == 0)
-			return prio_zoom_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, scalex, scaley, priority, pmask);
-	}
+	// fully transparent; do nothing
+	if (tileopacity == GFX_OPACITY_TRANSPARENT)
+		return;
+
+	// fully opaque; draw as such
+	if (tileopacity == GFX_OPACITY_OPAQUE)
+		return prio_zoom_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, scalex, scaley, priority, pmask);
 
 	// high bit of the mask is implicitly on
 	pmask |= 1 << 31;
 
 	// render
 	color = colorbase() + granularity() * (color % colors());
-	DRAWGFXZOOM_CORE(UINT16, PIXEL_OP_REBASE_TRANSPEN_PRIORITY, UINT8);
+	DRAWGFXZOOM_SPAN_CORE(UINT16, SPAN_OP_REBASE_TRANSPEN_PRIORITY, SPAN_OP_REBASE_OPAQUE_PRIORITY, UINT8);
 }
 
 void gfx_element::prio_zoom_transpen(bitmap_rgb32 &dest, const rectangle &cliprect,
@@ -1302,26 +1326,24 @@ void gfx_element::prio_zoom_transpen(bitmap_rgb32 &dest, const rectangle &clipre
 	if (trans_pen > 0xff)
 		return prio_zoom_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, scalex, scaley, priority, pmask);
 
-	// use pen usage to optimize
+	// use the opacity summaries to optimize
 	code %= elements();
-	if (has_pen_usage())
-	{
-		// fully transparent; do nothing
-		UINT32 usage = pen_usage(code);
-		if ((usage & ~(1 << trans_pen)) == 0)
-			return;
+	int tileopacity = opacity(code, trans_pen);
 
-		// fully opaque; draw as such
-		if ((usage & (1 << trans_pen)) == 0)
-			return prio_zoom_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, scalex, scaley, priority, pmask);
-	}
+	// fully transparent; do nothing
+	if (tileopacity == GFX_OPACITY_TRANSPARENT)
+		return;
+
+	// fully opaque; draw as such
+	if (tileopacity == GFX_OPACITY_OPAQUE)
+		return prio_zoom_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, scalex, scaley, priority, pmask);
 
 	// high bit of the mask is implicitly on
 	pmask |= 1 << 31;
 
 	// render
 	const pen_t *paldata = m_palette->pens() + colorbase() + granularity() * (color % colors());
-	DRAWGFXZOOM_CORE(UINT32, PIXEL_OP_REMAP_TRANSPEN_PRIORITY, UINT8);
+	DRAWGFXZOOM_SPAN_CORE(UINT32, SPAN_OP_REMAP_TRANSPEN_PRIORITY, SPAN_OP_REMAP_OPAQUE_PRIORITY, UINT8);
 }
 
 
@@ -1745,6 +1767,24 @@ void gfx_element::alphatable(bitmap_rgb32 &dest, const rectangle &cliprect,
 }
 
 
+/***************************************************************************
+    BLITTER SELECTION
+***************************************************************************/
+
+/*-------------------------------------------------
+    drawgfx_set_simd - select whether the SIMD
+    span helpers are used for the transpen
+    blitters; falls back to the generic helpers
+    if none are available
+-------------------------------------------------*/
+
+void drawgfx_set_simd(bool enable)
+{
+	g_drawgfx_span = &drawgfx_span_select(enable);
+}
+
+
+
 /***************************************************************************
     DRAW_SCANLINE IMPLEMENTATIONS
 ***************************************************************************/
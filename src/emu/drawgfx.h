@@ -139,6 +139,14 @@ enum
 	GFX_PMASK_8  = 0xff00
 };
 
+// opacity of a gfx element or one of its rows, relative to a transparent pen
+enum
+{
+	GFX_OPACITY_TRANSPARENT,
+	GFX_OPACITY_MIXED,
+	GFX_OPACITY_OPAQUE
+};
+
 
 /***************************************************************************
     TYPE DEFINITIONS
@@ -163,6 +171,7 @@ public:
 	UINT32 colors() const { return m_total_colors; }
 	UINT32 rowbytes() const { return m_line_modulo; }
 	bool has_pen_usage() const { return !m_pen_usage.empty(); }
+	bool has_opacity() const { return !m_opacity.empty(); }
 
 	// used by tilemaps
 	UINT32 dirtyseq() const { return m_dirtyseq; }
@@ -197,6 +206,41 @@ public:
 		return m_pen_usage[code];
 	}
 
+	int opacity(UINT32 code, UINT32 trans_pen)
+	{
+		assert(code < elements());
+		if (code < m_dirty.size() && m_dirty[code]) decode(code);
+		if (has_pen_usage())
+			return usage_opacity(m_pen_usage[code], trans_pen);
+		if (has_opacity())
+			return summary_opacity(m_opacity[code * (m_origheight + 1)], trans_pen);
+		return GFX_OPACITY_MIXED;
+	}
+
+	// per-row opacity summaries for the clipped element, indexed like get_data() rows; NULL if not tracked
+	const UINT16 *row_opacity(UINT32 code)
+	{
+		assert(code < elements());
+		if (!has_opacity()) return NULL;
+		if (m_dirty[code]) decode(code);
+		return &m_opacity[code * (m_origheight + 1) + 1 + m_starty];
+	}
+
+	int summary_opacity(UINT16 summary, UINT32 trans_pen) const
+	{
+		// up to 16 pens, summaries are a bitmask of the pens used
+		if (m_color_depth <= 16)
+			return usage_opacity(summary, trans_pen);
+
+		// beyond that, they hold the lowest pen used in the low byte and the highest in the high byte
+		UINT32 minpen = summary & 0xff, maxpen = summary >> 8;
+		if (minpen == trans_pen && maxpen == trans_pen)
+			return GFX_OPACITY_TRANSPARENT;
+		if (trans_pen < minpen || trans_pen > maxpen)
+			return GFX_OPACITY_OPAQUE;
+		return GFX_OPACITY_MIXED;
+	}
+
 	// ----- core graphics drawing -----
 
 	// specific drawgfx implementations for each transparency type
@@ -266,6 +310,16 @@ private:
 	// internal helpers
 	void decode(UINT32 code);
 
+	static int usage_opacity(UINT32 usage, UINT32 trans_pen)
+	{
+		UINT32 transbit = (trans_pen < 32) ? (1 << trans_pen) : 0;
+		if ((usage & ~transbit) == 0)
+			return GFX_OPACITY_TRANSPARENT;
+		if ((usage & transbit) == 0)
+			return GFX_OPACITY_OPAQUE;
+		return GFX_OPACITY_MIXED;
+	}
+
 	// internal state
 	palette_device  *m_palette;             // palette used for drawing
 
@@ -292,6 +346,7 @@ private:
 	dynamic_buffer  m_gfxdata_allocated;    // allocated decoded pixel data, 8bpp
 	dynamic_buffer  m_dirty;                // dirty array for detecting chars that need decoding
 	std::vector<UINT32>  m_pen_usage;      // bitmask of pens that are used (pens 0-31 only)
+	std::vector<UINT16>  m_opacity;        // per-element and per-row opacity summaries (decoded layouts only)
 
 	bool            m_layout_is_raw;        // raw layout?
 	UINT8           m_layout_planes;        // bit planes in the layout
@@ -307,6 +362,12 @@ private:
     FUNCTION PROTOTYPES
 ***************************************************************************/
 
+// ----- blitter selection -----
+
+// select SIMD span blitters for the common transparent cases, if available
+void drawgfx_set_simd(bool enable);
+
+
 // ----- scanline copying -----
 
 // copy pixels from an 8bpp buffer to a single scanline of a bitmap
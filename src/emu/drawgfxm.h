@@ -51,6 +51,7 @@
 #define __DRAWGFXM_H__
 
 #include "profiler.h"
+#include "drawgfxv.h"
 
 
 /* special priority type meaning "none" */
@@ -60,6 +61,17 @@ extern bitmap_ind8 drawgfx_dummy_priority_bitmap;
 #define DECLARE_NO_PRIORITY bitmap_t &priority = drawgfx_dummy_priority_bitmap;
 
 
+/* currently selected span helpers; see drawgfx_set_simd() */
+extern const drawgfx_span_funcs *g_drawgfx_span;
+
+/* call a span helper, inlining the generic one for short spans */
+#define DRAWGFX_SPAN_CALL(FUNC, COUNT, ARGS)                                            \
+	(((COUNT) < DRAWGFX_SPAN_SIMD_MIN) ? drawgfx_span_##FUNC##_c ARGS : (*g_drawgfx_span->FUNC) ARGS)
+
+/* maximum number of pixels staged at once by the span cores */
+#define DRAWGFX_SPAN_CHUNK      256
+
+
 /* macros for using the optional priority */
 #define PRIORITY_VALID(x)       (sizeof(x) != sizeof(NO_PRIORITY))
 #define PRIORITY_ADDR(p,t,y,x)  (PRIORITY_VALID(t) ? (&(p).pixt<t>(y, x)) : NULL)
@@ -366,6 +378,62 @@ do
 while (0)
 
 
+/***************************************************************************
+    SPAN OPERATIONS
+***************************************************************************/
+
+/*
+    The SPAN_OP* macros are the run-based equivalents of the PIXEL_OP*
+    macros, used with the DRAWGFX_SPAN_CORE and DRAWGFXZOOM_SPAN_CORE
+    macros below. Each renders COUNT contiguous SOURCE pixels to DEST,
+    updating PRIORITY as appropriate, via the g_drawgfx_span helpers
+    (or the generic ones for spans shorter than DRAWGFX_SPAN_SIMD_MIN).
+*/
+
+/*-------------------------------------------------
+    SPAN_OP_REMAP_OPAQUE - span version of
+    PIXEL_OP_REMAP_OPAQUE; the priority variant
+    is only used on runs with no transparent
+    pixels, so it can share the transpen helper
+-------------------------------------------------*/
+
+#define SPAN_OP_REMAP_OPAQUE(DEST, PRIORITY, SOURCE, COUNT)                         \
+	DRAWGFX_SPAN_CALL(opaque32, COUNT, ((DEST), (SOURCE), (COUNT), paldata))
+#define SPAN_OP_REMAP_OPAQUE_PRIORITY(DEST, PRIORITY, SOURCE, COUNT)                \
+	SPAN_OP_REMAP_TRANSPEN_PRIORITY(DEST, PRIORITY, SOURCE, COUNT)
+
+/*-------------------------------------------------
+    SPAN_OP_REBASE_OPAQUE - span version of
+    PIXEL_OP_REBASE_OPAQUE; see above for the
+    priority variant
+-------------------------------------------------*/
+
+#define SPAN_OP_REBASE_OPAQUE(DEST, PRIORITY, SOURCE, COUNT)                        \
+	DRAWGFX_SPAN_CALL(opaque16, COUNT, ((DEST), (SOURCE), (COUNT), color))
+#define SPAN_OP_REBASE_OPAQUE_PRIORITY(DEST, PRIORITY, SOURCE, COUNT)               \
+	SPAN_OP_REBASE_TRANSPEN_PRIORITY(DEST, PRIORITY, SOURCE, COUNT)
+
+/*-------------------------------------------------
+    SPAN_OP_REMAP_TRANSPEN - span version of
+    PIXEL_OP_REMAP_TRANSPEN
+-------------------------------------------------*/
+
+#define SPAN_OP_REMAP_TRANSPEN(DEST, PRIORITY, SOURCE, COUNT)                       \
+	DRAWGFX_SPAN_CALL(transpen32, COUNT, ((DEST), (SOURCE), (COUNT), paldata, trans_pen))
+#define SPAN_OP_REMAP_TRANSPEN_PRIORITY(DEST, PRIORITY, SOURCE, COUNT)              \
+	DRAWGFX_SPAN_CALL(transpen32_prio, COUNT, ((DEST), (PRIORITY), (SOURCE), (COUNT), paldata, trans_pen, pmask))
+
+/*-------------------------------------------------
+    SPAN_OP_REBASE_TRANSPEN - span version of
+    PIXEL_OP_REBASE_TRANSPEN
+-------------------------------------------------*/
+
+#define SPAN_OP_REBASE_TRANSPEN(DEST, PRIORITY, SOURCE, COUNT)                      \
+	DRAWGFX_SPAN_CALL(transpen16, COUNT, ((DEST), (SOURCE), (COUNT), color, trans_pen))
+#define SPAN_OP_REBASE_TRANSPEN_PRIORITY(DEST, PRIORITY, SOURCE, COUNT)             \
+	DRAWGFX_SPAN_CALL(transpen16_prio, COUNT, ((DEST), (PRIORITY), (SOURCE), (COUNT), color, trans_pen, pmask))
+
+
 /***************************************************************************
     BASIC DRAWGFX CORE
 ***************************************************************************/
@@ -684,6 +752,260 @@ do {
 } while (0)
 
 
+/***************************************************************************
+    SPAN-BASED DRAWGFX CORES
+***************************************************************************/
+
+/*
+    These take the same inputs as DRAWGFX_CORE and DRAWGFXZOOM_CORE,
+    but hand whole runs of source pixels to a SPAN_OP* macro instead
+    of rendering a pixel at a time. Flipped and scaled rows are first
+    staged into a local buffer so that the span helpers only ever see
+    contiguous, left-to-right source data.
+
+    They additionally assume a UINT32 trans_pen, which is checked
+    against the element's row opacity summaries: rows with nothing
+    but trans_pen are skipped outright, and rows without any are
+    handed to OPAQUE_SPAN_OP instead of SPAN_OP.
+*/
+
+#define DRAWGFX_SPAN_CORE(PIXEL_TYPE, SPAN_OP, OPAQUE_SPAN_OP, PRIORITY_TYPE)           \
+do {                                                                                    \
+	g_profiler.start(PROFILER_DRAWGFX);                                                 \
+	do {                                                                                \
+		const UINT8 *srcdata;                                                           \
+		INT32 destendx, destendy;                                                       \
+		INT32 srcx, srcy;                                                               \
+		INT32 curx, cury;                                                               \
+		INT32 dy, dyrow;                                                                \
+		UINT8 spanbuf[DRAWGFX_SPAN_CHUNK];                                              \
+																						\
+		assert(dest.valid());                                                           \
+		assert(!PRIORITY_VALID(PRIORITY_TYPE) || priority.valid());                     \
+		assert(dest.cliprect().contains(cliprect));                                     \
+		assert(code < elements());                                                      \
+																						\
+		/* ignore empty/invalid cliprects */                                            \
+		if (cliprect.empty())                                                           \
+			break;                                                                      \
+																						\
+		/* compute final pixel in X and exit if we are entirely clipped */              \
+		destendx = destx + width() - 1;                                                 \
+		if (destx > cliprect.max_x || destendx < cliprect.min_x)                        \
+			break;                                                                      \
+																						\
+		/* apply left clip */                                                           \
+		srcx = 0;                                                                       \
+		if (destx < cliprect.min_x)                                                     \
+		{                                                                               \
+			srcx = cliprect.min_x - destx;                                              \
+			destx = cliprect.min_x;                                                     \
+		}                                                                               \
+																						\
+		/* apply right clip */                                                          \
+		if (destendx > cliprect.max_x)                                                  \
+			destendx = cliprect.max_x;                                                  \
+																						\
+		/* compute final pixel in Y and exit if we are entirely clipped */              \
+		destendy = desty + height() - 1;                                                \
+		if (desty > cliprect.max_y || destendy < cliprect.min_y)                        \
+			break;                                                                      \
+																						\
+		/* apply top clip */                                                            \
+		srcy = 0;                                                                       \
+		if (desty < cliprect.min_y)                                                     \
+		{                                                                               \
+			srcy = cliprect.min_y - desty;                                              \
+			desty = cliprect.min_y;                                                     \
+		}                                                                               \
+																						\
+		/* apply bottom clip */                                                         \
+		if (destendy > cliprect.max_y)                                                  \
+			destendy = cliprect.max_y;                                                  \
+																						\
+		/* apply X flipping */                                                          \
+		if (flipx)                                                                      \
+			srcx = width() - 1 - srcx;                                                  \
+																						\
+		/* apply Y flipping */                                                          \
+		dy = rowbytes();                                                                \
+		dyrow = 1;                                                                      \
+		if (flipy)                                                                      \
+		{                                                                               \
+			srcy = height() - 1 - srcy;                                                 \
+			dy = -dy;                                                                   \
+			dyrow = -1;                                                                 \
+		}                                                                               \
+																						\
+		/* fetch the source data */                                                     \
+		srcdata = get_data(code);                                                       \
+		srcdata += srcy * rowbytes() + srcx;                                            \
+		const UINT16 *rowopacity = row_opacity(code);                                   \
+		INT32 count = destendx + 1 - destx;                                             \
+																						\
+		/* iterate over pixels in Y */                                                  \
+		for (cury = desty; cury <= destendy; cury++)                                    \
+		{                                                                               \
+			PRIORITY_TYPE *priptr = PRIORITY_ADDR(priority, PRIORITY_TYPE, cury, destx); \
+			PIXEL_TYPE *destptr = &dest.pixt<PIXEL_TYPE>(cury, destx);                  \
+			const UINT8 *srcptr = srcdata;                                              \
+			int curopacity = (rowopacity != NULL) ? summary_opacity(rowopacity[srcy], trans_pen) : GFX_OPACITY_MIXED; \
+			srcdata += dy;                                                              \
+			srcy += dyrow;                                                              \
+																						\
+			/* skip rows with nothing to draw */                                        \
+			if (curopacity == GFX_OPACITY_TRANSPARENT)                                  \
+				continue;                                                               \
+																						\
+			/* non-flipped rows are already contiguous */                               \
+			if (!flipx)                                                                 \
+			{                                                                           \
+				if (curopacity == GFX_OPACITY_OPAQUE)                                   \
+					OPAQUE_SPAN_OP(destptr, priptr, srcptr, count);                     \
+				else                                                                    \
+					SPAN_OP(destptr, priptr, srcptr, count);                            \
+			}                                                                           \
+																						\
+			/* flipped rows are reversed into the staging buffer */                     \
+			else                                                                        \
+				for (INT32 left = count; left > 0; )                                    \
+				{                                                                       \
+					INT32 chunk = MIN(left, DRAWGFX_SPAN_CHUNK);                        \
+					for (curx = 0; curx < chunk; curx++)                                \
+						spanbuf[curx] = *srcptr--;                                      \
+					if (curopacity == GFX_OPACITY_OPAQUE)                               \
+						OPAQUE_SPAN_OP(destptr, priptr, spanbuf, chunk);                \
+					else                                                                \
+						SPAN_OP(destptr, priptr, spanbuf, chunk);                       \
+					destptr += chunk;                                                   \
+					PRIORITY_ADVANCE(PRIORITY_TYPE, priptr, chunk);                     \
+					left -= chunk;                                                      \
+				}                                                                       \
+		}                                                                               \
+	} while (0);                                                                        \
+	g_profiler.stop();                                                                  \
+} while (0)
+
+
+#define DRAWGFXZOOM_SPAN_CORE(PIXEL_TYPE, SPAN_OP, OPAQUE_SPAN_OP, PRIORITY_TYPE)       \
+do {                                                                                    \
+	g_profiler.start(PROFILER_DRAWGFX);                                                 \
+	do {                                                                                \
+		const UINT8 *srcdata;                                                           \
+		UINT32 dstwidth, dstheight;                                                     \
+		INT32 destendx, destendy;                                                       \
+		INT32 srcx, srcy;                                                               \
+		INT32 curx, cury;                                                               \
+		INT32 dx, dy;                                                                   \
+		UINT8 spanbuf[DRAWGFX_SPAN_CHUNK];                                              \
+																						\
+		assert(dest.valid());                                                           \
+		assert(!PRIORITY_VALID(PRIORITY_TYPE) || priority.valid());                     \
+		assert(dest.cliprect().contains(cliprect));                                     \
+																						\
+		/* ignore empty/invalid cliprects */                                            \
+		if (cliprect.empty())                                                           \
+			break;                                                                      \
+																						\
+		/* compute scaled size */                                                       \
+		dstwidth = (scalex * width() + 0x8000) >> 16;                                   \
+		dstheight = (scaley * height() + 0x8000) >> 16;                                 \
+		if (dstwidth < 1 || dstheight < 1)                                              \
+			break;                                                                      \
+																						\
+		/* compute 16.16 source steps in dx and dy */                                   \
+		dx = (width() << 16) / dstwidth;                                                \
+		dy = (height() << 16) / dstheight;                                              \
+																						\
+		/* compute final pixel in X and exit if we are entirely clipped */              \
+		destendx = destx + dstwidth - 1;                                                \
+		if (destx > cliprect.max_x || destendx < cliprect.min_x)                        \
+			break;                                                                      \
+																						\
+		/* apply left clip */                                                           \
+		srcx = 0;                                                                       \
+		if (destx < cliprect.min_x)                                                     \
+		{                                                                               \
+			srcx = (cliprect.min_x - destx) * dx;                                       \
+			destx = cliprect.min_x;                                                     \
+		}                                                                               \
+																						\
+		/* apply right clip */                                                          \
+		if (destendx > cliprect.max_x)                                                  \
+			destendx = cliprect.max_x;                                                  \
+																						\
+		/* compute final pixel in Y and exit if we are entirely clipped */              \
+		destendy = desty + dstheight - 1;                                               \
+		if (desty > cliprect.max_y || destendy < cliprect.min_y)                        \
+			break;                                                                      \
+																						\
+		/* apply top clip */                                                            \
+		srcy = 0;                                                                       \
+		if (desty < cliprect.min_y)                                                     \
+		{                                                                               \
+			srcy = (cliprect.min_y - desty) * dy;                                       \
+			desty = cliprect.min_y;                                                     \
+		}                                                                               \
+																						\
+		/* apply bottom clip */                                                         \
+		if (destendy > cliprect.max_y)                                                  \
+			destendy = cliprect.max_y;                                                  \
+																						\
+		/* apply X flipping */                                                          \
+		if (flipx)                                                                      \
+		{                                                                               \
+			srcx = (dstwidth - 1) * dx - srcx;                                          \
+			dx = -dx;                                                                   \
+		}                                                                               \
+																						\
+		/* apply Y flipping */                                                          \
+		if (flipy)                                                                      \
+		{                                                                               \
+			srcy = (dstheight - 1) * dy - srcy;                                         \
+			dy = -dy;                                                                   \
+		}                                                                               \
+																						\
+		/* fetch the source data */                                                     \
+		srcdata = get_data(code);                                                       \
+		const UINT16 *rowopacity = row_opacity(code);                                   \
+		INT32 count = destendx + 1 - destx;                                             \
+																						\
+		/* iterate over pixels in Y */                                                  \
+		for (cury = desty; cury <= destendy; cury++)                                    \
+		{                                                                               \
+			PRIORITY_TYPE *priptr = PRIORITY_ADDR(priority, PRIORITY_TYPE, cury, destx); \
+			PIXEL_TYPE *destptr = &dest.pixt<PIXEL_TYPE>(cury, destx);                  \
+			const UINT8 *srcptr = srcdata + (srcy >> 16) * rowbytes();                  \
+			int curopacity = (rowopacity != NULL) ? summary_opacity(rowopacity[srcy >> 16], trans_pen) : GFX_OPACITY_MIXED; \
+			INT32 cursrcx = srcx;                                                       \
+			srcy += dy;                                                                 \
+																						\
+			/* skip rows with nothing to draw */                                        \
+			if (curopacity == GFX_OPACITY_TRANSPARENT)                                  \
+				continue;                                                               \
+																						\
+			/* resample the row into the staging buffer a chunk at a time */            \
+			for (INT32 left = count; left > 0; )                                        \
+			{                                                                           \
+				INT32 chunk = MIN(left, DRAWGFX_SPAN_CHUNK);                            \
+				for (curx = 0; curx < chunk; curx++)                                    \
+				{                                                                       \
+					spanbuf[curx] = srcptr[cursrcx >> 16];                              \
+					cursrcx += dx;                                                      \
+				}                                                                       \
+				if (curopacity == GFX_OPACITY_OPAQUE)                                   \
+					OPAQUE_SPAN_OP(destptr, priptr, spanbuf, chunk);                    \
+				else                                                                    \
+					SPAN_OP(destptr, priptr, spanbuf, chunk);                           \
+				destptr += chunk;                                                       \
+				PRIORITY_ADVANCE(PRIORITY_TYPE, priptr, chunk);                         \
+				left -= chunk;                                                          \
+			}                                                                           \
+		}                                                                               \
+	} while (0);                                                                        \
+	g_profiler.stop();                                                                  \
+} while (0)
+
 
 /***************************************************************************
     BASIC COPYBITMAP CORE
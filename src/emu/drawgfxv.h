@@ -0,0 +1,424 @@
+// license:BSD-3-Clause
+// copyright-holders:MAMEdev Team
+/*********************************************************************
+
+    drawgfxv.h
+
+    Span-based drawgfx helpers. Each helper renders a contiguous run
+    of 8bpp source pixels into a destination scanline, optionally
+    updating an 8bpp priority scanline. A generic implementation is
+    always available; an SSE2 implementation processing 16 pixels
+    per iteration is compiled in where it can be assumed, and the
+    set of helpers to use is selected at runtime.
+
+    This header only depends on the basic OSD types, so that tools
+    can use it to benchmark the helpers outside of the emulator.
+
+*********************************************************************/
+
+#pragma once
+
+#ifndef __DRAWGFXV_H__
+#define __DRAWGFXV_H__
+
+#include "osdcomm.h"
+
+/* use SSE on 64-bit implementations, where it can be assumed */
+#if (!defined(MAME_DEBUG) || defined(__OPTIMIZE__)) && (defined(__SSE2__) || defined(_MSC_VER)) && defined(PTR64)
+#define DRAWGFX_SPAN_SIMD       1
+#include <emmintrin.h>
+#else
+#define DRAWGFX_SPAN_SIMD       0
+#endif
+
+/* spans shorter than one SIMD iteration are left to the generic helpers */
+#define DRAWGFX_SPAN_SIMD_MIN   16
+
+
+/***************************************************************************
+    TYPE DEFINITIONS
+***************************************************************************/
+
+/* table of span helpers; one of these is selected at runtime */
+struct drawgfx_span_funcs
+{
+	const char *name;
+	void (*opaque16)(UINT16 *dest, const UINT8 *src, int count, UINT32 color);
+	void (*opaque32)(UINT32 *dest, const UINT8 *src, int count, const UINT32 *paldata);
+	void (*transpen16)(UINT16 *dest, const UINT8 *src, int count, UINT32 color, UINT32 trans_pen);
+	void (*transpen32)(UINT32 *dest, const UINT8 *src, int count, const UINT32 *paldata, UINT32 trans_pen);
+	void (*transpen16_prio)(UINT16 *dest, UINT8 *pri, const UINT8 *src, int count, UINT32 color, UINT32 trans_pen, UINT32 pmask);
+	void (*transpen32_prio)(UINT32 *dest, UINT8 *pri, const UINT8 *src, int count, const UINT32 *paldata, UINT32 trans_pen, UINT32 pmask);
+};
+
+
+
+/***************************************************************************
+    GENERIC IMPLEMENTATION
+***************************************************************************/
+
+/*-------------------------------------------------
+    drawgfx_span_opaque16_c - add 'color' to all
+    pixels
+-------------------------------------------------*/
+
+static inline void drawgfx_span_opaque16_c(UINT16 *dest, const UINT8 *src, int count, UINT32 color)
+{
+	for (int x = 0; x < count; x++)
+		dest[x] = color + src[x];
+}
+
+
+/*-------------------------------------------------
+    drawgfx_span_opaque32_c - map all pixels
+    through 'paldata'
+-------------------------------------------------*/
+
+static inline void drawgfx_span_opaque32_c(UINT32 *dest, const UINT8 *src, int count, const UINT32 *paldata)
+{
+	for (int x = 0; x < count; x++)
+		dest[x] = paldata[src[x]];
+}
+
+
+/*-------------------------------------------------
+    drawgfx_span_transpen16_c - add 'color' to
+    all pixels except those matching 'trans_pen'
+-------------------------------------------------*/
+
+static inline void drawgfx_span_transpen16_c(UINT16 *dest, const UINT8 *src, int count, UINT32 color, UINT32 trans_pen)
+{
+	for (int x = 0; x < count; x++)
+	{
+		UINT32 srcdata = src[x];
+		if (srcdata != trans_pen)
+			dest[x] = color + srcdata;
+	}
+}
+
+
+/*-------------------------------------------------
+    drawgfx_span_transpen32_c - map all pixels
+    except those matching 'trans_pen' through
+    'paldata'
+-------------------------------------------------*/
+
+static inline void drawgfx_span_transpen32_c(UINT32 *dest, const UINT8 *src, int count, const UINT32 *paldata, UINT32 trans_pen)
+{
+	for (int x = 0; x < count; x++)
+	{
+		UINT32 srcdata = src[x];
+		if (srcdata != trans_pen)
+			dest[x] = paldata[srcdata];
+	}
+}
+
+
+/*-------------------------------------------------
+    drawgfx_span_transpen16_prio_c - same as
+    drawgfx_span_transpen16_c, checking against
+    and updating the priority scanline
+-------------------------------------------------*/
+
+static inline void drawgfx_span_transpen16_prio_c(UINT16 *dest, UINT8 *pri, const UINT8 *src, int count, UINT32 color, UINT32 trans_pen, UINT32 pmask)
+{
+	for (int x = 0; x < count; x++)
+	{
+		UINT32 srcdata = src[x];
+		if (srcdata != trans_pen)
+		{
+			if (((1 << (pri[x] & 0x1f)) & pmask) == 0)
+				dest[x] = color + srcdata;
+			pri[x] = 31;
+		}
+	}
+}
+
+
+/*-------------------------------------------------
+    drawgfx_span_transpen32_prio_c - same as
+    drawgfx_span_transpen32_c, checking against
+    and updating the priority scanline
+-------------------------------------------------*/
+
+static inline void drawgfx_span_transpen32_prio_c(UINT32 *dest, UINT8 *pri, const UINT8 *src, int count, const UINT32 *paldata, UINT32 trans_pen, UINT32 pmask)
+{
+	for (int x = 0; x < count; x++)
+	{
+		UINT32 srcdata = src[x];
+		if (srcdata != trans_pen)
+		{
+			if (((1 << (pri[x] & 0x1f)) & pmask) == 0)
+				dest[x] = paldata[srcdata];
+			pri[x] = 31;
+		}
+	}
+}
+
+
+static const drawgfx_span_funcs drawgfx_span_generic =
+{
+	"generic",
+	drawgfx_span_opaque16_c,
+	drawgfx_span_opaque32_c,
+	drawgfx_span_transpen16_c,
+	drawgfx_span_transpen32_c,
+	drawgfx_span_transpen16_prio_c,
+	drawgfx_span_transpen32_prio_c
+};
+
+
+
+/***************************************************************************
+    SSE2 IMPLEMENTATION
+***************************************************************************/
+
+#if DRAWGFX_SPAN_SIMD
+
+/*-------------------------------------------------
+    drawgfx_span_prio_writable_sse2 - given 16
+    priority pixels, return a mask of those for
+    which ((1 << (pri & 0x1f)) & pmask) == 0
+-------------------------------------------------*/
+
+static inline __m128i drawgfx_span_prio_writable_sse2(__m128i pri, UINT32 pmask)
+{
+	// select the byte of pmask addressed by bits 3-4 of each priority pixel
+	__m128i bytenum = _mm_and_si128(_mm_srli_epi16(pri, 3), _mm_set1_epi8(0x03));
+	__m128i pbyte = _mm_and_si128(_mm_cmpeq_epi8(bytenum, _mm_setzero_si128()), _mm_set1_epi8((char)(pmask >> 0)));
+	pbyte = _mm_or_si128(pbyte, _mm_and_si128(_mm_cmpeq_epi8(bytenum, _mm_set1_epi8(1)), _mm_set1_epi8((char)(pmask >> 8))));
+	pbyte = _mm_or_si128(pbyte, _mm_and_si128(_mm_cmpeq_epi8(bytenum, _mm_set1_epi8(2)), _mm_set1_epi8((char)(pmask >> 16))));
+	pbyte = _mm_or_si128(pbyte, _mm_and_si128(_mm_cmpeq_epi8(bytenum, _mm_set1_epi8(3)), _mm_set1_epi8((char)(pmask >> 24))));
+
+	// build a one-hot byte from bits 0-2
+	__m128i bitnum = _mm_and_si128(pri, _mm_set1_epi8(0x07));
+	__m128i onehot = _mm_setzero_si128();
+	for (int bit = 0; bit < 8; bit++)
+		onehot = _mm_or_si128(onehot, _mm_and_si128(_mm_cmpeq_epi8(bitnum, _mm_set1_epi8(bit)), _mm_set1_epi8((char)(1 << bit))));
+
+	// writable where the selected bit is clear
+	return _mm_cmpeq_epi8(_mm_and_si128(onehot, pbyte), _mm_setzero_si128());
+}
+
+
+/*-------------------------------------------------
+    drawgfx_span_opaque16_sse2 - SSE2 version
+    of drawgfx_span_opaque16_c
+-------------------------------------------------*/
+
+static void drawgfx_span_opaque16_sse2(UINT16 *dest, const UINT8 *src, int count, UINT32 color)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i rebase = _mm_set1_epi16((short)color);
+
+	for ( ; count >= 16; count -= 16, src += 16, dest += 16)
+	{
+		__m128i srcdata = _mm_loadu_si128((const __m128i *)src);
+		_mm_storeu_si128((__m128i *)&dest[0], _mm_add_epi16(_mm_unpacklo_epi8(srcdata, zero), rebase));
+		_mm_storeu_si128((__m128i *)&dest[8], _mm_add_epi16(_mm_unpackhi_epi8(srcdata, zero), rebase));
+	}
+
+	// handle the leftovers
+	drawgfx_span_opaque16_c(dest, src, count, color);
+}
+
+
+/*-------------------------------------------------
+    drawgfx_span_transpen16_sse2 - SSE2 version
+    of drawgfx_span_transpen16_c
+-------------------------------------------------*/
+
+static void drawgfx_span_transpen16_sse2(UINT16 *dest, const UINT8 *src, int count, UINT32 color, UINT32 trans_pen)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i transpen = _mm_set1_epi8((char)trans_pen);
+	const __m128i rebase = _mm_set1_epi16((short)color);
+
+	for ( ; count >= 16; count -= 16, src += 16, dest += 16)
+	{
+		__m128i srcdata = _mm_loadu_si128((const __m128i *)src);
+		__m128i trans = _mm_cmpeq_epi8(srcdata, transpen);
+		int transbits = _mm_movemask_epi8(trans);
+
+		// skip fully transparent runs
+		if (transbits == 0xffff)
+			continue;
+
+		__m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(srcdata, zero), rebase);
+		__m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(srcdata, zero), rebase);
+
+		// blend with the destination if anything is transparent
+		if (transbits != 0)
+		{
+			__m128i translo = _mm_unpacklo_epi8(trans, trans);
+			__m128i transhi = _mm_unpackhi_epi8(trans, trans);
+			lo = _mm_or_si128(_mm_and_si128(translo, _mm_loadu_si128((const __m128i *)&dest[0])), _mm_andnot_si128(translo, lo));
+			hi = _mm_or_si128(_mm_and_si128(transhi, _mm_loadu_si128((const __m128i *)&dest[8])), _mm_andnot_si128(transhi, hi));
+		}
+		_mm_storeu_si128((__m128i *)&dest[0], lo);
+		_mm_storeu_si128((__m128i *)&dest[8], hi);
+	}
+
+	// handle the leftovers
+	drawgfx_span_transpen16_c(dest, src, count, color, trans_pen);
+}
+
+
+/*-------------------------------------------------
+    drawgfx_span_remap16_sse2 - map 16 pixels
+    through 'paldata', keeping the destination
+    pixels where 'keep' is set; 'keepbits' is
+    its movemask
+-------------------------------------------------*/
+
+static inline void drawgfx_span_remap16_sse2(UINT32 *dest, const UINT8 *src, const UINT32 *paldata, __m128i keep, int keepbits)
+{
+	__m128i keeplo = _mm_unpacklo_epi8(keep, keep);
+	__m128i keephi = _mm_unpackhi_epi8(keep, keep);
+	__m128i keep32[4] = { _mm_unpacklo_epi16(keeplo, keeplo), _mm_unpackhi_epi16(keeplo, keeplo), _mm_unpacklo_epi16(keephi, keephi), _mm_unpackhi_epi16(keephi, keephi) };
+
+	for (int quad = 0; quad < 4; quad++, src += 4, dest += 4)
+	{
+		// SSE2 has no gather, so the lookups stay scalar; the blend and the store do not
+		__m128i pix = _mm_set_epi32(paldata[src[3]], paldata[src[2]], paldata[src[1]], paldata[src[0]]);
+		if (keepbits & (0x0f << (quad * 4)))
+			pix = _mm_or_si128(_mm_and_si128(keep32[quad], _mm_loadu_si128((const __m128i *)dest)), _mm_andnot_si128(keep32[quad], pix));
+		_mm_storeu_si128((__m128i *)dest, pix);
+	}
+}
+
+
+/*-------------------------------------------------
+    drawgfx_span_transpen32_sse2 - SSE2 version
+    of drawgfx_span_transpen32_c
+-------------------------------------------------*/
+
+static void drawgfx_span_transpen32_sse2(UINT32 *dest, const UINT8 *src, int count, const UINT32 *paldata, UINT32 trans_pen)
+{
+	const __m128i transpen = _mm_set1_epi8((char)trans_pen);
+
+	for ( ; count >= 16; count -= 16, src += 16, dest += 16)
+	{
+		__m128i trans = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)src), transpen);
+		int transbits = _mm_movemask_epi8(trans);
+
+		// skip fully transparent runs
+		if (transbits != 0xffff)
+			drawgfx_span_remap16_sse2(dest, src, paldata, trans, transbits);
+	}
+
+	// handle the leftovers
+	drawgfx_span_transpen32_c(dest, src, count, paldata, trans_pen);
+}
+
+
+/*-------------------------------------------------
+    drawgfx_span_transpen16_prio_sse2 - SSE2
+    version of drawgfx_span_transpen16_prio_c
+-------------------------------------------------*/
+
+static void drawgfx_span_transpen16_prio_sse2(UINT16 *dest, UINT8 *pri, const UINT8 *src, int count, UINT32 color, UINT32 trans_pen, UINT32 pmask)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i transpen = _mm_set1_epi8((char)trans_pen);
+	const __m128i rebase = _mm_set1_epi16((short)color);
+	const __m128i toppri = _mm_set1_epi8(31);
+
+	for ( ; count >= 16; count -= 16, src += 16, dest += 16, pri += 16)
+	{
+		__m128i srcdata = _mm_loadu_si128((const __m128i *)src);
+		__m128i trans = _mm_cmpeq_epi8(srcdata, transpen);
+		if (_mm_movemask_epi8(trans) == 0xffff)
+			continue;
+
+		// figure out which pixels get drawn: opaque and not masked by priority
+		__m128i pridata = _mm_loadu_si128((const __m128i *)pri);
+		__m128i keep = _mm_or_si128(trans, _mm_xor_si128(drawgfx_span_prio_writable_sse2(pridata, pmask), _mm_cmpeq_epi8(zero, zero)));
+
+		// every opaque pixel claims the priority
+		_mm_storeu_si128((__m128i *)pri, _mm_or_si128(_mm_and_si128(trans, pridata), _mm_andnot_si128(trans, toppri)));
+
+		__m128i keeplo = _mm_unpacklo_epi8(keep, keep);
+		__m128i keephi = _mm_unpackhi_epi8(keep, keep);
+		__m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(srcdata, zero), rebase);
+		__m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(srcdata, zero), rebase);
+		lo = _mm_or_si128(_mm_and_si128(keeplo, _mm_loadu_si128((const __m128i *)&dest[0])), _mm_andnot_si128(keeplo, lo));
+		hi = _mm_or_si128(_mm_and_si128(keephi, _mm_loadu_si128((const __m128i *)&dest[8])), _mm_andnot_si128(keephi, hi));
+		_mm_storeu_si128((__m128i *)&dest[0], lo);
+		_mm_storeu_si128((__m128i *)&dest[8], hi);
+	}
+
+	// handle the leftovers
+	drawgfx_span_transpen16_prio_c(dest, pri, src, count, color, trans_pen, pmask);
+}
+
+
+/*-------------------------------------------------
+    drawgfx_span_transpen32_prio_sse2 - SSE2
+    version of drawgfx_span_transpen32_prio_c
+-------------------------------------------------*/
+
+static void drawgfx_span_transpen32_prio_sse2(UINT32 *dest, UINT8 *pri, const UINT8 *src, int count, const UINT32 *paldata, UINT32 trans_pen, UINT32 pmask)
+{
+	const __m128i transpen = _mm_set1_epi8((char)trans_pen);
+	const __m128i toppri = _mm_set1_epi8(31);
+
+	for ( ; count >= 16; count -= 16, src += 16, dest += 16, pri += 16)
+	{
+		__m128i trans = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)src), transpen);
+		if (_mm_movemask_epi8(trans) == 0xffff)
+			continue;
+
+		// figure out which pixels get drawn: opaque and not masked by priority
+		__m128i pridata = _mm_loadu_si128((const __m128i *)pri);
+		__m128i keep = _mm_or_si128(trans, _mm_xor_si128(drawgfx_span_prio_writable_sse2(pridata, pmask), _mm_cmpeq_epi8(trans, trans)));
+		int keepbits = _mm_movemask_epi8(keep);
+
+		// every opaque pixel claims the priority
+		_mm_storeu_si128((__m128i *)pri, _mm_or_si128(_mm_and_si128(trans, pridata), _mm_andnot_si128(trans, toppri)));
+
+		if (keepbits != 0xffff)
+			drawgfx_span_remap16_sse2(dest, src, paldata, keep, keepbits);
+	}
+
+	// handle the leftovers
+	drawgfx_span_transpen32_prio_c(dest, pri, src, count, paldata, trans_pen, pmask);
+}
+
+
+static const drawgfx_span_funcs drawgfx_span_sse2 =
+{
+	"sse2",
+	drawgfx_span_opaque16_sse2,
+	drawgfx_span_opaque32_c,
+	drawgfx_span_transpen16_sse2,
+	drawgfx_span_transpen32_sse2,
+	drawgfx_span_transpen16_prio_sse2,
+	drawgfx_span_transpen32_prio_sse2
+};
+
+#endif
+
+
+
+/***************************************************************************
+    SELECTION
+***************************************************************************/
+
+/*-------------------------------------------------
+    drawgfx_span_select - return the best set of
+    span helpers, or the generic ones if SIMD is
+    not wanted or not available
+-------------------------------------------------*/
+
+static inline const drawgfx_span_funcs &drawgfx_span_select(bool simd)
+{
+#if DRAWGFX_SPAN_SIMD
+	if (simd)
+		return drawgfx_span_sse2;
+#endif
+	return drawgfx_span_generic;
+}
+
+
+#endif  /* __DRAWGFXV_H__ */
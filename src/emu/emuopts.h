@@ -92,6 +92,7 @@ enum
 #define OPTION_SLEEP                "sleep"
 #define OPTION_SPEED                "speed"
 #define OPTION_REFRESHSPEED         "refreshspeed"
+#define OPTION_SIMDBLIT             "simdblit"
 
 // core rotation options
 #define OPTION_ROTATE               "rotate"
@@ -171,6 +172,8 @@ enum
 #define OPTION_BIOS                 "bios"
 #define OPTION_CHEAT                "cheat"
 #define OPTION_SKIP_GAMEINFO        "skip_gameinfo"
+#define OPTION_HASH_CACHE           "hash_cache"
+#define OPTION_VERIFY_HASH_CACHE    "verify_hash_cache"
 #define OPTION_UI_FONT              "uifont"
 #define OPTION_RAMSIZE              "ramsize"
 
@@ -269,6 +272,7 @@ public:
 	bool sleep() const { return bool_value(OPTION_SLEEP); }
 	float speed() const { return float_value(OPTION_SPEED); }
 	bool refresh_speed() const { return bool_value(OPTION_REFRESHSPEED); }
+	bool simd_blit() const { return bool_value(OPTION_SIMDBLIT); }
 
 	// core rotation options
 	bool rotate() const { return bool_value(OPTION_ROTATE); }
@@ -346,6 +350,8 @@ public:
 	const char *bios() const { return value(OPTION_BIOS); }
 	bool cheat() const { return bool_value(OPTION_CHEAT); }
 	bool skip_gameinfo() const { return bool_value(OPTION_SKIP_GAMEINFO); }
+	bool hash_cache() const { return bool_value(OPTION_HASH_CACHE); }
+	bool verify_hash_cache() const { return bool_value(OPTION_VERIFY_HASH_CACHE); }
 	const char *ui_font() const { return value(OPTION_UI_FONT); }
 	const char *ram_size() const { return value(OPTION_RAMSIZE); }
 
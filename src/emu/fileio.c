@@ -146,10 +146,14 @@ emu_file::emu_file(UINT32 openflags)
 		m_openflags(openflags),
 		m_zipfile(NULL),
 		m_ziplength(0),
+		m_zipmap(NULL),
+		m_zipcrc(0),
+		m_zippending(false),
 		m__7zfile(NULL),
 		m__7zlength(0),
 		m_remove_on_close(false),
-		m_restrict_to_mediapath(false)
+		m_restrict_to_mediapath(false),
+		m_hash_cache(NULL)
 {
 	// sanity check the open flags
 	if ((m_openflags & OPEN_FLAG_HAS_CRC) && (m_openflags & OPEN_FLAG_WRITE))
@@ -164,10 +168,14 @@ emu_file::emu_file(const char *searchpath, UINT32 openflags)
 		m_openflags(openflags),
 		m_zipfile(NULL),
 		m_ziplength(0),
+		m_zipmap(NULL),
+		m_zipcrc(0),
+		m_zippending(false),
 		m__7zfile(NULL),
 		m__7zlength(0),
 		m_remove_on_close(false),
-		m_restrict_to_mediapath(false)
+		m_restrict_to_mediapath(false),
+		m_hash_cache(NULL)
 {
 	// sanity check the open flags
 	if ((m_openflags & OPEN_FLAG_HAS_CRC) && (m_openflags & OPEN_FLAG_WRITE))
@@ -232,6 +240,12 @@ hash_collection &emu_file::hashes(const char *types)
 	if (needed.empty())
 		return m_hashes;
 
+	// see if the hash cache remembers this file from an earlier run
+	UINT64 stampsize = 0, stamptime = 0;
+	bool cacheable = (m_hash_cache != NULL && !m_container.empty() && hash_cache::stamp(m_container.c_str(), stampsize, stamptime));
+	if (cacheable && m_hash_cache->find(m_container.c_str(), m_member.c_str(), stampsize, stamptime, types, m_hashes))
+		return m_hashes;
+
 	// load the ZIP file if needed
 	if (compressed_file_ready())
 		return m_hashes;
@@ -240,24 +254,25 @@ hash_collection &emu_file::hashes(const char *types)
 
 	// if we have ZIP data, just hash that directly
 	if (!m__7zdata.empty())
-	{
 		m_hashes.compute(&m__7zdata[0], m__7zdata.size(), needed.c_str());
-		return m_hashes;
-	}
 
-	if (!m_zipdata.empty())
-	{
+	else if (!m_zipdata.empty())
 		m_hashes.compute(&m_zipdata[0], m_zipdata.size(), needed.c_str());
-		return m_hashes;
-	}
 
-	// read the data if we can
-	const UINT8 *filedata = (const UINT8 *)core_fbuffer(m_file);
-	if (filedata == NULL)
-		return m_hashes;
+	else
+	{
+		// read the data if we can
+		const UINT8 *filedata = (const UINT8 *)core_fbuffer(m_file);
+		if (filedata == NULL)
+			return m_hashes;
+
+		// compute the hash
+		m_hashes.compute(filedata, core_fsize(m_file), needed.c_str());
+	}
 
-	// compute the hash
-	m_hashes.compute(filedata, core_fsize(m_file), needed.c_str());
+	// remember the result for next time
+	if (cacheable)
+		m_hash_cache->add(m_container.c_str(), m_member.c_str(), stampsize, stamptime, m_hashes);
 	return m_hashes;
 }
 
@@ -351,7 +366,11 @@ file_error emu_file::open_next()
 		// attempt to open the file directly
 		filerr = core_fopen(m_fullpath.c_str(), m_openflags, &m_file);
 		if (filerr == FILERR_NONE)
+		{
+			if ((m_openflags & (OPEN_FLAG_READ | OPEN_FLAG_WRITE)) == OPEN_FLAG_READ)
+				m_container = m_fullpath;
 			break;
+		}
 
 		// if we're opening for read-only we have other options
 		if ((m_openflags & (OPEN_FLAG_READ | OPEN_FLAG_WRITE)) == OPEN_FLAG_READ)
@@ -404,11 +423,17 @@ void emu_file::close()
 	if (m_zipfile != NULL)
 		zip_file_close(m_zipfile);
 	m_zipfile = NULL;
+	m_zippending = false;
 
 	if (m_file != NULL)
 		core_fclose(m_file);
 	m_file = NULL;
 
+	// the RAM file may point into the mapped ZIP, so release it afterwards
+	if (m_zipmap != NULL)
+		core_fclose(m_zipmap);
+	m_zipmap = NULL;
+
 	m__7zdata.clear();
 	m_zipdata.clear();
 
@@ -419,6 +444,8 @@ void emu_file::close()
 	// reset our hashes and path as well
 	m_hashes.reset();
 	m_fullpath.clear();
+	m_container.clear();
+	m_member.clear();
 }
 
 
@@ -445,7 +472,7 @@ bool emu_file::compressed_file_ready(void)
 	if (m__7zfile != NULL && load__7zped_file() != FILERR_NONE)
 		return true;
 
-	if (m_zipfile != NULL && load_zipped_file() != FILERR_NONE)
+	if ((m_zipfile != NULL || m_zippending) && load_zipped_file() != FILERR_NONE)
 		return true;
 
 	return false;
@@ -515,7 +542,7 @@ UINT64 emu_file::size()
 	if (m__7zfile != NULL)
 		return m__7zlength;
 
-	if (m_zipfile != NULL)
+	if (m_zipfile != NULL || m_zippending)
 		return m_ziplength;
 
 	// return length if we can
@@ -709,34 +736,39 @@ file_error emu_file::attempt_zipped()
 			continue;
 
 		// see if we can find a file with the right name and (if available) crc
-		const zip_file_header *header;
-		for (header = zip_file_first_file(zip); header != NULL; header = zip_file_next_file(zip))
-			if (zip_filename_match(*header, filename) && (!(m_openflags & OPEN_FLAG_HAS_CRC) || header->crc == m_crc))
-				break;
+		const zip_file_header *header = zip_file_search(zip, m_crc, filename.c_str(), (m_openflags & OPEN_FLAG_HAS_CRC) != 0, true);
 
 		// if that failed, look for a file with the right crc, but the wrong filename
 		if (header == NULL && (m_openflags & OPEN_FLAG_HAS_CRC))
-			for (header = zip_file_first_file(zip); header != NULL; header = zip_file_next_file(zip))
-				if (header->crc == m_crc && !zip_header_is_path(*header))
-					break;
+			header = zip_file_search(zip, m_crc, filename.c_str(), true, false);
 
 		// if that failed, look for a file with the right name; reporting a bad checksum
 		// is more helpful and less confusing than reporting "rom not found"
-		if (header == NULL)
-			for (header = zip_file_first_file(zip); header != NULL; header = zip_file_next_file(zip))
-				if (zip_filename_match(*header, filename))
-					break;
+		if (header == NULL && (m_openflags & OPEN_FLAG_HAS_CRC))
+			header = zip_file_search(zip, m_crc, filename.c_str(), false, true);
 
 		// if we got it, read the data
 		if (header != NULL)
 		{
-			m_zipfile = zip;
 			m_ziplength = header->uncompressed_length;
+			m_zipcrc = header->crc;
+			m_container = zip->filename;
+			m_member = header->filename;
 
 			// build a hash with just the CRC
 			m_hashes.reset();
 			m_hashes.add_crc(header->crc);
-			return (m_openflags & OPEN_FLAG_NO_PRELOAD) ? FILERR_NONE : load_zipped_file();
+
+			// if we're not loading yet, hand the ZIP back to the cache so that the next
+			// file opened from it doesn't have to read the central directory again
+			if (m_openflags & OPEN_FLAG_NO_PRELOAD)
+			{
+				zip_file_close(zip);
+				m_zippending = true;
+				return FILERR_NONE;
+			}
+			m_zipfile = zip;
+			return load_zipped_file();
 		}
 
 		// close up the ZIP file and try the next level
@@ -753,7 +785,41 @@ file_error emu_file::load_zipped_file()
 {
 	assert(m_file == NULL);
 	assert(m_zipdata.empty());
-	assert(m_zipfile != NULL);
+	assert(m_zipfile != NULL || m_zippending);
+
+	// get the ZIP back from the cache and find our member again
+	if (m_zipfile == NULL)
+	{
+		zip_file *zip;
+		if (zip_file_open(m_container.c_str(), &zip) != ZIPERR_NONE)
+			return FILERR_FAILURE;
+		if (zip_file_search(zip, m_zipcrc, m_member.c_str(), true, true) == NULL)
+		{
+			zip_file_close(zip);
+			return FILERR_FAILURE;
+		}
+		m_zipfile = zip;
+		m_zippending = false;
+	}
+
+	// stored members can be used in place from a mapping of the ZIP
+	UINT64 offset;
+	if (!(m_openflags & OPEN_FLAG_WRITE) && zip_file_stored_offset(m_zipfile, &offset) == ZIPERR_NONE &&
+		core_fopen(m_zipfile->filename, OPEN_FLAG_READ, &m_zipmap) == FILERR_NONE)
+	{
+		const UINT8 *base = (const UINT8 *)core_fmap(m_zipmap);
+		if (base != NULL && offset + m_ziplength <= core_fsize(m_zipmap) &&
+			core_fopen_ram(base + offset, m_ziplength, m_openflags, &m_file) == FILERR_NONE)
+		{
+			zip_file_close(m_zipfile);
+			m_zipfile = NULL;
+			return FILERR_NONE;
+		}
+
+		// fall back to reading it
+		core_fclose(m_zipmap);
+		m_zipmap = NULL;
+	}
 
 	// allocate some memory
 	m_zipdata.resize(m_ziplength);
@@ -781,29 +847,6 @@ file_error emu_file::load_zipped_file()
 }
 
 
-//-------------------------------------------------
-//  zip_filename_match - compare zip filename
-//  to expected filename, ignoring any directory
-//-------------------------------------------------
-
-bool emu_file::zip_filename_match(const zip_file_header &header, const std::string &filename)
-{
-	const char *zipfile = header.filename + header.filename_length - filename.length();
-	return (zipfile >= header.filename && core_stricmp(filename.c_str(),zipfile) == 0 && (zipfile == header.filename || zipfile[-1] == '/'));
-}
-
-
-//-------------------------------------------------
-//  zip_header_is_path - check whether filename
-//  in header is a path
-//-------------------------------------------------
-
-bool emu_file::zip_header_is_path(const zip_file_header &header)
-{
-	const char *zipfile = header.filename + header.filename_length - 1;
-	return (zipfile >= header.filename && zipfile[0] == '/');
-}
-
 //-------------------------------------------------
 //  attempt__7zped - attempt to open a .7z file
 //-------------------------------------------------
@@ -861,6 +904,8 @@ file_error emu_file::attempt__7zped()
 		{
 			m__7zfile = _7z;
 			m__7zlength = _7z->uncompressed_length;
+			m_container = _7z->filename;
+			strprintf(m_member, "#%d", fileno);
 
 			// build a hash with just the CRC
 			m_hashes.reset();
@@ -96,6 +96,7 @@ public:
 	const char *filename() const { return m_filename.c_str(); }
 	const char *fullpath() const { return m_fullpath.c_str(); }
 	UINT32 openflags() const { return m_openflags; }
+	bool pending_7z_load() const { return (m__7zfile != NULL); }
 	hash_collection &hashes(const char *types);
 	bool restrict_to_mediapath() { return m_restrict_to_mediapath; }
 	bool part_of_mediapath(std::string path);
@@ -104,6 +105,7 @@ public:
 	void remove_on_close() { m_remove_on_close = true; }
 	void set_openflags(UINT32 openflags) { assert(m_file == NULL); m_openflags = openflags; }
 	void set_restrict_to_mediapath(bool rtmp = true) { m_restrict_to_mediapath = rtmp; }
+	void set_hash_cache(hash_cache *cache) { m_hash_cache = cache; }
 
 	// open/close
 	file_error open(const char *name);
@@ -143,8 +145,6 @@ private:
 	// internal helpers
 	file_error attempt_zipped();
 	file_error load_zipped_file();
-	bool zip_filename_match(const zip_file_header &header, const std::string &filename);
-	bool zip_header_is_path(const zip_file_header &header);
 
 	file_error attempt__7zped();
 	file_error load__7zped_file();
@@ -162,6 +162,9 @@ private:
 	zip_file *      m_zipfile;                      // ZIP file pointer
 	dynamic_buffer  m_zipdata;                      // ZIP file data
 	UINT64          m_ziplength;                    // ZIP file length
+	core_file *     m_zipmap;                       // mapped ZIP holding a stored member, or NULL
+	UINT32          m_zipcrc;                       // CRC of the ZIP member
+	bool            m_zippending;                   // flag: ZIP member found, but its ZIP is back in the cache
 
 	_7z_file *      m__7zfile;                      // 7Z file pointer
 	dynamic_buffer  m__7zdata;                      // 7Z file data
@@ -169,6 +172,10 @@ private:
 
 	bool            m_remove_on_close;              // flag: remove the file when closing
 	bool            m_restrict_to_mediapath;    // flag: restrict to paths inside the media-path
+
+	hash_cache *    m_hash_cache;                   // cache of hashes from earlier runs, or NULL
+	std::string     m_container;                    // file on disk holding our data, for the hash cache
+	std::string     m_member;                       // name of our data within the container
 };
 
 
@@ -23,6 +23,10 @@ const char *hash_collection::HASH_TYPES_CRC = "R";
 const char *hash_collection::HASH_TYPES_CRC_SHA1 = "RS";
 const char *hash_collection::HASH_TYPES_ALL = "RS";
 
+// name of the hash cache file, and the header line identifying its format
+static const char HASH_CACHE_FILENAME[] = "hashcache.dat";
+static const char HASH_CACHE_HEADER[] = "# MAME hash cache v1";
+
 
 
 //**************************************************************************
@@ -416,3 +420,182 @@ void hash_collection::copyfrom(const hash_collection &src)
 	// don't copy creators
 	m_creator = NULL;
 }
+
+
+
+//**************************************************************************
+//  HASH CACHE
+//**************************************************************************
+
+//-------------------------------------------------
+//  hash_cache - constructor
+//-------------------------------------------------
+
+hash_cache::hash_cache(const emu_options &options)
+	: m_directory(options.cfg_directory()),
+		m_lock(osd_lock_alloc()),
+		m_dirty(false)
+{
+	load(m_entries);
+}
+
+
+//-------------------------------------------------
+//  ~hash_cache - destructor
+//-------------------------------------------------
+
+hash_cache::~hash_cache()
+{
+	osd_lock_free(m_lock);
+}
+
+
+//-------------------------------------------------
+//  stamp - get the size and modification time
+//  that a cached entry for the given container
+//  must match; returns false if the container
+//  can't be cached
+//-------------------------------------------------
+
+bool hash_cache::stamp(const char *container, UINT64 &size, UINT64 &modified)
+{
+	osd_directory_entry *entry = osd_stat(container);
+	if (entry == NULL)
+		return false;
+
+	// without a modification time we have no way to notice changes
+	bool result = (entry->type == ENTTYPE_FILE && entry->last_modified != 0);
+	size = entry->size;
+	modified = entry->last_modified;
+	osd_free(entry);
+	return result;
+}
+
+
+//-------------------------------------------------
+//  find - look up the hashes for a member of a
+//  container; succeeds only if the entry is still
+//  current and has all the requested types
+//-------------------------------------------------
+
+bool hash_cache::find(const char *container, const char *member, UINT64 size, UINT64 modified, const char *types, hash_collection &hashes)
+{
+	std::string key(container);
+	key.append("\t").append(member);
+
+	// copy the entry out under the lock
+	std::string cached;
+	osd_lock_acquire(m_lock);
+	entry_map::const_iterator found = m_entries.find(key);
+	if (found != m_entries.end() && found->second.m_size == size && found->second.m_modified == modified)
+		cached = found->second.m_hashes;
+	osd_lock_release(m_lock);
+	if (cached.empty())
+		return false;
+
+	// make sure it has everything we need
+	hash_collection result;
+	if (!result.from_internal_string(cached.c_str()))
+		return false;
+	std::string have;
+	result.hash_types(have);
+	for (const char *scan = types; *scan != 0; scan++)
+		if (have.find_first_of(*scan) == -1)
+			return false;
+
+	hashes = result;
+	return true;
+}
+
+
+//-------------------------------------------------
+//  add - remember the hashes for a member of a
+//  container
+//-------------------------------------------------
+
+void hash_cache::add(const char *container, const char *member, UINT64 size, UINT64 modified, const hash_collection &hashes)
+{
+	// the file format can't represent names with tabs or line breaks
+	if (strpbrk(container, "\t\r\n") != NULL || strpbrk(member, "\t\r\n") != NULL)
+		return;
+
+	std::string key(container);
+	key.append("\t").append(member);
+
+	entry newentry;
+	newentry.m_size = size;
+	newentry.m_modified = modified;
+	if (hashes.internal_string(newentry.m_hashes)[0] == 0)
+		return;
+
+	osd_lock_acquire(m_lock);
+	m_entries[key] = newentry;
+	m_dirty = true;
+	osd_lock_release(m_lock);
+}
+
+
+//-------------------------------------------------
+//  save - write the cache back out if anything
+//  has been added since it was loaded
+//-------------------------------------------------
+
+void hash_cache::save()
+{
+	osd_lock_acquire(m_lock);
+	if (m_dirty)
+	{
+		// pick up anything another instance wrote since we loaded, keeping our own entries
+		entry_map ondisk;
+		load(ondisk);
+		m_entries.insert(ondisk.begin(), ondisk.end());
+
+		emu_file file(m_directory.c_str(), OPEN_FLAG_WRITE | OPEN_FLAG_CREATE | OPEN_FLAG_CREATE_PATHS);
+		if (file.open(HASH_CACHE_FILENAME) == FILERR_NONE)
+		{
+			file.printf("%s\n", HASH_CACHE_HEADER);
+			for (entry_map::const_iterator curentry = m_entries.begin(); curentry != m_entries.end(); ++curentry)
+				file.printf("%" I64FMT "u\t%" I64FMT "u\t%s\t%s\n", curentry->second.m_size, curentry->second.m_modified, curentry->second.m_hashes.c_str(), curentry->first.c_str());
+			m_dirty = false;
+		}
+	}
+	osd_lock_release(m_lock);
+}
+
+
+//-------------------------------------------------
+//  load - read the cache file into a map; each
+//  line is size, modification time, hashes,
+//  container and member, separated by tabs
+//-------------------------------------------------
+
+void hash_cache::load(entry_map &entries)
+{
+	emu_file file(m_directory.c_str(), OPEN_FLAG_READ);
+	if (file.open(HASH_CACHE_FILENAME) != FILERR_NONE)
+		return;
+
+	// ignore files written in some other format
+	char buffer[4096];
+	if (file.gets(buffer, ARRAY_LENGTH(buffer)) == NULL || strncmp(buffer, HASH_CACHE_HEADER, strlen(HASH_CACHE_HEADER)) != 0)
+		return;
+
+	while (file.gets(buffer, ARRAY_LENGTH(buffer)) != NULL)
+	{
+		// strip the line ending
+		char *end = buffer + strcspn(buffer, "\r\n");
+		*end = 0;
+
+		// split off the size, time and hashes; what remains is the key
+		entry newentry;
+		int consumed = 0;
+		if (sscanf(buffer, "%" I64FMT "u\t%" I64FMT "u\t%n", &newentry.m_size, &newentry.m_modified, &consumed) != 2 || consumed == 0)
+			continue;
+		char *ptr = buffer + consumed;
+		char *hashend = strchr(ptr, '\t');
+		if (hashend == NULL || strchr(hashend + 1, '\t') == NULL)
+			continue;
+		newentry.m_hashes.assign(ptr, hashend - ptr);
+		entries.insert(entry_map::value_type(std::string(hashend + 1), newentry));
+	}
+}
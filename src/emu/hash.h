@@ -16,6 +16,7 @@
 #define __HASH_H__
 
 #include "hashing.h"
+#include <map>
 
 
 //**************************************************************************
@@ -117,4 +118,50 @@ private:
 };
 
 
+// ======================> hash_cache
+
+class emu_options;
+
+// an on-disk record of file hashes, keyed by container path and member name
+// and only trusted while the container's size and modification time match
+class hash_cache
+{
+	// disable copying/assignment
+	hash_cache(const hash_cache &);
+	hash_cache &operator=(const hash_cache &);
+
+public:
+	// construction/destruction
+	hash_cache(const emu_options &options);
+	~hash_cache();
+
+	// lookups
+	static bool stamp(const char *container, UINT64 &size, UINT64 &modified);
+	bool find(const char *container, const char *member, UINT64 size, UINT64 modified, const char *types, hash_collection &hashes);
+	void add(const char *container, const char *member, UINT64 size, UINT64 modified, const hash_collection &hashes);
+
+	// persistence
+	void save();
+
+private:
+	// a remembered set of hashes
+	struct entry
+	{
+		UINT64          m_size;             // size of the container when hashed
+		UINT64          m_modified;         // modification time of the container when hashed
+		std::string     m_hashes;           // hashes in internal format
+	};
+	typedef std::map<std::string, entry> entry_map;
+
+	// internal helpers
+	void load(entry_map &entries);
+
+	// internal state
+	std::string         m_directory;        // directory holding the cache file
+	osd_lock *          m_lock;             // lock protecting the entries
+	entry_map           m_entries;          // entries keyed by container and member
+	bool                m_dirty;            // have entries been added since loading?
+};
+
+
 #endif  /* __HASH_H__ */
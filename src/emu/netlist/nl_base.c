@@ -146,10 +146,11 @@ void queue_t::on_pre_save()
 	NL_VERBOSE_OUT(("on_pre_save\n"));
 	m_qsize = this->count();
 	NL_VERBOSE_OUT(("current time %f qsize %d\n", netlist().time().as_double(), m_qsize));
+	const entry_t *list = this->listptr();
 	for (int i = 0; i < m_qsize; i++ )
 	{
-		m_times[i] =  this->listptr()[i].exec_time().as_raw();
-		pstring p = this->listptr()[i].object()->name();
+		m_times[i] =  list[i].exec_time().as_raw();
+		pstring p = list[i].object()->name();
 		int n = p.len();
 		n = std::min(63, n);
 		std::strncpy(&(m_names[i][0]), p, n);
@@ -47,11 +47,13 @@ namespace netlist
 
 		timed_queue(unsigned list_size)
 		: m_list(list_size)
+		, m_length_hist(list_size + 1)
 		{
 	#if HAS_OPENMP && USE_OPENMP
 			m_lock = 0;
 	#endif
 			clear();
+			clear_stats();
 		}
 
 		ATTR_HOT  std::size_t capacity() const { return m_list.size(); }
@@ -64,6 +66,7 @@ namespace netlist
 			/* Lock */
 			while (atomic_exchange32(&m_lock, 1)) { }
 	#endif
+			inc_stat(m_length_hist[count()]);
 			const _Time t = e.exec_time();
 			entry_t * i = m_end++;
 			while (t > (i - 1)->exec_time())
@@ -82,6 +85,7 @@ namespace netlist
 
 		ATTR_HOT  const entry_t *pop()
 		{
+			inc_stat(m_stat_pops);
 			return --m_end;
 		}
 
@@ -136,6 +140,20 @@ namespace netlist
 		ATTR_HOT  int count() const { return m_end - &m_list[1]; }
 		ATTR_HOT  const entry_t & operator[](const int & index) const { return m_list[1+index]; }
 
+		// statistics
+
+		ATTR_COLD void clear_stats()
+		{
+			m_stat_pops = 0;
+			for (std::size_t i = 0; i < m_length_hist.size(); i++)
+				m_length_hist[i] = 0;
+		}
+
+		/* number of entries processed, only counted with NL_KEEP_STATISTICS */
+		ATTR_COLD UINT64 stat_processed() const { return m_stat_pops; }
+		/* number of pushes which found a queue of the given length */
+		ATTR_COLD UINT64 stat_length(const unsigned length) const { return m_length_hist[length]; }
+
 	#if (NL_KEEP_STATISTICS)
 		// profiling
 		INT32   m_prof_sortmove;
@@ -151,6 +169,8 @@ namespace netlist
 		//entry_t m_list[_Size];
 		parray_t<entry_t> m_list;
 
+		UINT64 m_stat_pops;
+		parray_t<UINT64> m_length_hist;
 	};
 
 }
@@ -138,6 +138,21 @@ typedef int64_t      INT64;
 
 #endif
 
+//============================================================
+//  Timing
+//============================================================
+
+#if !(PSTANDALONE)
+typedef osd_ticks_t pticks_t;
+inline pticks_t pticks() { return osd_ticks(); }
+inline pticks_t pticks_per_second() { return osd_ticks_per_second(); }
+#else
+#include <ctime>
+typedef clock_t pticks_t;
+inline pticks_t pticks() { return clock(); }
+inline pticks_t pticks_per_second() { return CLOCKS_PER_SEC; }
+#endif
+
 /*
  * The following class was derived from the MAME delegate.h code.
  * It derives a pointer to a member function.
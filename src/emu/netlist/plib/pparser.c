@@ -147,6 +147,8 @@ ptokenizer::token_t ptokenizer::get_token()
 		{
 			do {
 				ret = get_token_internal();
+				if (ret.is_type(ENDOFFILE))
+					return ret;
 			} while (ret.is_not(m_tok_comment_end));
 		}
 		else if (ret.is(m_tok_line_comment))
@@ -174,6 +176,9 @@ ptokenizer::token_t ptokenizer::get_token_internal()
 			return token_t(ENDOFFILE);
 		}
 	}
+	/* getc returns 0 at the end and find() matches 0 in every set */
+	if (c == 0)
+		return token_t(ENDOFFILE);
 	if (m_number_chars_start.find(c)>=0)
 	{
 		/* read number while we receive number or identifier chars
@@ -182,7 +187,7 @@ ptokenizer::token_t ptokenizer::get_token_internal()
 		 */
 		token_type ret = NUMBER;
 		pstring tokstr = "";
-		while (true) {
+		while (c != 0) {
 			if (m_identifier_chars.find(c)>=0 && m_number_chars.find(c)<0)
 				ret = IDENTIFIER;
 			else if (m_number_chars.find(c)<0)
@@ -197,7 +202,7 @@ ptokenizer::token_t ptokenizer::get_token_internal()
 	{
 		/* read identifier till non identifier char */
 		pstring tokstr = "";
-		while (m_identifier_chars.find(c)>=0) {
+		while (c != 0 && m_identifier_chars.find(c)>=0) {
 			tokstr += c;
 			c = getc();
 		}
@@ -216,6 +221,8 @@ ptokenizer::token_t ptokenizer::get_token_internal()
 		c = getc();
 		while (c != m_string)
 		{
+			if (c == 0)
+				error("Error: unterminated string <%s>\n", tokstr.cstr());
 			tokstr += c;
 			c = getc();
 		}
@@ -225,7 +232,7 @@ ptokenizer::token_t ptokenizer::get_token_internal()
 	{
 		/* read identifier till first identifier char or ws */
 		pstring tokstr = "";
-		while ((m_identifier_chars.find(c)) < 0 && (m_whitespace.find(c) < 0)) {
+		while (c != 0 && (m_identifier_chars.find(c)) < 0 && (m_whitespace.find(c) < 0)) {
 			tokstr += c;
 			/* expensive, check for single char tokens */
 			if (tokstr.len() == 1)
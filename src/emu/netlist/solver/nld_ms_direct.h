@@ -31,6 +31,8 @@ public:
 
 	ATTR_HOT inline int vsolve_non_dynamic(const bool newton_raphson);
 
+	ATTR_COLD virtual pstring static_solver_code();
+
 protected:
 	virtual void add_term(int net_idx, terminal_t *term);
 
@@ -43,6 +45,9 @@ protected:
 	ATTR_HOT void LE_back_subst(nl_double * RESTRICT x);
 	ATTR_HOT nl_double delta(const nl_double * RESTRICT V);
 	ATTR_HOT void store(const nl_double * RESTRICT V);
+	ATTR_HOT int store_checked(const nl_double * RESTRICT V, const bool newton_raphson);
+
+	ATTR_COLD pstring topology_hash();
 
 	/* bring the whole system to the current time
 	 * Don't schedule a new calculation time. The recalculation has to be
@@ -58,6 +63,8 @@ protected:
 	terms_t **m_terms;
 	terms_t *m_rails_temp;
 
+	static_solver_func m_static_solver;
+
 private:
 
 	const unsigned m_dim;
@@ -279,6 +286,106 @@ ATTR_COLD void matrix_solver_direct_t<m_N, _storage_N>::vsetup(analog_net_t::lis
 		save(m_terms[k]->Idr(),"IDR" + num , m_terms[k]->count());
 	}
 
+	/* use generated code for this topology if compiled in */
+	m_static_solver = static_solver_t::find(topology_hash());
+	if (m_static_solver != NULL)
+		netlist().log("%s: using static solver %s", name().cstr(), topology_hash().cstr());
+}
+
+/* The elimination only depends on the dimensions of m_A and the non-zero
+ * elements of each row. Anything which changes these changes the hash.
+ */
+
+template <unsigned m_N, unsigned _storage_N>
+ATTR_COLD pstring matrix_solver_direct_t<m_N, _storage_N>::topology_hash()
+{
+	pstring desc = pstring::sprintf("%d,%d", N(), (int) (sizeof(m_A[0]) / sizeof(m_A[0][0])));
+	for (unsigned k = 0; k < N(); k++)
+	{
+		desc += ":";
+		for (unsigned j = 0; j < m_terms[k]->m_nz.size(); j++)
+			desc += pstring::sprintf(",%d", m_terms[k]->m_nz[j]);
+		desc += "/";
+		for (unsigned j = 0; j < m_terms[k]->m_nzrd.size(); j++)
+			desc += pstring::sprintf(",%d", m_terms[k]->m_nzrd[j]);
+	}
+
+	/* 64 bit FNV-1a */
+	UINT64 hash = U64(14695981039346656037);
+	for (const char *p = desc.cstr(); *p != 0; p++)
+		hash = (hash ^ (UINT8) *p) * U64(1099511628211);
+	return pstring::sprintf("%08x%08x", (UINT32) (hash >> 32), (UINT32) hash);
+}
+
+/* Emit LE_solve and LE_back_subst unrolled for this topology. The
+ * operations are the same and in the same order, so the results are
+ * identical. Rows are only eliminated where the pattern allows a
+ * non-zero element; LE_solve skips the others at runtime.
+ */
+
+template <unsigned m_N, unsigned _storage_N>
+ATTR_COLD pstring matrix_solver_direct_t<m_N, _storage_N>::static_solver_code()
+{
+	const unsigned iN = N();
+	const unsigned stride = sizeof(m_A[0]) / sizeof(m_A[0][0]);
+	bool nz[_storage_N][_storage_N];
+
+	for (unsigned k = 0; k < iN; k++)
+	{
+		for (unsigned j = 0; j < iN; j++)
+			nz[k][j] = false;
+		for (unsigned j = 0; j < m_terms[k]->m_nz.size(); j++)
+			nz[k][m_terms[k]->m_nz[j]] = true;
+	}
+
+	pstring code = pstring::sprintf("// %s: %d nets\n", name().cstr(), iN);
+	code += pstring::sprintf("static void nl_gcr_%s(nl_double * RESTRICT A, nl_double * RESTRICT RHS, nl_double * RESTRICT V)\n{\n", topology_hash().cstr());
+	code += "\tnl_double f, f1;\n";
+
+	for (unsigned i = 0; i < iN; i++)
+	{
+		const terms_t *t = m_terms[i];
+		bool first = true;
+
+		for (unsigned j = i + 1; j < iN; j++)
+		{
+			if (!nz[j][i])
+				continue;
+			if (first)
+				code += pstring::sprintf("\tf = 1.0 / A[%d];\n", i * stride + i);
+			first = false;
+			code += pstring::sprintf("\tf1 = -A[%d] * f;\n", j * stride + i);
+			for (unsigned k = 0; k < t->m_nzrd.size(); k++)
+			{
+				const unsigned pk = t->m_nzrd[k];
+				code += pstring::sprintf("\tA[%d] += A[%d] * f1;\n", j * stride + pk, i * stride + pk);
+				nz[j][pk] = true;
+			}
+			code += pstring::sprintf("\tRHS[%d] += RHS[%d] * f1;\n", j, i);
+		}
+	}
+
+	for (int j = iN - 1; j >= 0; j--)
+	{
+		const terms_t *t = m_terms[j];
+
+		if (t->m_nzrd.size() == 0)
+		{
+			code += pstring::sprintf("\tV[%d] = RHS[%d] / A[%d];\n", j, j, j * stride + j);
+			continue;
+		}
+		code += pstring::sprintf("\tV[%d] = (RHS[%d] - (", j, j);
+		for (unsigned k = 0; k < t->m_nzrd.size(); k++)
+		{
+			const unsigned pk = t->m_nzrd[k];
+			code += pstring::sprintf("%sA[%d] * V[%d]", k == 0 ? "" : " + ", j * stride + pk, pk);
+		}
+		code += pstring::sprintf(")) / A[%d];\n", j * stride + j);
+	}
+	code += "}\n";
+	code += pstring::sprintf("static static_solver_t s_nl_gcr_%s(\"%s\", nl_gcr_%s);\n\n",
+			topology_hash().cstr(), topology_hash().cstr(), topology_hash().cstr());
+	return code;
 }
 
 
@@ -499,17 +606,23 @@ ATTR_HOT int matrix_solver_direct_t<m_N, _storage_N>::solve_non_dynamic(ATTR_UNU
 
 	this->LE_back_subst(new_v);
 
+	return this->store_checked(new_v, newton_raphson);
+}
+
+template <unsigned m_N, unsigned _storage_N>
+ATTR_HOT int matrix_solver_direct_t<m_N, _storage_N>::store_checked(const nl_double * RESTRICT V, const bool newton_raphson)
+{
 	if (newton_raphson)
 	{
-		nl_double err = delta(new_v);
+		nl_double err = delta(V);
 
-		store(new_v);
+		store(V);
 
 		return (err > this->m_params.m_accuracy) ? 2 : 1;
 	}
 	else
 	{
-		store(new_v);
+		store(V);
 		return 1;
 	}
 }
@@ -523,6 +636,14 @@ ATTR_HOT inline int matrix_solver_direct_t<m_N, _storage_N>::vsolve_non_dynamic(
 	for (unsigned i=0, iN=N(); i < iN; i++)
 		m_RHS[i] = m_last_RHS[i];
 
+	if (m_static_solver != NULL)
+	{
+		nl_double new_v[_storage_N];
+
+		m_static_solver(&m_A[0][0], m_RHS, new_v);
+		return this->store_checked(new_v, newton_raphson);
+	}
+
 	this->LE_solve();
 
 	return this->solve_non_dynamic(newton_raphson);
@@ -534,6 +655,7 @@ matrix_solver_direct_t<m_N, _storage_N>::matrix_solver_direct_t(const solver_par
 , m_dim(size)
 , m_lp_fact(0)
 {
+	m_static_solver = NULL;
 	m_terms = palloc_array(terms_t *, N());
 	m_rails_temp = palloc_array(terms_t, N());
 
@@ -551,6 +673,7 @@ matrix_solver_direct_t<m_N, _storage_N>::matrix_solver_direct_t(const eSolverTyp
 , m_dim(size)
 , m_lp_fact(0)
 {
+	m_static_solver = NULL;
 	m_terms = palloc_array(terms_t *, N());
 	m_rails_temp = palloc_array(terms_t, N());
 
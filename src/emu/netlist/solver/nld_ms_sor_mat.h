@@ -66,9 +66,9 @@ void matrix_solver_SOR_mat_t<m_N, _storage_N>::log_stats()
 		this->netlist().log("       has %s elements", this->is_dynamic() ? "dynamic" : "no dynamic");
 		this->netlist().log("       has %s elements", this->is_timestep() ? "timestep" : "no timestep");
 		this->netlist().log("       %6.3f average newton raphson loops", (double) this->m_stat_newton_raphson / (double) this->m_stat_vsolver_calls);
-		this->netlist().log("       %10d invocations (%6d Hz)  %10d gs fails (%6.2f%%) %6.3f average",
+		this->netlist().log("       %10d invocations (%6.0f Hz)  %10d gs fails (%6.2f%%) %6.3f average",
 				this->m_stat_calculations,
-				this->m_stat_calculations * 10 / (int) (this->netlist().time().as_double() * 10.0),
+				(double) this->m_stat_calculations / this->netlist().time().as_double(),
 				this->m_gs_fail,
 				100.0 * (double) this->m_gs_fail / (double) this->m_stat_calculations,
 				(double) this->m_gs_total / (double) this->m_stat_calculations);
@@ -0,0 +1,377 @@
+// license:GPL-2.0+
+// copyright-holders:Couriersud
+/*
+ * nld_ms_sparse.h
+ *
+ * Sparse LU solver.
+ *
+ * The structure of a net group's matrix never changes after setup. The
+ * nets are therefore reordered once using a minimum degree ordering,
+ * the fill-in of the LU decomposition is determined and the elimination
+ * is recorded as a list of operations on the compressed row format.
+ * Each time step then only assembles the matrix and replays the recorded
+ * operations. If the matrix did not change since the last decomposition,
+ * the factorisation is reused as is.
+ *
+ */
+
+#ifndef NLD_MS_SPARSE_H_
+#define NLD_MS_SPARSE_H_
+
+#include <algorithm>
+
+#include "../solver/mat_cr.h"
+#include "../solver/nld_ms_direct.h"
+#include "../solver/nld_solver.h"
+
+NETLIB_NAMESPACE_DEVICES_START()
+
+template <unsigned m_N, unsigned _storage_N>
+class matrix_solver_sparse_t: public matrix_solver_direct_t<m_N, _storage_N>
+{
+public:
+
+	matrix_solver_sparse_t(const solver_parameters_t *params, int size)
+		: matrix_solver_direct_t<m_N, _storage_N>(matrix_solver_t::GAUSSIAN_ELIMINATION, params, size)
+		, m_nz_A(0)
+		, m_factorised(false)
+		, m_stat_refactor(0)
+		{
+		}
+
+	virtual ~matrix_solver_sparse_t() {}
+
+	virtual void vsetup(analog_net_t::list_t &nets);
+	ATTR_HOT inline int vsolve_non_dynamic(const bool newton_raphson);
+
+	virtual void log_stats();
+
+	/* the net order differs from the one static solvers are generated for */
+	ATTR_COLD virtual pstring static_solver_code() { return ""; }
+
+protected:
+	ATTR_HOT virtual nl_double vsolve();
+
+private:
+	ATTR_COLD void order_nets(bool (*adj)[_storage_N]);
+	ATTR_COLD void analyse(bool (*adj)[_storage_N]);
+	ATTR_HOT void factorise();
+
+	mat_cr_t<_storage_N> m_mat;     /* structure of L + U, including fill-in */
+	plist_t<unsigned> m_term_cr[_storage_N];
+
+	/* the recorded elimination: for each element left of the diagonal, the
+	 * diagonal element it is divided by and the range of row updates
+	 */
+	plist_t<unsigned> m_elim_pos;
+	plist_t<unsigned> m_elim_pivot;
+	plist_t<unsigned> m_elim_ops_end;
+	plist_t<unsigned> m_ops_dst;
+	plist_t<unsigned> m_ops_src;
+
+	nl_double m_A[_storage_N * _storage_N];
+	nl_double m_A_fact[_storage_N * _storage_N];    /* matrix the current LU was computed from */
+	nl_double m_LU[_storage_N * _storage_N];
+
+	unsigned m_nz_A;                /* non-zero elements before fill-in */
+	bool m_factorised;
+	int m_stat_refactor;
+};
+
+// ----------------------------------------------------------------------------------------
+// matrix_solver - sparse LU
+// ----------------------------------------------------------------------------------------
+
+template <unsigned m_N, unsigned _storage_N>
+void matrix_solver_sparse_t<m_N, _storage_N>::vsetup(analog_net_t::list_t &nets)
+{
+	matrix_solver_direct_t<m_N, _storage_N>::vsetup(nets);
+	this->m_static_solver = NULL;
+
+	const unsigned iN = this->N();
+	bool adj[_storage_N][_storage_N];
+
+	/* conductance matrices are structurally symmetric */
+	m_nz_A = iN;
+	for (unsigned k = 0; k < iN; k++)
+	{
+		for (unsigned j = 0; j < iN; j++)
+			adj[k][j] = false;
+		const int *other = this->m_terms[k]->net_other();
+		for (unsigned i = 0; i < this->m_terms[k]->m_railstart; i++)
+			if (!adj[k][other[i]] && other[i] != k)
+			{
+				adj[k][other[i]] = true;
+				m_nz_A++;
+			}
+	}
+	for (unsigned k = 0; k < iN; k++)
+		for (unsigned j = 0; j < iN; j++)
+			adj[k][j] = adj[k][j] || adj[j][k];
+
+	order_nets(adj);
+	analyse(adj);
+
+	this->save(NLNAME(m_A_fact));
+	this->save(NLNAME(m_factorised));
+	this->save(NLNAME(m_stat_refactor));
+}
+
+/* Reorder the nets to reduce fill-in, using a minimum degree ordering on the
+ * elimination graph. Afterwards adj contains the structure of L + U.
+ */
+
+template <unsigned m_N, unsigned _storage_N>
+void matrix_solver_sparse_t<m_N, _storage_N>::order_nets(bool (*adj)[_storage_N])
+{
+	const unsigned iN = this->N();
+	bool eliminated[_storage_N];
+	unsigned order[_storage_N];
+
+	for (unsigned k = 0; k < iN; k++)
+		eliminated[k] = false;
+
+	for (unsigned step = 0; step < iN; step++)
+	{
+		/* pick the remaining net with the fewest remaining neighbours; ties keep the current order */
+		unsigned best = 0;
+		unsigned best_degree = iN + 1;
+		for (unsigned k = 0; k < iN; k++)
+			if (!eliminated[k])
+			{
+				unsigned degree = 0;
+				for (unsigned j = 0; j < iN; j++)
+					if (adj[k][j] && !eliminated[j])
+						degree++;
+				if (degree < best_degree)
+				{
+					best = k;
+					best_degree = degree;
+				}
+			}
+
+		/* eliminating it connects all its remaining neighbours */
+		order[step] = best;
+		eliminated[best] = true;
+		for (unsigned i = 0; i < iN; i++)
+			if (adj[best][i] && !eliminated[i])
+				for (unsigned j = 0; j < iN; j++)
+					if (adj[best][j] && !eliminated[j] && i != j)
+						adj[i][j] = true;
+	}
+
+	/* apply the permutation to the nets, the terms and the structure */
+	terms_t *terms[_storage_N];
+	analog_net_t *nets[_storage_N];
+	bool tmp[_storage_N][_storage_N];
+
+	for (unsigned k = 0; k < iN; k++)
+	{
+		terms[k] = this->m_terms[k];
+		nets[k] = this->m_nets[k];
+		for (unsigned j = 0; j < iN; j++)
+			tmp[k][j] = adj[k][j];
+	}
+	for (unsigned k = 0; k < iN; k++)
+	{
+		this->m_terms[k] = terms[order[k]];
+		this->m_nets[k] = nets[order[k]];
+		for (unsigned j = 0; j < iN; j++)
+			adj[k][j] = tmp[order[k]][order[j]];
+	}
+
+	for (unsigned k = 0; k < iN; k++)
+	{
+		int *other = this->m_terms[k]->net_other();
+		for (unsigned i = 0; i < this->m_terms[k]->count(); i++)
+			if (other[i] != -1)
+				other[i] = this->get_net_idx(&this->m_terms[k]->terms()[i]->m_otherterm->net());
+	}
+}
+
+/* Build the compressed row structure of L + U and record the elimination
+ * as a list of operations on it.
+ */
+
+template <unsigned m_N, unsigned _storage_N>
+void matrix_solver_sparse_t<m_N, _storage_N>::analyse(bool (*adj)[_storage_N])
+{
+	const unsigned iN = this->N();
+	unsigned nz = 0;
+
+	for (unsigned k = 0; k < iN; k++)
+	{
+		m_mat.ia[k] = nz;
+		for (unsigned j = 0; j < iN; j++)
+			if (adj[k][j] || j == k)
+			{
+				if (j == k)
+					m_mat.diag[k] = nz;
+				m_mat.ja[nz++] = j;
+			}
+
+		/* pointers into the compressed row format matrix for each terminal */
+		m_term_cr[k].clear();
+		const int *other = this->m_terms[k]->net_other();
+		for (unsigned i = 0; i < this->m_terms[k]->m_railstart; i++)
+			for (unsigned p = m_mat.ia[k]; p < nz; p++)
+				if (m_mat.ja[p] == other[i])
+				{
+					m_term_cr[k].add(p);
+					break;
+				}
+		nl_assert(m_term_cr[k].size() == this->m_terms[k]->m_railstart);
+	}
+	m_mat.ia[iN] = nz;
+	m_mat.nz_num = nz;
+
+	/* row i is updated with each row k < i it has an element in; the
+	 * fill-in guarantees every element of row k right of the diagonal
+	 * has a partner in row i
+	 */
+	m_elim_pos.clear();
+	m_elim_pivot.clear();
+	m_elim_ops_end.clear();
+	m_ops_dst.clear();
+	m_ops_src.clear();
+
+	unsigned colpos[_storage_N];
+	for (unsigned i = 0; i < iN; i++)
+	{
+		for (unsigned p = m_mat.ia[i]; p < m_mat.ia[i + 1]; p++)
+			colpos[m_mat.ja[p]] = p;
+
+		for (unsigned pk = m_mat.ia[i]; pk < m_mat.diag[i]; pk++)
+		{
+			const unsigned k = m_mat.ja[pk];
+			m_elim_pos.add(pk);
+			m_elim_pivot.add(m_mat.diag[k]);
+			for (unsigned pj = m_mat.diag[k] + 1; pj < m_mat.ia[k + 1]; pj++)
+			{
+				m_ops_dst.add(colpos[m_mat.ja[pj]]);
+				m_ops_src.add(pj);
+			}
+			m_elim_ops_end.add(m_ops_dst.size());
+		}
+	}
+
+	for (unsigned k = 0; k < nz; k++)
+		m_A_fact[k] = 0.0;
+	m_factorised = false;
+}
+
+template <unsigned m_N, unsigned _storage_N>
+ATTR_HOT void matrix_solver_sparse_t<m_N, _storage_N>::factorise()
+{
+	const unsigned nz = m_mat.nz_num;
+	const unsigned elim_count = m_elim_pos.size();
+	const unsigned * RESTRICT elim_pos = m_elim_pos.data();
+	const unsigned * RESTRICT elim_pivot = m_elim_pivot.data();
+	const unsigned * RESTRICT elim_ops_end = m_elim_ops_end.data();
+	const unsigned * RESTRICT ops_dst = m_ops_dst.data();
+	const unsigned * RESTRICT ops_src = m_ops_src.data();
+	nl_double * RESTRICT LU = m_LU;
+
+	for (unsigned k = 0; k < nz; k++)
+		LU[k] = m_A_fact[k] = m_A[k];
+
+	unsigned op = 0;
+	for (unsigned e = 0; e < elim_count; e++)
+	{
+		const unsigned pk = elim_pos[e];
+		const nl_double f = LU[pk] = LU[pk] / LU[elim_pivot[e]];
+		for (const unsigned end = elim_ops_end[e]; op < end; op++)
+			LU[ops_dst[op]] -= f * LU[ops_src[op]];
+	}
+
+	m_factorised = true;
+	m_stat_refactor++;
+}
+
+template <unsigned m_N, unsigned _storage_N>
+ATTR_HOT nl_double matrix_solver_sparse_t<m_N, _storage_N>::vsolve()
+{
+	this->solve_base(this);
+	return this->compute_next_timestep();
+}
+
+template <unsigned m_N, unsigned _storage_N>
+ATTR_HOT inline int matrix_solver_sparse_t<m_N, _storage_N>::vsolve_non_dynamic(const bool newton_raphson)
+{
+	const unsigned iN = this->N();
+	const unsigned nz = m_mat.nz_num;
+
+	ATTR_ALIGN nl_double new_V[_storage_N];
+
+	for (unsigned k = 0; k < nz; k++)
+		m_A[k] = 0.0;
+
+	for (unsigned k = 0; k < iN; k++)
+	{
+		nl_double gtot_t = 0.0;
+		nl_double RHS_t = 0.0;
+
+		const unsigned term_count = this->m_terms[k]->count();
+		const unsigned railstart = this->m_terms[k]->m_railstart;
+		const nl_double * const RESTRICT gt = this->m_terms[k]->gt();
+		const nl_double * const RESTRICT go = this->m_terms[k]->go();
+		const nl_double * const RESTRICT Idr = this->m_terms[k]->Idr();
+		const nl_double * const * RESTRICT other_cur_analog = this->m_terms[k]->other_curanalog();
+		const unsigned * const RESTRICT term_cr = m_term_cr[k].data();
+
+		for (unsigned i = 0; i < term_count; i++)
+		{
+			gtot_t = gtot_t + gt[i];
+			RHS_t = RHS_t + Idr[i];
+		}
+
+		for (unsigned i = railstart; i < term_count; i++)
+			RHS_t = RHS_t + go[i] * *other_cur_analog[i];
+
+		new_V[k] = RHS_t;
+
+		m_A[m_mat.diag[k]] = gtot_t;
+
+		for (unsigned i = 0; i < railstart; i++)
+			m_A[term_cr[i]] -= go[i];
+	}
+
+	/* linear nets with a fixed time step keep the same matrix */
+	if (!m_factorised || memcmp(m_A, m_A_fact, nz * sizeof(m_A[0])) != 0)
+		factorise();
+
+	m_mat.solveLUx(m_LU, new_V);
+
+	this->m_stat_calculations++;
+
+	if (newton_raphson)
+	{
+		nl_double err = this->delta(new_V);
+
+		this->store(new_V);
+
+		return (err > this->m_params.m_accuracy) ? 2 : 1;
+	}
+	else
+	{
+		this->store(new_V);
+		return 1;
+	}
+}
+
+template <unsigned m_N, unsigned _storage_N>
+void matrix_solver_sparse_t<m_N, _storage_N>::log_stats()
+{
+	matrix_solver_direct_t<m_N, _storage_N>::log_stats();
+	if (this->m_stat_calculations != 0 && this->m_params.m_log_stats)
+	{
+		this->netlist().log("       %d non-zero elements, %d after fill-in, %d elimination operations",
+				m_nz_A, m_mat.nz_num, (unsigned) m_ops_dst.size());
+		this->netlist().log("       %10d refactorisations (%6.2f%% of invocations)",
+				m_stat_refactor, 100.0 * (double) m_stat_refactor / (double) this->m_stat_calculations);
+	}
+}
+
+NETLIB_NAMESPACE_DEVICES_END()
+
+#endif /* NLD_MS_SPARSE_H_ */
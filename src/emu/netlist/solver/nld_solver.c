@@ -35,6 +35,7 @@
 #include "nld_ms_sor.h"
 #include "nld_ms_sor_mat.h"
 #include "nld_ms_gmres.h"
+#include "nld_ms_sparse.h"
 //#include "nld_twoterm.h"
 #include "../nl_lists.h"
 
@@ -89,8 +90,12 @@ ATTR_COLD matrix_solver_t::matrix_solver_t(const eSolverType type, const solver_
 	m_stat_vsolver_calls(0),
 	m_iterative_fail(0),
 	m_iterative_total(0),
+	m_stat_time(0),
 	m_params(*params),
 	m_cur_ts(0),
+	m_independent(true),
+	m_solved(false),
+	m_nr_exceeded(false),
 	m_type(type)
 {
 }
@@ -259,12 +264,9 @@ void matrix_solver_t::solve_base(C *p)
 		} while (this_resched > 1 && newton_loops < m_params.m_nr_loops);
 
 		m_stat_newton_raphson += newton_loops;
-		// reschedule ....
-		if (this_resched > 1 && !m_Q_sync.net().is_queued())
-		{
-			netlist().warning("NEWTON_LOOPS exceeded ... reschedule");
-			m_Q_sync.net().reschedule_in_queue(m_params.m_nt_sync_delay);
-		}
+		// reschedule in solve_sync ....
+		if (this_resched > 1)
+			m_nr_exceeded = true;
 	}
 	else
 	{
@@ -272,7 +274,7 @@ void matrix_solver_t::solve_base(C *p)
 	}
 }
 
-ATTR_HOT nl_double matrix_solver_t::solve()
+ATTR_HOT nl_double matrix_solver_t::solve_nosync()
 {
 	const netlist_time now = netlist().time();
 	const netlist_time delta = now - m_last_step;
@@ -289,12 +291,94 @@ ATTR_HOT nl_double matrix_solver_t::solve()
 
 	step(delta);
 
+#if (NL_KEEP_STATISTICS)
+	const pticks_t start = pticks();
+	const nl_double next_time_step = vsolve();
+	m_stat_time += pticks() - start;
+#else
 	const nl_double next_time_step = vsolve();
+#endif
+
+	m_solved = true;
+	return next_time_step;
+}
+
+ATTR_HOT void matrix_solver_t::solve_sync()
+{
+	if (!m_solved)
+		return;
+	m_solved = false;
+
+	if (m_nr_exceeded)
+	{
+		m_nr_exceeded = false;
+		if (!m_Q_sync.net().is_queued())
+		{
+			netlist().warning("NEWTON_LOOPS exceeded ... reschedule");
+			m_Q_sync.net().reschedule_in_queue(m_params.m_nt_sync_delay);
+		}
+	}
 
 	update_inputs();
+}
+
+ATTR_HOT nl_double matrix_solver_t::solve()
+{
+	const nl_double next_time_step = solve_nosync();
+
+	solve_sync();
 	return next_time_step;
 }
 
+/* Devices couple the solvers their terminals and inputs are connected to:
+ * the inputs updated by one solver change the terminals the other one
+ * solves, e.g. a 4066 switch controlled by an RC network. Sub devices are
+ * counted with their parent device, "SW.A.R" belongs to "SW".
+ */
+
+ATTR_COLD void matrix_solver_t::add_device(const core_device_t &dev)
+{
+	const core_device_t *top = &dev;
+	const pnamedlist_t<device_t *> &devs = netlist().m_devices;
+	for (std::size_t i = 0; i < devs.size(); i++)
+		if (devs[i]->name().len() < top->name().len() && dev.name().startsWith(devs[i]->name() + "."))
+			top = devs[i];
+	if (!m_devices.contains(top))
+		m_devices.add(top);
+}
+
+ATTR_COLD void matrix_solver_t::find_dependencies(const list_t &solvers)
+{
+	m_devices.clear();
+	for (std::size_t k = 0; k < m_nets.size(); k++)
+	{
+		analog_net_t *net = m_nets[k];
+		for (std::size_t i = 0; i < net->m_core_terms.size(); i++)
+			add_device(net->m_core_terms[i]->netdev());
+	}
+	// inputs are connected to the proxy nets
+	for (std::size_t k = 0; k < m_inps.size(); k++)
+	{
+		net_t &net = m_inps[k]->net();
+		for (std::size_t i = 0; i < net.m_core_terms.size(); i++)
+			add_device(net.m_core_terms[i]->netdev());
+	}
+
+	// each pair is checked once, by the second solver in the list
+	for (std::size_t i = 0; i < solvers.size() && solvers[i] != this; i++)
+	{
+		matrix_solver_t *other = solvers[i];
+		for (std::size_t k = 0; k < m_devices.size(); k++)
+			if (other->m_devices.contains(m_devices[k]))
+			{
+				netlist().log("%s and %s coupled by %s", other->name().cstr(), name().cstr(), m_devices[k]->name().cstr());
+				m_independent = false;
+				other->m_independent = false;
+				break;
+			}
+	}
+}
+
 
 // ----------------------------------------------------------------------------------------
 // matrix_solver - Direct base
@@ -334,7 +418,10 @@ NETLIB_START(solver)
 	register_param("GS_LOOPS", m_gs_loops, 9);              // Gauss-Seidel loops
 	register_param("GS_THRESHOLD", m_gs_threshold, 6);      // below this value, gaussian elimination is used
 	register_param("NR_LOOPS", m_nr_loops, 250);            // Newton-Raphson loops
-	register_param("PARALLEL", m_parallel, 0);
+	register_param("SPARSE_THRESHOLD", m_sparse_threshold, 16); // from this size on, sparse groups use sparse LU, 0 to disable
+	register_param("SPARSE_FILL", m_sparse_fill, 0.3);      // maximum ratio of non-zero matrix elements for sparse LU
+	register_param("PARALLEL", m_parallel, 0);              // solve independent groups on a worker pool
+	register_param("PARALLEL_THRESHOLD", m_parallel_threshold, 8); // groups smaller than this are solved on the caller
 	register_param("SOR_FACTOR", m_sor, 1.059);
 	register_param("GMIN", m_gmin, NETLIST_GMIN_DEFAULT);
 	register_param("DYNAMIC_TS", m_dynamic, 0);
@@ -366,53 +453,89 @@ NETLIB_STOP(solver)
 {
 	for (std::size_t i = 0; i < m_mat_solvers.size(); i++)
 		m_mat_solvers[i]->log_stats();
+
+#if (NL_KEEP_STATISTICS)
+	if (m_params.m_log_stats)
+	{
+		const pticks_t total = stat_time();
+
+		netlist().log("==============================================");
+		netlist().log("Solver time per group");
+		for (std::size_t i = 0; i < m_mat_solvers.size(); i++)
+		{
+			matrix_solver_t *ms = m_mat_solvers[i];
+			netlist().log("   %-30s %4d nets %10.3f ms %6.2f%%  %s", ms->name().cstr(), (unsigned) ms->size(),
+					1000.0 * (double) ms->stat_time() / (double) pticks_per_second(),
+					total ? 100.0 * (double) ms->stat_time() / (double) total : 0.0,
+					m_par_solvers.contains(ms) ? "parallel" : "");
+		}
+	}
+#endif
+}
+
+ATTR_COLD pticks_t NETLIB_NAME(solver)::stat_time() const
+{
+	pticks_t total = 0;
+	for (std::size_t i = 0; i < m_mat_solvers.size(); i++)
+		total += m_mat_solvers[i]->stat_time();
+	return total;
 }
 
 NETLIB_NAME(solver)::~NETLIB_NAME(solver)()
 {
+#if !(PSTANDALONE)
+	if (m_queue != NULL)
+		osd_work_queue_free(m_queue);
+#endif
 	m_mat_solvers.clear_and_free();
 }
 
+#if !(PSTANDALONE)
+static void *solver_work(void *param, int threadid)
+{
+	matrix_solver_t *ms = *(matrix_solver_t **) param;
+
+	ms->solve_nosync();
+	return NULL;
+}
+#endif
+
 NETLIB_UPDATE(solver)
 {
 	if (m_params.m_dynamic)
 		return;
 
-	const std::size_t t_cnt = m_mat_solvers.size();
+	/* Solvers on the worker pool only touch their own nets. Their outputs
+	 * are updated afterwards in a fixed order so results don't depend on
+	 * thread timing.
+	 */
+	const std::size_t p_cnt = m_par_solvers.size();
 
-#if HAS_OPENMP && USE_OPENMP
-	if (m_parallel.Value())
+	if (p_cnt > 0)
 	{
-		omp_set_num_threads(3);
-		//omp_set_dynamic(0);
-		#pragma omp parallel
-		{
-			#pragma omp for
-			for (int i = 0; i <  t_cnt; i++)
-				if (m_mat_solvers[i]->is_timestep())
-				{
-					// Ignore return value
-					ATTR_UNUSED const nl_double ts = m_mat_solvers[i]->solve();
-				}
-		}
+#if HAS_OPENMP && USE_OPENMP
+		#pragma omp parallel for schedule(dynamic)
+		for (int i = 0; i < (int) p_cnt; i++)
+			m_par_solvers[i]->solve_nosync();
+#elif !(PSTANDALONE)
+		osd_work_item_queue_multiple(m_queue, solver_work, p_cnt, m_par_solvers.data(), sizeof(matrix_solver_t *), WORK_ITEM_FLAG_AUTO_RELEASE);
+#endif
 	}
-	else
-		for (int i = 0; i < t_cnt; i++)
-			if (m_mat_solvers[i]->is_timestep())
-			{
-				// Ignore return value
-				ATTR_UNUSED const nl_double ts = m_mat_solvers[i]->solve();
-			}
-#else
-	for (std::size_t i = 0; i < t_cnt; i++)
+
+	for (std::size_t i = 0; i < m_seq_solvers.size(); i++)
 	{
-		if (m_mat_solvers[i]->is_timestep())
-		{
-			// Ignore return value
-			ATTR_UNUSED const nl_double ts = m_mat_solvers[i]->solve();
-		}
+		// Ignore return value
+		ATTR_UNUSED const nl_double ts = m_seq_solvers[i]->solve();
 	}
+
+	if (p_cnt > 0)
+	{
+#if !(HAS_OPENMP && USE_OPENMP) && !(PSTANDALONE)
+		osd_work_queue_wait(m_queue, osd_ticks_per_second() * 10);
 #endif
+		for (std::size_t i = 0; i < p_cnt; i++)
+			m_par_solvers[i]->solve_sync();
+	}
 
 	/* step circuit */
 	if (!m_Q_step.net().is_queued())
@@ -422,12 +545,17 @@ NETLIB_UPDATE(solver)
 }
 
 template <int m_N, int _storage_N>
-matrix_solver_t * NETLIB_NAME(solver)::create_solver(int size, const bool use_specific)
+matrix_solver_t * NETLIB_NAME(solver)::create_solver(int size, const bool use_specific, const bool use_sparse)
 {
 	if (use_specific && m_N == 1)
 		return palloc(matrix_solver_direct1_t, &m_params);
 	else if (use_specific && m_N == 2)
 		return palloc(matrix_solver_direct2_t, &m_params);
+	else if (use_sparse)
+	{
+		typedef matrix_solver_sparse_t<m_N,_storage_N> solver_sparse;
+		return palloc(solver_sparse, &m_params, size);
+	}
 	else
 	{
 		if (size >= m_gs_threshold)
@@ -461,6 +589,44 @@ matrix_solver_t * NETLIB_NAME(solver)::create_solver(int size, const bool use_sp
 	}
 }
 
+/* ratio of non-zero elements in the matrix of a net group */
+
+static nl_double matrix_fill(analog_net_t::list_t &nets)
+{
+	const std::size_t n = nets.size();
+	std::size_t nz = n;
+
+	for (std::size_t k = 0; k < n; k++)
+	{
+		plist_t<net_t *> others;
+		for (std::size_t i = 0; i < nets[k]->m_core_terms.size(); i++)
+		{
+			core_terminal_t *p = nets[k]->m_core_terms[i];
+			if (p->type() == terminal_t::TERMINAL)
+			{
+				net_t *other = &dynamic_cast<terminal_t *>(p)->m_otherterm->net();
+				if (other != nets[k] && nets.contains(static_cast<analog_net_t *>(other)) && !others.contains(other))
+					others.add(other);
+			}
+		}
+		nz += others.size();
+	}
+	return (nl_double) nz / (nl_double) (n * n);
+}
+
+ATTR_COLD pstring NETLIB_NAME(solver)::create_static_solvers()
+{
+	pstring code = "";
+
+	for (std::size_t i = 0; i < m_mat_solvers.size(); i++)
+	{
+		/* groups of one and two nets have specific solvers already */
+		if (m_mat_solvers[i]->size() > 2)
+			code += m_mat_solvers[i]->static_solver_code();
+	}
+	return code;
+}
+
 ATTR_COLD void NETLIB_NAME(solver)::post_start()
 {
 	analog_net_t::list_t groups[256];
@@ -517,56 +683,58 @@ ATTR_COLD void NETLIB_NAME(solver)::post_start()
 	{
 		matrix_solver_t *ms;
 		std::size_t net_count = groups[i].size();
+		const bool use_sparse = m_sparse_threshold.Value() > 0 && net_count >= m_sparse_threshold.Value()
+				&& matrix_fill(groups[i]) <= m_sparse_fill.Value();
 
 		switch (net_count)
 		{
 			case 1:
-				ms = create_solver<1,1>(1, use_specific);
+				ms = create_solver<1,1>(1, use_specific, use_sparse);
 				break;
 			case 2:
-				ms = create_solver<2,2>(2, use_specific);
+				ms = create_solver<2,2>(2, use_specific, use_sparse);
 				break;
 			case 3:
-				ms = create_solver<3,3>(3, use_specific);
+				ms = create_solver<3,3>(3, use_specific, use_sparse);
 				break;
 			case 4:
-				ms = create_solver<4,4>(4, use_specific);
+				ms = create_solver<4,4>(4, use_specific, use_sparse);
 				break;
 			case 5:
-				ms = create_solver<5,5>(5, use_specific);
+				ms = create_solver<5,5>(5, use_specific, use_sparse);
 				break;
 			case 6:
-				ms = create_solver<6,6>(6, use_specific);
+				ms = create_solver<6,6>(6, use_specific, use_sparse);
 				break;
 			case 7:
-				ms = create_solver<7,7>(7, use_specific);
+				ms = create_solver<7,7>(7, use_specific, use_sparse);
 				break;
 			case 8:
-				ms = create_solver<8,8>(8, use_specific);
+				ms = create_solver<8,8>(8, use_specific, use_sparse);
 				break;
 			case 12:
-				ms = create_solver<12,12>(12, use_specific);
+				ms = create_solver<12,12>(12, use_specific, use_sparse);
 				break;
 			case 87:
-				ms = create_solver<87,87>(87, use_specific);
+				ms = create_solver<87,87>(87, use_specific, use_sparse);
 				break;
 			default:
 				if (net_count <= 16)
 				{
-					ms = create_solver<0,16>(net_count, use_specific);
+					ms = create_solver<0,16>(net_count, use_specific, use_sparse);
 				}
 				else if (net_count <= 32)
 				{
-					ms = create_solver<0,32>(net_count, use_specific);
+					ms = create_solver<0,32>(net_count, use_specific, use_sparse);
 				}
 				else if (net_count <= 64)
 				{
-					ms = create_solver<0,64>(net_count, use_specific);
+					ms = create_solver<0,64>(net_count, use_specific, use_sparse);
 				}
 				else
 					if (net_count <= 128)
 				{
-					ms = create_solver<0,128>(net_count, use_specific);
+					ms = create_solver<0,128>(net_count, use_specific, use_sparse);
 				}
 				else
 				{
@@ -598,6 +766,29 @@ ATTR_COLD void NETLIB_NAME(solver)::post_start()
 			}
 		}
 	}
+
+	// split the time step solvers between the worker pool and the caller
+	for (std::size_t i = 0; i < m_mat_solvers.size(); i++)
+		m_mat_solvers[i]->find_dependencies(m_mat_solvers);
+
+	for (std::size_t i = 0; i < m_mat_solvers.size(); i++)
+	{
+		matrix_solver_t *ms = m_mat_solvers[i];
+		if (!ms->is_timestep())
+			continue;
+#if (HAS_OPENMP && USE_OPENMP) || !(PSTANDALONE)
+		if (m_parallel.Value() && ms->is_independent() && ms->size() >= m_parallel_threshold.Value())
+			m_par_solvers.add(ms);
+		else
+#endif
+			m_seq_solvers.add(ms);
+	}
+
+#if !(HAS_OPENMP && USE_OPENMP) && !(PSTANDALONE)
+	if (m_par_solvers.size() > 0)
+		m_queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI | WORK_QUEUE_FLAG_HIGH_FREQ);
+#endif
+	netlist().log("%" SIZETFMT " of %" SIZETFMT " time step solvers on the worker pool", m_par_solvers.size(), m_par_solvers.size() + m_seq_solvers.size());
 }
 
 NETLIB_NAMESPACE_DEVICES_END()
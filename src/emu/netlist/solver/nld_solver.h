@@ -50,6 +50,35 @@ struct solver_parameters_t
 };
 
 
+// ----------------------------------------------------------------------------------------
+// static solvers
+// ----------------------------------------------------------------------------------------
+
+/* Straight-line solvers for fixed net group topologies, generated by
+ * "nltool -c static" and compiled into nld_static_solvers.c. Each one
+ * registers itself under the hash of the topology it was generated for.
+ * The solver receives the assembled matrix and right hand side and
+ * returns the solution in V.
+ */
+
+typedef void (*static_solver_func)(nl_double * RESTRICT A, nl_double * RESTRICT RHS, nl_double * RESTRICT V);
+
+class static_solver_t
+{
+	NETLIST_PREVENT_COPYING(static_solver_t)
+public:
+	ATTR_COLD static_solver_t(const char *hash, static_solver_func func);
+
+	ATTR_COLD static static_solver_func find(const pstring &hash);
+
+private:
+	const char *m_hash;
+	static_solver_func m_func;
+	static_solver_t *m_next;
+
+	static static_solver_t *s_first;
+};
+
 class terms_t
 {
 	NETLIST_PREVENT_COPYING(terms_t)
@@ -116,6 +145,18 @@ public:
 
 	ATTR_HOT nl_double solve();
 
+	/* solve() split in two: solve_nosync only touches the nets of this
+	 * solver and may run concurrently with other independent solvers,
+	 * solve_sync updates outputs and the queue.
+	 */
+	ATTR_HOT nl_double solve_nosync();
+	ATTR_HOT void solve_sync();
+
+	/* clear is_independent() of this and all earlier solvers in the list
+	 * sharing a device with it, call in list order
+	 */
+	ATTR_COLD void find_dependencies(const list_t &solvers);
+
 	ATTR_HOT inline bool is_dynamic() { return m_dynamic_devices.size() > 0; }
 	ATTR_HOT inline bool is_timestep() { return m_step_devices.size() > 0; }
 
@@ -133,6 +174,12 @@ public:
 	ATTR_COLD int get_net_idx(net_t *net);
 
 	inline eSolverType type() const { return m_type; }
+	inline std::size_t size() const { return m_nets.size(); }
+	inline bool is_independent() const { return m_independent; }
+	inline pticks_t stat_time() const { return m_stat_time; }
+
+	/* code for a static solver of this topology, empty if not supported */
+	ATTR_COLD virtual pstring static_solver_code() { return ""; }
 
 	virtual void log_stats()
 	{
@@ -144,12 +191,17 @@ public:
 			this->netlist().log("       has %s elements", this->is_dynamic() ? "dynamic" : "no dynamic");
 			this->netlist().log("       has %s elements", this->is_timestep() ? "timestep" : "no timestep");
 			this->netlist().log("       %6.3f average newton raphson loops", (double) this->m_stat_newton_raphson / (double) this->m_stat_vsolver_calls);
-			this->netlist().log("       %10d invocations (%6d Hz)  %10d gs fails (%6.2f%%) %6.3f average",
+			this->netlist().log("       %10d invocations (%6.0f Hz)  %10d gs fails (%6.2f%%) %6.3f average",
 					this->m_stat_calculations,
-					this->m_stat_calculations * 10 / (int) (this->netlist().time().as_double() * 10.0),
+					(double) this->m_stat_calculations / this->netlist().time().as_double(),
 					this->m_iterative_fail,
 					100.0 * (double) this->m_iterative_fail / (double) this->m_stat_calculations,
 					(double) this->m_iterative_total / (double) this->m_stat_calculations);
+#if (NL_KEEP_STATISTICS)
+			this->netlist().log("       %10.3f ms solving  %8.3f us average",
+					1000.0 * (double) this->m_stat_time / (double) pticks_per_second(),
+					1000000.0 * (double) this->m_stat_time / (double) pticks_per_second() / (double) this->m_stat_vsolver_calls);
+#endif
 		}
 	}
 
@@ -172,6 +224,7 @@ protected:
 	int m_stat_vsolver_calls;
 	int m_iterative_fail;
 	int m_iterative_total;
+	pticks_t m_stat_time;
 
 	const solver_parameters_t &m_params;
 
@@ -189,6 +242,12 @@ private:
 	ATTR_HOT void step(const netlist_time delta);
 
 	ATTR_HOT void update_inputs();
+	ATTR_COLD void add_device(const core_device_t &dev);
+
+	plist_t<const core_device_t *> m_devices;  /* devices connected, for find_dependencies */
+	bool m_independent;     /* outputs don't drive other solvers and vice versa */
+	bool m_solved;          /* solve_nosync done, solve_sync pending */
+	bool m_nr_exceeded;
 
 	const eSolverType m_type;
 };
@@ -199,7 +258,12 @@ class NETLIB_NAME(solver) : public device_t
 {
 public:
 	NETLIB_NAME(solver)()
-	: device_t()    { }
+	: device_t()
+	{
+#if !(PSTANDALONE)
+		m_queue = NULL;
+#endif
+	}
 
 	virtual ~NETLIB_NAME(solver)();
 
@@ -208,6 +272,12 @@ public:
 
 	ATTR_HOT inline nl_double gmin() { return m_gmin.Value(); }
 
+	ATTR_COLD pstring create_static_solvers();
+
+	/* time spent in all net groups */
+	ATTR_COLD pticks_t stat_time() const;
+	ATTR_COLD std::size_t group_count() const { return m_mat_solvers.size(); }
+
 protected:
 	ATTR_HOT void update();
 	ATTR_HOT void start();
@@ -230,17 +300,26 @@ protected:
 	param_int_t m_nr_loops;
 	param_int_t m_gs_loops;
 	param_int_t m_gs_threshold;
+	param_int_t m_sparse_threshold;
+	param_double_t m_sparse_fill;
 	param_int_t m_parallel;
+	param_int_t m_parallel_threshold;
 
 	param_logic_t  m_log_stats;
 
 	matrix_solver_t::list_t m_mat_solvers;
 private:
 
+	matrix_solver_t::list_t m_par_solvers;  /* time step solvers run on the worker pool */
+	matrix_solver_t::list_t m_seq_solvers;  /* time step solvers run in order on the caller */
+#if !(PSTANDALONE)
+	osd_work_queue *m_queue;
+#endif
+
 	solver_parameters_t m_params;
 
 	template <int m_N, int _storage_N>
-	matrix_solver_t *create_solver(int size, bool use_specific);
+	matrix_solver_t *create_solver(int size, bool use_specific, bool use_sparse);
 };
 
 NETLIB_NAMESPACE_DEVICES_END()
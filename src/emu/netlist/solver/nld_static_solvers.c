@@ -0,0 +1,494 @@
+// license:GPL-2.0+
+// copyright-holders:Couriersud
+/*
+ * nld_static_solvers.c
+ *
+ * Static solvers for known net group topologies.
+ *
+ * The code below the marker is generated by
+ *
+ *      nltool -c static -f <netlist>
+ *
+ * for each net group solved by gaussian elimination. Append the output
+ * for further netlists; solvers with the same hash only need to be
+ * present once. A net group uses the static solver if the hash of its
+ * topology matches at startup and falls back to the generic code
+ * otherwise, e.g. after the netlist was changed.
+ *
+ */
+
+#include "nld_solver.h"
+
+NETLIB_NAMESPACE_DEVICES_START()
+
+// ----------------------------------------------------------------------------------------
+// static_solver_t
+// ----------------------------------------------------------------------------------------
+
+static_solver_t *static_solver_t::s_first = NULL;
+
+ATTR_COLD static_solver_t::static_solver_t(const char *hash, static_solver_func func)
+: m_hash(hash), m_func(func), m_next(s_first)
+{
+	s_first = this;
+}
+
+ATTR_COLD static_solver_func static_solver_t::find(const pstring &hash)
+{
+	for (static_solver_t *p = s_first; p != NULL; p = p->m_next)
+		if (hash.equals(p->m_hash))
+			return p->m_func;
+	return NULL;
+}
+
+// ----------------------------------------------------------------------------------------
+// generated code
+// ----------------------------------------------------------------------------------------
+
+// generated by nltool from nl_examples/kidniki.c
+
+// netlist.Solver.Solver_0: 14 nets
+static void nl_gcr_14f0bc2da643c1df(nl_double * RESTRICT A, nl_double * RESTRICT RHS, nl_double * RESTRICT V)
+{
+	nl_double f, f1;
+	f = 1.0 / A[0];
+	f1 = -A[16] * f;
+	A[17] += A[1] * f1;
+	RHS[1] += RHS[0] * f1;
+	f = 1.0 / A[17];
+	f1 = -A[33] * f;
+	A[34] += A[18] * f1;
+	A[35] += A[19] * f1;
+	A[36] += A[20] * f1;
+	A[45] += A[29] * f1;
+	RHS[2] += RHS[1] * f1;
+	f1 = -A[49] * f;
+	A[50] += A[18] * f1;
+	A[51] += A[19] * f1;
+	A[52] += A[20] * f1;
+	A[61] += A[29] * f1;
+	RHS[3] += RHS[1] * f1;
+	f1 = -A[65] * f;
+	A[66] += A[18] * f1;
+	A[67] += A[19] * f1;
+	A[68] += A[20] * f1;
+	A[77] += A[29] * f1;
+	RHS[4] += RHS[1] * f1;
+	f1 = -A[209] * f;
+	A[210] += A[18] * f1;
+	A[211] += A[19] * f1;
+	A[212] += A[20] * f1;
+	A[221] += A[29] * f1;
+	RHS[13] += RHS[1] * f1;
+	f = 1.0 / A[34];
+	f1 = -A[50] * f;
+	A[51] += A[35] * f1;
+	A[52] += A[36] * f1;
+	A[61] += A[45] * f1;
+	RHS[3] += RHS[2] * f1;
+	f1 = -A[66] * f;
+	A[67] += A[35] * f1;
+	A[68] += A[36] * f1;
+	A[77] += A[45] * f1;
+	RHS[4] += RHS[2] * f1;
+	f1 = -A[210] * f;
+	A[211] += A[35] * f1;
+	A[212] += A[36] * f1;
+	A[221] += A[45] * f1;
+	RHS[13] += RHS[2] * f1;
+	f = 1.0 / A[51];
+	f1 = -A[67] * f;
+	A[68] += A[52] * f1;
+	A[77] += A[61] * f1;
+	RHS[4] += RHS[3] * f1;
+	f1 = -A[211] * f;
+	A[212] += A[52] * f1;
+	A[221] += A[61] * f1;
+	RHS[13] += RHS[3] * f1;
+	f = 1.0 / A[68];
+	f1 = -A[84] * f;
+	A[85] += A[69] * f1;
+	A[86] += A[70] * f1;
+	A[87] += A[71] * f1;
+	A[93] += A[77] * f1;
+	RHS[5] += RHS[4] * f1;
+	f1 = -A[100] * f;
+	A[101] += A[69] * f1;
+	A[102] += A[70] * f1;
+	A[103] += A[71] * f1;
+	A[109] += A[77] * f1;
+	RHS[6] += RHS[4] * f1;
+	f1 = -A[116] * f;
+	A[117] += A[69] * f1;
+	A[118] += A[70] * f1;
+	A[119] += A[71] * f1;
+	A[125] += A[77] * f1;
+	RHS[7] += RHS[4] * f1;
+	f1 = -A[212] * f;
+	A[213] += A[69] * f1;
+	A[214] += A[70] * f1;
+	A[215] += A[71] * f1;
+	A[221] += A[77] * f1;
+	RHS[13] += RHS[4] * f1;
+	f = 1.0 / A[85];
+	f1 = -A[101] * f;
+	A[102] += A[86] * f1;
+	A[103] += A[87] * f1;
+	A[109] += A[93] * f1;
+	RHS[6] += RHS[5] * f1;
+	f1 = -A[117] * f;
+	A[118] += A[86] * f1;
+	A[119] += A[87] * f1;
+	A[125] += A[93] * f1;
+	RHS[7] += RHS[5] * f1;
+	f1 = -A[213] * f;
+	A[214] += A[86] * f1;
+	A[215] += A[87] * f1;
+	A[221] += A[93] * f1;
+	RHS[13] += RHS[5] * f1;
+	f = 1.0 / A[102];
+	f1 = -A[118] * f;
+	A[119] += A[103] * f1;
+	A[125] += A[109] * f1;
+	RHS[7] += RHS[6] * f1;
+	f1 = -A[214] * f;
+	A[215] += A[103] * f1;
+	A[221] += A[109] * f1;
+	RHS[13] += RHS[6] * f1;
+	f = 1.0 / A[119];
+	f1 = -A[135] * f;
+	A[136] += A[120] * f1;
+	A[141] += A[125] * f1;
+	RHS[8] += RHS[7] * f1;
+	f1 = -A[215] * f;
+	A[216] += A[120] * f1;
+	A[221] += A[125] * f1;
+	RHS[13] += RHS[7] * f1;
+	f = 1.0 / A[136];
+	f1 = -A[152] * f;
+	A[153] += A[137] * f1;
+	A[157] += A[141] * f1;
+	RHS[9] += RHS[8] * f1;
+	f1 = -A[216] * f;
+	A[217] += A[137] * f1;
+	A[221] += A[141] * f1;
+	RHS[13] += RHS[8] * f1;
+	f = 1.0 / A[153];
+	f1 = -A[169] * f;
+	A[170] += A[154] * f1;
+	A[171] += A[155] * f1;
+	A[173] += A[157] * f1;
+	RHS[10] += RHS[9] * f1;
+	f1 = -A[185] * f;
+	A[186] += A[154] * f1;
+	A[187] += A[155] * f1;
+	A[189] += A[157] * f1;
+	RHS[11] += RHS[9] * f1;
+	f1 = -A[217] * f;
+	A[218] += A[154] * f1;
+	A[219] += A[155] * f1;
+	A[221] += A[157] * f1;
+	RHS[13] += RHS[9] * f1;
+	f = 1.0 / A[170];
+	f1 = -A[186] * f;
+	A[187] += A[171] * f1;
+	A[189] += A[173] * f1;
+	RHS[11] += RHS[10] * f1;
+	f1 = -A[218] * f;
+	A[219] += A[171] * f1;
+	A[221] += A[173] * f1;
+	RHS[13] += RHS[10] * f1;
+	f = 1.0 / A[187];
+	f1 = -A[203] * f;
+	A[204] += A[188] * f1;
+	A[205] += A[189] * f1;
+	RHS[12] += RHS[11] * f1;
+	f1 = -A[219] * f;
+	A[220] += A[188] * f1;
+	A[221] += A[189] * f1;
+	RHS[13] += RHS[11] * f1;
+	f = 1.0 / A[204];
+	f1 = -A[220] * f;
+	A[221] += A[205] * f1;
+	RHS[13] += RHS[12] * f1;
+	V[13] = RHS[13] / A[221];
+	V[12] = (RHS[12] - (A[205] * V[13])) / A[204];
+	V[11] = (RHS[11] - (A[188] * V[12] + A[189] * V[13])) / A[187];
+	V[10] = (RHS[10] - (A[171] * V[11] + A[173] * V[13])) / A[170];
+	V[9] = (RHS[9] - (A[154] * V[10] + A[155] * V[11] + A[157] * V[13])) / A[153];
+	V[8] = (RHS[8] - (A[137] * V[9] + A[141] * V[13])) / A[136];
+	V[7] = (RHS[7] - (A[120] * V[8] + A[125] * V[13])) / A[119];
+	V[6] = (RHS[6] - (A[103] * V[7] + A[109] * V[13])) / A[102];
+	V[5] = (RHS[5] - (A[86] * V[6] + A[87] * V[7] + A[93] * V[13])) / A[85];
+	V[4] = (RHS[4] - (A[69] * V[5] + A[70] * V[6] + A[71] * V[7] + A[77] * V[13])) / A[68];
+	V[3] = (RHS[3] - (A[52] * V[4] + A[61] * V[13])) / A[51];
+	V[2] = (RHS[2] - (A[35] * V[3] + A[36] * V[4] + A[45] * V[13])) / A[34];
+	V[1] = (RHS[1] - (A[18] * V[2] + A[19] * V[3] + A[20] * V[4] + A[29] * V[13])) / A[17];
+	V[0] = (RHS[0] - (A[1] * V[1])) / A[0];
+}
+static static_solver_t s_nl_gcr_14f0bc2da643c1df("14f0bc2da643c1df", nl_gcr_14f0bc2da643c1df);
+
+// netlist.Solver.Solver_2: 6 nets
+static void nl_gcr_7e8a0a533ff9d98c(nl_double * RESTRICT A, nl_double * RESTRICT RHS, nl_double * RESTRICT V)
+{
+	nl_double f, f1;
+	f = 1.0 / A[0];
+	f1 = -A[8] * f;
+	A[9] += A[1] * f1;
+	A[10] += A[2] * f1;
+	A[11] += A[3] * f1;
+	RHS[1] += RHS[0] * f1;
+	f1 = -A[16] * f;
+	A[17] += A[1] * f1;
+	A[18] += A[2] * f1;
+	A[19] += A[3] * f1;
+	RHS[2] += RHS[0] * f1;
+	f1 = -A[24] * f;
+	A[25] += A[1] * f1;
+	A[26] += A[2] * f1;
+	A[27] += A[3] * f1;
+	RHS[3] += RHS[0] * f1;
+	f = 1.0 / A[9];
+	f1 = -A[17] * f;
+	A[18] += A[10] * f1;
+	A[19] += A[11] * f1;
+	RHS[2] += RHS[1] * f1;
+	f1 = -A[25] * f;
+	A[26] += A[10] * f1;
+	A[27] += A[11] * f1;
+	RHS[3] += RHS[1] * f1;
+	f = 1.0 / A[18];
+	f1 = -A[26] * f;
+	A[27] += A[19] * f1;
+	RHS[3] += RHS[2] * f1;
+	f = 1.0 / A[27];
+	f1 = -A[35] * f;
+	A[36] += A[28] * f1;
+	RHS[4] += RHS[3] * f1;
+	f = 1.0 / A[36];
+	f1 = -A[44] * f;
+	A[45] += A[37] * f1;
+	RHS[5] += RHS[4] * f1;
+	V[5] = RHS[5] / A[45];
+	V[4] = (RHS[4] - (A[37] * V[5])) / A[36];
+	V[3] = (RHS[3] - (A[28] * V[4])) / A[27];
+	V[2] = (RHS[2] - (A[19] * V[3])) / A[18];
+	V[1] = (RHS[1] - (A[10] * V[2] + A[11] * V[3])) / A[9];
+	V[0] = (RHS[0] - (A[1] * V[1] + A[2] * V[2] + A[3] * V[3])) / A[0];
+}
+static static_solver_t s_nl_gcr_7e8a0a533ff9d98c("7e8a0a533ff9d98c", nl_gcr_7e8a0a533ff9d98c);
+
+// netlist.Solver.Solver_3: 13 nets
+static void nl_gcr_bb014d236150699a(nl_double * RESTRICT A, nl_double * RESTRICT RHS, nl_double * RESTRICT V)
+{
+	nl_double f, f1;
+	f = 1.0 / A[0];
+	f1 = -A[16] * f;
+	A[17] += A[1] * f1;
+	A[18] += A[2] * f1;
+	RHS[1] += RHS[0] * f1;
+	f1 = -A[32] * f;
+	A[33] += A[1] * f1;
+	A[34] += A[2] * f1;
+	RHS[2] += RHS[0] * f1;
+	f = 1.0 / A[17];
+	f1 = -A[33] * f;
+	A[34] += A[18] * f1;
+	RHS[2] += RHS[1] * f1;
+	f = 1.0 / A[34];
+	f1 = -A[50] * f;
+	A[51] += A[35] * f1;
+	A[53] += A[37] * f1;
+	A[55] += A[39] * f1;
+	A[57] += A[41] * f1;
+	A[59] += A[43] * f1;
+	RHS[3] += RHS[2] * f1;
+	f1 = -A[82] * f;
+	A[83] += A[35] * f1;
+	A[85] += A[37] * f1;
+	A[87] += A[39] * f1;
+	A[89] += A[41] * f1;
+	A[91] += A[43] * f1;
+	RHS[5] += RHS[2] * f1;
+	f1 = -A[114] * f;
+	A[115] += A[35] * f1;
+	A[117] += A[37] * f1;
+	A[119] += A[39] * f1;
+	A[121] += A[41] * f1;
+	A[123] += A[43] * f1;
+	RHS[7] += RHS[2] * f1;
+	f1 = -A[146] * f;
+	A[147] += A[35] * f1;
+	A[149] += A[37] * f1;
+	A[151] += A[39] * f1;
+	A[153] += A[41] * f1;
+	A[155] += A[43] * f1;
+	RHS[9] += RHS[2] * f1;
+	f1 = -A[178] * f;
+	A[179] += A[35] * f1;
+	A[181] += A[37] * f1;
+	A[183] += A[39] * f1;
+	A[185] += A[41] * f1;
+	A[187] += A[43] * f1;
+	RHS[11] += RHS[2] * f1;
+	f = 1.0 / A[51];
+	f1 = -A[67] * f;
+	A[68] += A[52] * f1;
+	A[69] += A[53] * f1;
+	A[71] += A[55] * f1;
+	A[73] += A[57] * f1;
+	A[75] += A[59] * f1;
+	RHS[4] += RHS[3] * f1;
+	f1 = -A[83] * f;
+	A[84] += A[52] * f1;
+	A[85] += A[53] * f1;
+	A[87] += A[55] * f1;
+	A[89] += A[57] * f1;
+	A[91] += A[59] * f1;
+	RHS[5] += RHS[3] * f1;
+	f1 = -A[115] * f;
+	A[116] += A[52] * f1;
+	A[117] += A[53] * f1;
+	A[119] += A[55] * f1;
+	A[121] += A[57] * f1;
+	A[123] += A[59] * f1;
+	RHS[7] += RHS[3] * f1;
+	f1 = -A[147] * f;
+	A[148] += A[52] * f1;
+	A[149] += A[53] * f1;
+	A[151] += A[55] * f1;
+	A[153] += A[57] * f1;
+	A[155] += A[59] * f1;
+	RHS[9] += RHS[3] * f1;
+	f1 = -A[179] * f;
+	A[180] += A[52] * f1;
+	A[181] += A[53] * f1;
+	A[183] += A[55] * f1;
+	A[185] += A[57] * f1;
+	A[187] += A[59] * f1;
+	RHS[11] += RHS[3] * f1;
+	f = 1.0 / A[68];
+	f1 = -A[84] * f;
+	A[85] += A[69] * f1;
+	A[87] += A[71] * f1;
+	A[89] += A[73] * f1;
+	A[91] += A[75] * f1;
+	RHS[5] += RHS[4] * f1;
+	f1 = -A[116] * f;
+	A[117] += A[69] * f1;
+	A[119] += A[71] * f1;
+	A[121] += A[73] * f1;
+	A[123] += A[75] * f1;
+	RHS[7] += RHS[4] * f1;
+	f1 = -A[148] * f;
+	A[149] += A[69] * f1;
+	A[151] += A[71] * f1;
+	A[153] += A[73] * f1;
+	A[155] += A[75] * f1;
+	RHS[9] += RHS[4] * f1;
+	f1 = -A[180] * f;
+	A[181] += A[69] * f1;
+	A[183] += A[71] * f1;
+	A[185] += A[73] * f1;
+	A[187] += A[75] * f1;
+	RHS[11] += RHS[4] * f1;
+	f = 1.0 / A[85];
+	f1 = -A[101] * f;
+	A[102] += A[86] * f1;
+	A[103] += A[87] * f1;
+	A[105] += A[89] * f1;
+	A[107] += A[91] * f1;
+	RHS[6] += RHS[5] * f1;
+	f1 = -A[117] * f;
+	A[118] += A[86] * f1;
+	A[119] += A[87] * f1;
+	A[121] += A[89] * f1;
+	A[123] += A[91] * f1;
+	RHS[7] += RHS[5] * f1;
+	f1 = -A[149] * f;
+	A[150] += A[86] * f1;
+	A[151] += A[87] * f1;
+	A[153] += A[89] * f1;
+	A[155] += A[91] * f1;
+	RHS[9] += RHS[5] * f1;
+	f1 = -A[181] * f;
+	A[182] += A[86] * f1;
+	A[183] += A[87] * f1;
+	A[185] += A[89] * f1;
+	A[187] += A[91] * f1;
+	RHS[11] += RHS[5] * f1;
+	f = 1.0 / A[102];
+	f1 = -A[118] * f;
+	A[119] += A[103] * f1;
+	A[121] += A[105] * f1;
+	A[123] += A[107] * f1;
+	RHS[7] += RHS[6] * f1;
+	f1 = -A[150] * f;
+	A[151] += A[103] * f1;
+	A[153] += A[105] * f1;
+	A[155] += A[107] * f1;
+	RHS[9] += RHS[6] * f1;
+	f1 = -A[182] * f;
+	A[183] += A[103] * f1;
+	A[185] += A[105] * f1;
+	A[187] += A[107] * f1;
+	RHS[11] += RHS[6] * f1;
+	f = 1.0 / A[119];
+	f1 = -A[135] * f;
+	A[136] += A[120] * f1;
+	A[137] += A[121] * f1;
+	A[139] += A[123] * f1;
+	RHS[8] += RHS[7] * f1;
+	f1 = -A[151] * f;
+	A[152] += A[120] * f1;
+	A[153] += A[121] * f1;
+	A[155] += A[123] * f1;
+	RHS[9] += RHS[7] * f1;
+	f1 = -A[183] * f;
+	A[184] += A[120] * f1;
+	A[185] += A[121] * f1;
+	A[187] += A[123] * f1;
+	RHS[11] += RHS[7] * f1;
+	f = 1.0 / A[136];
+	f1 = -A[152] * f;
+	A[153] += A[137] * f1;
+	A[155] += A[139] * f1;
+	RHS[9] += RHS[8] * f1;
+	f1 = -A[184] * f;
+	A[185] += A[137] * f1;
+	A[187] += A[139] * f1;
+	RHS[11] += RHS[8] * f1;
+	f = 1.0 / A[153];
+	f1 = -A[169] * f;
+	A[170] += A[154] * f1;
+	A[171] += A[155] * f1;
+	RHS[10] += RHS[9] * f1;
+	f1 = -A[185] * f;
+	A[186] += A[154] * f1;
+	A[187] += A[155] * f1;
+	RHS[11] += RHS[9] * f1;
+	f = 1.0 / A[170];
+	f1 = -A[186] * f;
+	A[187] += A[171] * f1;
+	RHS[11] += RHS[10] * f1;
+	f = 1.0 / A[187];
+	f1 = -A[203] * f;
+	A[204] += A[188] * f1;
+	RHS[12] += RHS[11] * f1;
+	V[12] = RHS[12] / A[204];
+	V[11] = (RHS[11] - (A[188] * V[12])) / A[187];
+	V[10] = (RHS[10] - (A[171] * V[11])) / A[170];
+	V[9] = (RHS[9] - (A[154] * V[10] + A[155] * V[11])) / A[153];
+	V[8] = (RHS[8] - (A[137] * V[9] + A[139] * V[11])) / A[136];
+	V[7] = (RHS[7] - (A[120] * V[8] + A[121] * V[9] + A[123] * V[11])) / A[119];
+	V[6] = (RHS[6] - (A[103] * V[7] + A[105] * V[9] + A[107] * V[11])) / A[102];
+	V[5] = (RHS[5] - (A[86] * V[6] + A[87] * V[7] + A[89] * V[9] + A[91] * V[11])) / A[85];
+	V[4] = (RHS[4] - (A[69] * V[5] + A[71] * V[7] + A[73] * V[9] + A[75] * V[11])) / A[68];
+	V[3] = (RHS[3] - (A[52] * V[4] + A[53] * V[5] + A[55] * V[7] + A[57] * V[9] + A[59] * V[11])) / A[51];
+	V[2] = (RHS[2] - (A[35] * V[3] + A[37] * V[5] + A[39] * V[7] + A[41] * V[9] + A[43] * V[11])) / A[34];
+	V[1] = (RHS[1] - (A[18] * V[2])) / A[17];
+	V[0] = (RHS[0] - (A[1] * V[1] + A[2] * V[2])) / A[0];
+}
+static static_solver_t s_nl_gcr_bb014d236150699a("bb014d236150699a", nl_gcr_bb014d236150699a);
+
+NETLIB_NAMESPACE_DEVICES_END()
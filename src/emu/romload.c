@@ -26,6 +26,10 @@
 
 #define TEMPBUFFER_MAX_SIZE     (1024 * 1024 * 1024)
 
+/* limits on how far ahead of the loader the prefetcher may run */
+#define PREFETCH_MAX_FILES      64
+#define PREFETCH_MAX_BYTES      (256 * 1024 * 1024)
+
 
 
 /***************************************************************************
@@ -55,6 +59,38 @@ private:
 };
 
 
+/* a ROM file being opened, decompressed and hashed ahead of the loader */
+struct rom_prefetch
+{
+	rom_prefetch *next() const { return m_next; }
+
+	rom_prefetch *      m_next;                 /* pointer to next in the list */
+	const char *        m_location;             /* location to search, as passed to open_rom_file */
+	const rom_entry *   m_romp;                 /* ROM entry to load */
+	bool                m_started;              /* has the file been opened yet? */
+	emu_file *          m_file;                 /* the file we opened, or NULL if it wasn't found */
+	std::string         m_tried_file_names;     /* locations searched, for error reporting */
+	std::string         m_hashtypes;            /* hash types that verify_length_and_hash will want */
+	osd_work_item *     m_item;                 /* work item decompressing and hashing the file */
+	osd_ticks_t         m_ticks;                /* time the worker spent on the file */
+};
+
+
+/* time spent in each phase of loading, reported with -verbose */
+struct romload_timing
+{
+	osd_ticks_t     total;              /* total time in process_region_list */
+	osd_ticks_t     open;               /* searching for and opening files */
+	osd_ticks_t     work;               /* decompressing and hashing, summed over all workers */
+	osd_ticks_t     wait;               /* waiting for a worker to finish a file */
+	osd_ticks_t     copy;               /* copying data into the regions */
+	osd_ticks_t     disks;              /* opening and verifying disk images */
+	osd_ticks_t     post;               /* region post-processing */
+	int             files;              /* number of files loaded through the prefetcher */
+	UINT64          bytes;              /* number of bytes loaded through the prefetcher */
+};
+
+
 struct romload_private
 {
 	running_machine &machine() const { assert(m_machine != NULL); return *m_machine; }
@@ -73,6 +109,14 @@ struct romload_private
 	emu_file *      file;               /* current file */
 	simple_list<open_chd> chd_list;     /* disks */
 
+	osd_work_queue * prefetch_queue;    /* queue for decompressing and hashing files */
+	simple_list<rom_prefetch> prefetch_list; /* files to load, in load order */
+	rom_prefetch *  prefetch_next;      /* next file in the list to open */
+	int             prefetch_files;     /* files opened but not yet loaded */
+	UINT32          prefetch_bytes;     /* size of files opened but not yet loaded */
+	romload_timing  timing;             /* per-phase timings */
+	hash_cache *    hashcache;          /* hashes remembered from earlier runs */
+
 	memory_region * region;             /* info about current region */
 
 	std::string     errorstring;        /* error string */
@@ -102,9 +146,9 @@ file_error common_process_file(emu_options &options, const char *location, const
 	return filerr;
 }
 
-file_error common_process_file(emu_options &options, const char *location, bool has_crc, UINT32 crc, const rom_entry *romp, emu_file **image_file)
+file_error common_process_file(emu_options &options, const char *location, bool has_crc, UINT32 crc, const rom_entry *romp, emu_file **image_file, UINT32 openflags)
 {
-	*image_file = global_alloc(emu_file(options.media_path(), OPEN_FLAG_READ));
+	*image_file = global_alloc(emu_file(options.media_path(), openflags));
 	file_error filerr;
 
 	if (has_crc)
@@ -616,35 +660,31 @@ static void region_post_process(romload_private *romdata, const char *rgntag, bo
 
 
 /*-------------------------------------------------
-    open_rom_file - open a ROM file, searching
-    up the parent and loading by checksum
+    locate_rom_file - search for a ROM file up
+    the parent chain and in the region location,
+    loading by checksum where possible
 -------------------------------------------------*/
 
-static int open_rom_file(romload_private *romdata, const char *regiontag, const rom_entry *romp, std::string &tried_file_names, bool from_list)
+static emu_file *locate_rom_file(romload_private *romdata, const char *regiontag, const rom_entry *romp, std::string &tried_file_names, UINT32 openflags)
 {
-	file_error filerr = FILERR_NOT_FOUND;
-	UINT32 romsize = rom_file_size(romp);
+	emu_file *file = NULL;
 	tried_file_names = "";
 
-	/* update status display */
-	display_loading_rom_message(romdata, ROM_GETNAME(romp), from_list);
-
 	/* extract CRC to use for searching */
 	UINT32 crc = 0;
 	bool has_crc = hash_collection(ROM_GETHASHDATA(romp)).crc(crc);
 
 	/* attempt reading up the chain through the parents. It automatically also
 	 attempts any kind of load by checksum supported by the archives. */
-	romdata->file = NULL;
-	for (int drv = driver_list::find(romdata->machine().system()); romdata->file == NULL && drv != -1; drv = driver_list::clone(drv)) {
+	for (int drv = driver_list::find(romdata->machine().system()); file == NULL && drv != -1; drv = driver_list::clone(drv)) {
 		if (tried_file_names.length() != 0)
 			tried_file_names += " ";
 		tried_file_names += driver_list::driver(drv).name;
-		filerr = common_process_file(romdata->machine().options(), driver_list::driver(drv).name, has_crc, crc, romp, &romdata->file);
+		common_process_file(romdata->machine().options(), driver_list::driver(drv).name, has_crc, crc, romp, &file, openflags);
 	}
 
 	/* if the region is load by name, load the ROM from there */
-	if (romdata->file == NULL && regiontag != NULL)
+	if (file == NULL && regiontag != NULL)
 	{
 		// check if we are dealing with softwarelists. if so, locationtag
 		// is actually a concatenation of: listname + setname + parentname
@@ -693,43 +733,185 @@ static int open_rom_file(romload_private *romdata, const char *regiontag, const
 		if (!is_list)
 		{
 			tried_file_names += " " + tag1;
-			filerr = common_process_file(romdata->machine().options(), tag1.c_str(), has_crc, crc, romp, &romdata->file);
+			common_process_file(romdata->machine().options(), tag1.c_str(), has_crc, crc, romp, &file, openflags);
 		}
 		else
 		{
 			// try to load from list/setname
-			if ((romdata->file == NULL) && (tag2.c_str() != NULL))
+			if ((file == NULL) && (tag2.c_str() != NULL))
 			{
 				tried_file_names += " " + tag2;
-				filerr = common_process_file(romdata->machine().options(), tag2.c_str(), has_crc, crc, romp, &romdata->file);
+				common_process_file(romdata->machine().options(), tag2.c_str(), has_crc, crc, romp, &file, openflags);
 			}
 			// try to load from list/parentname
-			if ((romdata->file == NULL) && has_parent && (tag3.c_str() != NULL))
+			if ((file == NULL) && has_parent && (tag3.c_str() != NULL))
 			{
 				tried_file_names += " " + tag3;
-				filerr = common_process_file(romdata->machine().options(), tag3.c_str(), has_crc, crc, romp, &romdata->file);
+				common_process_file(romdata->machine().options(), tag3.c_str(), has_crc, crc, romp, &file, openflags);
 			}
 			// try to load from setname
-			if ((romdata->file == NULL) && (tag4.c_str() != NULL))
+			if ((file == NULL) && (tag4.c_str() != NULL))
 			{
 				tried_file_names += " " + tag4;
-				filerr = common_process_file(romdata->machine().options(), tag4.c_str(), has_crc, crc, romp, &romdata->file);
+				common_process_file(romdata->machine().options(), tag4.c_str(), has_crc, crc, romp, &file, openflags);
 			}
 			// try to load from parentname
-			if ((romdata->file == NULL) && has_parent && (tag5.c_str() != NULL))
+			if ((file == NULL) && has_parent && (tag5.c_str() != NULL))
 			{
 				tried_file_names += " " + tag5;
-				filerr = common_process_file(romdata->machine().options(), tag5.c_str(), has_crc, crc, romp, &romdata->file);
+				common_process_file(romdata->machine().options(), tag5.c_str(), has_crc, crc, romp, &file, openflags);
 			}
 		}
 	}
 
+	/* let the file skip hashing if it hasn't changed since we last saw it */
+	if (file != NULL)
+		file->set_hash_cache(romdata->hashcache);
+	return file;
+}
+
+
+/*-------------------------------------------------
+    prefetch_rom_static - worker callback that
+    decompresses a file and computes its hashes
+-------------------------------------------------*/
+
+static void *prefetch_rom_static(void *param, int threadid)
+{
+	rom_prefetch *prefetch = reinterpret_cast<rom_prefetch *>(param);
+	osd_ticks_t start = osd_ticks();
+
+	/* seeking forces a compressed file into memory; then hash whatever the verify step will check */
+	prefetch->m_file->seek(0, SEEK_SET);
+	prefetch->m_file->hashes(prefetch->m_hashtypes.c_str());
+
+	prefetch->m_ticks = osd_ticks() - start;
+	return NULL;
+}
+
+
+/*-------------------------------------------------
+    start_prefetch - open the next file in the
+    prefetch list and queue its decompression
+-------------------------------------------------*/
+
+static void start_prefetch(romload_private *romdata)
+{
+	rom_prefetch *prefetch = romdata->prefetch_next;
+	romdata->prefetch_next = prefetch->next();
+	romdata->prefetch_files++;
+	romdata->prefetch_bytes += rom_file_size(prefetch->m_romp);
+
+	/* open without preloading, so that the decompression can happen on a worker */
+	osd_ticks_t start = osd_ticks();
+	prefetch->m_started = true;
+	prefetch->m_file = locate_rom_file(romdata, prefetch->m_location, prefetch->m_romp, prefetch->m_tried_file_names, OPEN_FLAG_READ | OPEN_FLAG_NO_PRELOAD);
+	if (prefetch->m_file != NULL)
+	{
+		/* 7z members decompress a whole solid block; load them here so the next member can reuse the cached archive */
+		if (prefetch->m_file->pending_7z_load())
+			prefetch->m_file->seek(0, SEEK_SET);
+		prefetch->m_item = osd_work_item_queue(romdata->prefetch_queue, prefetch_rom_static, prefetch, 0);
+		if (prefetch->m_item == NULL)
+			prefetch_rom_static(prefetch, 0);
+	}
+	romdata->timing.open += osd_ticks() - start;
+}
+
+
+/*-------------------------------------------------
+    fill_prefetch - open files ahead of the loader
+    until the prefetch limits are reached
+-------------------------------------------------*/
+
+static void fill_prefetch(romload_private *romdata)
+{
+	while (romdata->prefetch_next != NULL && romdata->prefetch_files < PREFETCH_MAX_FILES && romdata->prefetch_bytes < PREFETCH_MAX_BYTES)
+		start_prefetch(romdata);
+}
+
+
+/*-------------------------------------------------
+    finish_prefetch - wait for a prefetched file
+    and remove it from the list, returning the
+    file it opened
+-------------------------------------------------*/
+
+static emu_file *finish_prefetch(romload_private *romdata, rom_prefetch *prefetch, std::string &tried_file_names)
+{
+	/* wait for the worker to finish with it */
+	if (prefetch->m_item != NULL)
+	{
+		osd_ticks_t start = osd_ticks();
+		while (!osd_work_item_wait(prefetch->m_item, 100 * osd_ticks_per_second())) ;
+		osd_work_item_release(prefetch->m_item);
+		romdata->timing.wait += osd_ticks() - start;
+	}
+	romdata->timing.work += prefetch->m_ticks;
+
+	/* account for it and remove it from the list */
+	if (prefetch->m_started)
+	{
+		romdata->prefetch_files--;
+		romdata->prefetch_bytes -= rom_file_size(prefetch->m_romp);
+	}
+	emu_file *file = prefetch->m_file;
+	tried_file_names = prefetch->m_tried_file_names;
+	romdata->prefetch_list.remove(*prefetch);
+	return file;
+}
+
+
+/*-------------------------------------------------
+    free_prefetch - discard any outstanding
+    prefetched files and the work queue
+-------------------------------------------------*/
+
+static void free_prefetch(romload_private *romdata)
+{
+	std::string tried_file_names;
+	while (romdata->prefetch_list.first() != NULL)
+		global_free(finish_prefetch(romdata, romdata->prefetch_list.first(), tried_file_names));
+	romdata->prefetch_next = NULL;
+
+	if (romdata->prefetch_queue != NULL)
+		osd_work_queue_free(romdata->prefetch_queue);
+	romdata->prefetch_queue = NULL;
+}
+
+
+/*-------------------------------------------------
+    open_rom_file - open a ROM file, searching
+    up the parent and loading by checksum
+-------------------------------------------------*/
+
+static int open_rom_file(romload_private *romdata, const char *regiontag, const rom_entry *romp, std::string &tried_file_names, bool from_list)
+{
+	UINT32 romsize = rom_file_size(romp);
+
+	/* update status display */
+	display_loading_rom_message(romdata, ROM_GETNAME(romp), from_list);
+
+	/* take the file from the prefetcher if it got there first, otherwise search for it now */
+	rom_prefetch *prefetch = romdata->prefetch_list.first();
+	if (prefetch != NULL && prefetch->m_romp == romp)
+	{
+		if (!prefetch->m_started)
+			start_prefetch(romdata);
+		romdata->file = finish_prefetch(romdata, prefetch, tried_file_names);
+		romdata->timing.files++;
+		romdata->timing.bytes += romsize;
+		fill_prefetch(romdata);
+	}
+	else
+		romdata->file = locate_rom_file(romdata, regiontag, romp, tried_file_names, OPEN_FLAG_READ);
+
 	/* update counters */
 	romdata->romsloaded++;
 	romdata->romsloadedsize += romsize;
 
 	/* return the result */
-	return (filerr == FILERR_NONE);
+	return (romdata->file != NULL);
 }
 
 
@@ -987,7 +1169,11 @@ static void process_rom_entries(romload_private *romdata, const char *regiontag,
 
 					/* attempt to read using the modified entry */
 					if (!ROMENTRY_ISIGNORE(&modified_romp) && !irrelevantbios)
+					{
+						osd_ticks_t start = osd_ticks();
 						/*readresult = */read_rom_data(romdata, parent_region, &modified_romp);
+						romdata->timing.copy += osd_ticks() - start;
+					}
 				}
 				while (ROMENTRY_ISCONTINUE(romp) || ROMENTRY_ISIGNORE(romp));
 
@@ -1452,9 +1638,28 @@ void load_software_part_region(device_t &device, software_list_device &swlist, c
 static void process_region_list(romload_private *romdata)
 {
 	std::string regiontag;
+	osd_ticks_t start = osd_ticks();
 
-	/* loop until we hit the end */
+	/* queue up every relevant ROM file in the order we will load them; the prefetcher opens
+	   them ahead of the loader and decompresses and hashes them on worker threads, while
+	   copying into the regions, error reporting and post-processing stay in order here */
 	device_iterator deviter(romdata->machine().root_device());
+	for (device_t *device = deviter.first(); device != NULL; device = deviter.next())
+		for (const rom_entry *region = rom_first_region(*device); region != NULL; region = rom_next_region(region))
+			if (ROMREGION_ISROMDATA(region))
+				for (const rom_entry *romp = rom_first_file(region); romp != NULL; romp = rom_next_file(romp))
+					if (ROM_GETBIOSFLAGS(romp) == 0 || ROM_GETBIOSFLAGS(romp) == device->system_bios())
+					{
+						rom_prefetch &prefetch = romdata->prefetch_list.append(*global_alloc_clear(rom_prefetch));
+						prefetch.m_location = device->shortname();
+						prefetch.m_romp = romp;
+						hash_collection(ROM_GETHASHDATA(romp)).hash_types(prefetch.m_hashtypes);
+					}
+	romdata->prefetch_next = romdata->prefetch_list.first();
+	romdata->prefetch_queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI);
+	fill_prefetch(romdata);
+
+	/* loop until we hit the end */
 	for (device_t *device = deviter.first(); device != NULL; device = deviter.next())
 		for (const rom_entry *region = rom_first_region(*device); region != NULL; region = rom_next_region(region))
 		{
@@ -1496,16 +1701,33 @@ static void process_region_list(romload_private *romdata)
 				process_rom_entries(romdata, device->shortname(), region, region + 1, device, FALSE);
 			}
 			else if (ROMREGION_ISDISKDATA(region))
+			{
+				osd_ticks_t diskstart = osd_ticks();
 				process_disk_entries(romdata, regiontag.c_str(), region, region + 1, NULL);
+				romdata->timing.disks += osd_ticks() - diskstart;
+			}
 		}
 
+	/* everything has been loaded; drop anything left over and the worker queue */
+	free_prefetch(romdata);
+
 	/* now go back and post-process all the regions */
+	osd_ticks_t poststart = osd_ticks();
 	for (device_t *device = deviter.first(); device != NULL; device = deviter.next())
 		for (const rom_entry *region = rom_first_region(*device); region != NULL; region = rom_next_region(region))
 		{
 			regiontag = rom_region_name(*device, region);
 			region_post_process(romdata, regiontag.c_str(), ROMREGION_ISINVERTED(region));
 		}
+	romdata->timing.post += osd_ticks() - poststart;
+	romdata->timing.total += osd_ticks() - start;
+
+	/* report where the time went */
+	const romload_timing &timing = romdata->timing;
+	double tps = (double)osd_ticks_per_second();
+	osd_printf_verbose("Loaded %d ROM files (%.1f MB) in %.3fs: open %.3fs, decompress/hash %.3fs on workers, wait %.3fs, copy %.3fs, disks %.3fs, post-process %.3fs\n",
+			timing.files, (double)timing.bytes / (1024.0 * 1024.0), timing.total / tps, timing.open / tps, timing.work / tps,
+			timing.wait / tps, timing.copy / tps, timing.disks / tps, timing.post / tps);
 
 	/* and finally register all per-game parameters */
 	for (device_t *device = deviter.first(); device != NULL; device = deviter.next())
@@ -1534,6 +1756,8 @@ void rom_init(running_machine &machine)
 
 	/* reset the romdata struct */
 	romdata->m_machine = &machine;
+	if (machine.options().hash_cache())
+		romdata->hashcache = global_alloc(hash_cache(machine.options()));
 
 	/* figure out which BIOS we are using */
 	device_iterator deviter(romdata->machine().config().root_device());
@@ -1562,6 +1786,10 @@ void rom_init(running_machine &machine)
 	/* process the ROM entries we were passed */
 	process_region_list(romdata);
 
+	/* save any hashes we had to compute */
+	if (romdata->hashcache != NULL)
+		romdata->hashcache->save();
+
 	/* display the results and exit */
 	display_rom_load_results(romdata, FALSE);
 }
@@ -1573,6 +1801,19 @@ void rom_init(running_machine &machine)
 
 static void rom_exit(running_machine &machine)
 {
+	/* if loading failed part way through, there may still be prefetched files outstanding */
+	if (machine.romload_data != NULL)
+	{
+		free_prefetch(machine.romload_data);
+
+		/* software loaded after startup may have added hashes too */
+		if (machine.romload_data->hashcache != NULL)
+		{
+			machine.romload_data->hashcache->save();
+			global_free(machine.romload_data->hashcache);
+			machine.romload_data->hashcache = NULL;
+		}
+	}
 }
 
 
@@ -1419,6 +1419,19 @@ INLINE void chan_calc(FM_OPN *OPN, FM_CH *CH, int chnum)
 	}
 }
 
+/* A channel whose operators are all in EG_OFF and which has no feedback or
+ * delayed (MEM) sample left outputs 0, and chan_calc() only advances its
+ * phase counters, which are restarted by KEY ON anyway. Operators only leave
+ * EG_OFF on KEY ON, which is done by register writes between updates unless
+ * CSM is active, so such a channel stays idle for a whole update call and
+ * is skipped.
+ */
+INLINE int chan_is_idle(FM_CH *CH)
+{
+	return (CH->SLOT[SLOT1].state == EG_OFF) && (CH->SLOT[SLOT2].state == EG_OFF) && (CH->SLOT[SLOT3].state == EG_OFF) && (CH->SLOT[SLOT4].state == EG_OFF)
+		&& !CH->op1_out[0] && !CH->op1_out[1] && !CH->mem_value;
+}
+
 /* update phase increment and envelope generator */
 INLINE void refresh_fc_eg_slot(FM_OPN *OPN, FM_SLOT *SLOT , int fc , int kc )
 {
@@ -2103,6 +2116,7 @@ void ym2203_update_one(void *chip, FMSAMPLE *buffer, int length)
 	int i;
 	FMSAMPLE *buf = buffer;
 	FM_CH   *cch[3];
+	UINT32 idle = 0;
 
 	cch[0]   = &F2203->CH[0];
 	cch[1]   = &F2203->CH[1];
@@ -2127,6 +2141,12 @@ void ym2203_update_one(void *chip, FMSAMPLE *buffer, int length)
 		refresh_fc_eg_chan( OPN, cch[2] );
 
 
+	/* channels which stay silent for this block */
+	if ((OPN->ST.mode & 0xc0) != 0x80)
+		for (i=0; i<3; i++)
+			if (chan_is_idle(cch[i]))
+				idle |= 1 << i;
+
 	/* YM2203 doesn't have LFO so we must keep these globals at 0 level */
 	OPN->LFO_AM = 0;
 	OPN->LFO_PM = 0;
@@ -2152,9 +2172,9 @@ void ym2203_update_one(void *chip, FMSAMPLE *buffer, int length)
 		}
 
 		/* calculate FM */
-		chan_calc(OPN, cch[0], 0 );
-		chan_calc(OPN, cch[1], 1 );
-		chan_calc(OPN, cch[2], 2 );
+		if (!(idle & 0x01)) chan_calc(OPN, cch[0], 0 );
+		if (!(idle & 0x02)) chan_calc(OPN, cch[1], 1 );
+		if (!(idle & 0x04)) chan_calc(OPN, cch[2], 2 );
 
 		/* buffering */
 		{
@@ -2727,6 +2747,7 @@ void ym2608_update_one(void *chip, FMSAMPLE **buffer, int length)
 	int i,j;
 	FMSAMPLE  *bufL,*bufR;
 	FM_CH   *cch[6];
+	UINT32 idle = 0;
 	INT32 *out_fm = OPN->out_fm;
 
 	/* set bufer */
@@ -2761,6 +2782,12 @@ void ym2608_update_one(void *chip, FMSAMPLE **buffer, int length)
 	refresh_fc_eg_chan( OPN, cch[5] );
 
 
+	/* channels which stay silent for this block */
+	if ((OPN->ST.mode & 0xc0) != 0x80)
+		for (i=0; i<6; i++)
+			if (chan_is_idle(cch[i]))
+				idle |= 1 << i;
+
 	/* buffering */
 	for(i=0; i < length ; i++)
 	{
@@ -2778,12 +2805,12 @@ void ym2608_update_one(void *chip, FMSAMPLE **buffer, int length)
 		out_fm[5] = 0;
 
 		/* calculate FM */
-		chan_calc(OPN, cch[0], 0 );
-		chan_calc(OPN, cch[1], 1 );
-		chan_calc(OPN, cch[2], 2 );
-		chan_calc(OPN, cch[3], 3 );
-		chan_calc(OPN, cch[4], 4 );
-		chan_calc(OPN, cch[5], 5 );
+		if (!(idle & 0x01)) chan_calc(OPN, cch[0], 0 );
+		if (!(idle & 0x02)) chan_calc(OPN, cch[1], 1 );
+		if (!(idle & 0x04)) chan_calc(OPN, cch[2], 2 );
+		if (!(idle & 0x08)) chan_calc(OPN, cch[3], 3 );
+		if (!(idle & 0x10)) chan_calc(OPN, cch[4], 4 );
+		if (!(idle & 0x20)) chan_calc(OPN, cch[5], 5 );
 
 		/* deltaT ADPCM */
 		if( DELTAT->portstate&0x80 )
@@ -3267,6 +3294,7 @@ void ym2610_update_one(void *chip, FMSAMPLE **buffer, int length)
 	int i,j;
 	FMSAMPLE  *bufL,*bufR;
 	FM_CH   *cch[4];
+	UINT32 idle = 0;
 	INT32 *out_fm = OPN->out_fm;
 
 	/* buffer setup */
@@ -3306,6 +3334,12 @@ void ym2610_update_one(void *chip, FMSAMPLE **buffer, int length)
 	refresh_fc_eg_chan( OPN, cch[2] );
 	refresh_fc_eg_chan( OPN, cch[3] );
 
+	/* channels which stay silent for this block */
+	if ((OPN->ST.mode & 0xc0) != 0x80)
+		for (i=0; i<4; i++)
+			if (chan_is_idle(cch[i]))
+				idle |= 1 << i;
+
 	/* buffering */
 	for(i=0; i < length ; i++)
 	{
@@ -3334,10 +3368,10 @@ void ym2610_update_one(void *chip, FMSAMPLE **buffer, int length)
 		}
 
 		/* calculate FM */
-		chan_calc(OPN, cch[0], 1 ); /*remapped to 1*/
-		chan_calc(OPN, cch[1], 2 ); /*remapped to 2*/
-		chan_calc(OPN, cch[2], 4 ); /*remapped to 4*/
-		chan_calc(OPN, cch[3], 5 ); /*remapped to 5*/
+		if (!(idle & 0x01)) chan_calc(OPN, cch[0], 1 ); /*remapped to 1*/
+		if (!(idle & 0x02)) chan_calc(OPN, cch[1], 2 ); /*remapped to 2*/
+		if (!(idle & 0x04)) chan_calc(OPN, cch[2], 4 ); /*remapped to 4*/
+		if (!(idle & 0x08)) chan_calc(OPN, cch[3], 5 ); /*remapped to 5*/
 
 		/* deltaT ADPCM */
 		if( DELTAT->portstate&0x80 )
@@ -3403,6 +3437,7 @@ void ym2610b_update_one(void *chip, FMSAMPLE **buffer, int length)
 	int i,j;
 	FMSAMPLE  *bufL,*bufR;
 	FM_CH   *cch[6];
+	UINT32 idle = 0;
 	INT32 *out_fm = OPN->out_fm;
 
 	/* buffer setup */
@@ -3436,6 +3471,12 @@ void ym2610b_update_one(void *chip, FMSAMPLE **buffer, int length)
 	refresh_fc_eg_chan( OPN, cch[4] );
 	refresh_fc_eg_chan( OPN, cch[5] );
 
+	/* channels which stay silent for this block */
+	if ((OPN->ST.mode & 0xc0) != 0x80)
+		for (i=0; i<6; i++)
+			if (chan_is_idle(cch[i]))
+				idle |= 1 << i;
+
 	/* buffering */
 	for(i=0; i < length ; i++)
 	{
@@ -3468,12 +3509,12 @@ void ym2610b_update_one(void *chip, FMSAMPLE **buffer, int length)
 		}
 
 		/* calculate FM */
-		chan_calc(OPN, cch[0], 0 );
-		chan_calc(OPN, cch[1], 1 );
-		chan_calc(OPN, cch[2], 2 );
-		chan_calc(OPN, cch[3], 3 );
-		chan_calc(OPN, cch[4], 4 );
-		chan_calc(OPN, cch[5], 5 );
+		if (!(idle & 0x01)) chan_calc(OPN, cch[0], 0 );
+		if (!(idle & 0x02)) chan_calc(OPN, cch[1], 1 );
+		if (!(idle & 0x04)) chan_calc(OPN, cch[2], 2 );
+		if (!(idle & 0x08)) chan_calc(OPN, cch[3], 3 );
+		if (!(idle & 0x10)) chan_calc(OPN, cch[4], 4 );
+		if (!(idle & 0x20)) chan_calc(OPN, cch[5], 5 );
 
 		/* deltaT ADPCM */
 		if( DELTAT->portstate&0x80 )
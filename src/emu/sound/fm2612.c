@@ -1668,6 +1668,14 @@ INLINE void chan_calc(YM2612 *F2612, fm2612_FM_OPN *OPN, fm2612_FM_CH *CH)
 	}
 }
 
+/* channel with all operators in EG_OFF and no feedback or MEM sample left:
+   silent until the next KEY ON, which also restarts the phase generator */
+INLINE int chan_is_idle(fm2612_FM_CH *CH)
+{
+	return (CH->SLOT[SLOT1].state == EG_OFF) && (CH->SLOT[SLOT2].state == EG_OFF) && (CH->SLOT[SLOT3].state == EG_OFF) && (CH->SLOT[SLOT4].state == EG_OFF)
+		&& !CH->op1_out[0] && !CH->op1_out[1] && !CH->mem_value;
+}
+
 static void FMCloseTable( void )
 {
 #ifdef SAVE_SAMPLE
@@ -2183,6 +2191,7 @@ void ym2612_update_one(void *chip, FMSAMPLE **buffer, int length)
 	FMSAMPLE  *bufL,*bufR;
 	fm2612_FM_CH   *cch[6];
 	int lt,rt;
+	UINT32 idle = 0;
 
 	/* set bufer */
 	bufL = buffer[0];
@@ -2213,6 +2222,12 @@ void ym2612_update_one(void *chip, FMSAMPLE **buffer, int length)
 	refresh_fc_eg_chan( OPN, cch[4] );
 	refresh_fc_eg_chan( OPN, cch[5] );
 
+	/* channels which stay silent for this block */
+	if ((OPN->ST.mode & 0xc0) != 0x80)
+		for (i=0; i<6; i++)
+			if (chan_is_idle(cch[i]))
+				idle |= 1 << i;
+
 	/* buffering */
 	for(i=0; i < length ; i++)
 	{
@@ -2233,14 +2248,14 @@ void ym2612_update_one(void *chip, FMSAMPLE **buffer, int length)
 		update_ssg_eg_channel(&cch[5]->SLOT[SLOT1]);
 
 		/* calculate FM */
-		chan_calc(F2612, OPN, cch[0]);
-		chan_calc(F2612, OPN, cch[1]);
-		chan_calc(F2612, OPN, cch[2]);
-		chan_calc(F2612, OPN, cch[3]);
-		chan_calc(F2612, OPN, cch[4]);
+		if (!(idle & 0x01)) chan_calc(F2612, OPN, cch[0]);
+		if (!(idle & 0x02)) chan_calc(F2612, OPN, cch[1]);
+		if (!(idle & 0x04)) chan_calc(F2612, OPN, cch[2]);
+		if (!(idle & 0x08)) chan_calc(F2612, OPN, cch[3]);
+		if (!(idle & 0x10)) chan_calc(F2612, OPN, cch[4]);
 		if( F2612->dacen )
 			*cch[5]->connect4 += F2612->dacout;
-		else
+		else if (!(idle & 0x20))
 			chan_calc(F2612, OPN, cch[5]);
 
 		/* advance LFO */
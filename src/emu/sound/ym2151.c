@@ -1735,6 +1735,20 @@ INLINE void chan_calc(YM2151 *PSG, unsigned int chan)
 	op->mem_value = PSG->mem;
 }
 
+/* A channel whose operators are all in EG_OFF and which has no feedback or
+ * delayed (MEM) sample left outputs 0 and chan_calc() does not change its
+ * state. Operators only leave EG_OFF on KEY ON, which is done by register
+ * writes between updates unless CSM is active, so such a channel stays idle
+ * for a whole call of ym2151_update_one() and is skipped.
+ */
+INLINE int chan_is_idle(YM2151 *PSG, unsigned int chan)
+{
+	YM2151Operator *op = &PSG->oper[chan*4];
+
+	return (op[0].state == EG_OFF) && (op[1].state == EG_OFF) && (op[2].state == EG_OFF) && (op[3].state == EG_OFF)
+		&& !op->fb_out_prev && !op->fb_out_curr && !op->mem_value;
+}
+
 INLINE void chan7_calc(YM2151 *PSG)
 {
 	YM2151Operator *op;
@@ -2381,10 +2395,17 @@ void ym2151_update_one(void *chip, SAMP **buffers, int length)
 	int i;
 	signed int outl,outr;
 	SAMP *bufL, *bufR;
+	UINT32 idle = 0;
 
 	bufL = buffers[0];
 	bufR = buffers[1];
 
+	/* channels which stay silent for this block */
+	if (!(PSG->irq_enable & 0x80) && !PSG->csm_req)
+		for (i=0; i<8; i++)
+			if (chan_is_idle(PSG, i))
+				idle |= 1 << i;
+
 #ifdef USE_MAME_TIMERS
 		/* ASG 980324 - handled by real timers now */
 #else
@@ -2417,21 +2438,21 @@ void ym2151_update_one(void *chip, SAMP **buffers, int length)
 		chanout[6] = 0;
 		chanout[7] = 0;
 
-		chan_calc(PSG, 0);
+		if (!(idle & 0x01)) chan_calc(PSG, 0);
 		SAVE_SINGLE_CHANNEL(0)
-		chan_calc(PSG, 1);
+		if (!(idle & 0x02)) chan_calc(PSG, 1);
 		SAVE_SINGLE_CHANNEL(1)
-		chan_calc(PSG, 2);
+		if (!(idle & 0x04)) chan_calc(PSG, 2);
 		SAVE_SINGLE_CHANNEL(2)
-		chan_calc(PSG, 3);
+		if (!(idle & 0x08)) chan_calc(PSG, 3);
 		SAVE_SINGLE_CHANNEL(3)
-		chan_calc(PSG, 4);
+		if (!(idle & 0x10)) chan_calc(PSG, 4);
 		SAVE_SINGLE_CHANNEL(4)
-		chan_calc(PSG, 5);
+		if (!(idle & 0x20)) chan_calc(PSG, 5);
 		SAVE_SINGLE_CHANNEL(5)
-		chan_calc(PSG, 6);
+		if (!(idle & 0x40)) chan_calc(PSG, 6);
 		SAVE_SINGLE_CHANNEL(6)
-		chan7_calc(PSG);
+		if (!(idle & 0x80)) chan7_calc(PSG);
 		SAVE_SINGLE_CHANNEL(7)
 
 		outl = chanout[0] & PSG->pan[0];
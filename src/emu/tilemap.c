@@ -95,6 +95,21 @@ inline bool tilemap_t::gfx_elements_changed()
 }
 
 
+//-------------------------------------------------
+//  queue_instance - add an instance of the
+//  tilemap to the list to be drawn
+//-------------------------------------------------
+
+inline void tilemap_t::queue_instance(const blit_parameters &blit, int xpos, int ypos)
+{
+	instance_parameters inst;
+	inst.blit = blit;
+	inst.xpos = xpos;
+	inst.ypos = ypos;
+	m_instances.push_back(inst);
+}
+
+
 //**************************************************************************
 //  SCANLINE RASTERIZERS
 //**************************************************************************
@@ -387,6 +402,11 @@ tilemap_t &tilemap_t::init(tilemap_manager &manager, device_gfx_interface &decod
 	m_dy = 0;
 	m_dy_flipped = 0;
 
+	// reset statistics
+	m_draw_ticks = 0;
+	m_draw_calls = 0;
+	m_tiles_updated = 0;
+
 	// allocate pixmap
 	m_pixmap.allocate(m_width, m_height);
 
@@ -720,20 +740,24 @@ void tilemap_t::pixmap_update()
 		return;
 
 g_profiler.start(PROFILER_TILEMAP_DRAW);
+	osd_ticks_t start = osd_ticks();
 
 	// flush the dirty state to all tiles as appropriate
 	realize_all_dirty_tiles();
 
-	// iterate over rows and columns
+	// iterate over rows and columns, fetching info for each dirty tile
 	logical_index logindex = 0;
 	for (int row = 0; row < m_rows; row++)
 		for (int col = 0; col < m_cols; col++, logindex++)
-			if (m_tileflags[logindex] == TILE_FLAG_DIRTY)
-				tile_update(logindex, col, row);
+			tile_queue_update(logindex, col, row);
+
+	// render everything we found
+	realize_pending_tiles();
 
 	// mark it all clean
 	m_all_tiles_clean = true;
 
+	m_draw_ticks += osd_ticks() - start;
 g_profiler.stop();
 }
 
@@ -746,31 +770,179 @@ void tilemap_t::tile_update(logical_index logindex, UINT32 col, UINT32 row)
 {
 g_profiler.start(PROFILER_TILEMAP_UPDATE);
 
+	// fetch the info and render the tile in one go
+	tile_fetch_info(logindex);
+	m_tileflags[logindex] = tile_render(m_tileinfo, col, row);
+	m_tiles_updated++;
+
+g_profiler.stop();
+}
+
+
+//-------------------------------------------------
+//  tile_fetch_info - call the get info callback
+//  for a single tile; the result is left in
+//  m_tileinfo
+//-------------------------------------------------
+
+void tilemap_t::tile_fetch_info(logical_index logindex)
+{
 	// call the get info callback for the associated memory index
 	tilemap_memory_index memindex = m_logical_to_memory[logindex];
 	m_tile_get_info(*this, m_tileinfo, memindex);
 
+	// track which gfx have been used for this tilemap
+	if (m_tileinfo.gfxnum != 0xff && (m_gfx_used & (1 << m_tileinfo.gfxnum)) == 0)
+	{
+		m_gfx_used |= 1 << m_tileinfo.gfxnum;
+		m_gfx_dirtyseq[m_tileinfo.gfxnum] = m_tileinfo.decoder->gfx(m_tileinfo.gfxnum)->dirtyseq();
+	}
+}
+
+
+//-------------------------------------------------
+//  tile_render - render a tile whose info has
+//  already been fetched into the pixmap and
+//  flagsmap, returning the new tile flags; this
+//  touches nothing outside of the tile itself
+//  and is safe to call from a worker thread
+//-------------------------------------------------
+
+UINT8 tilemap_t::tile_render(const tile_data &tileinfo, UINT32 col, UINT32 row)
+{
 	// apply the global tilemap flip to the returned flip flags
-	UINT32 flags = m_tileinfo.flags ^ (m_attributes & 0x03);
+	UINT32 flags = tileinfo.flags ^ (m_attributes & 0x03);
 
 	// draw the tile, using either direct or transparent
 	UINT32 x0 = m_tilewidth * col;
 	UINT32 y0 = m_tileheight * row;
-	m_tileflags[logindex] = tile_draw(m_tileinfo.pen_data, x0, y0,
-		m_tileinfo.palette_base, m_tileinfo.category, m_tileinfo.group, flags, m_tileinfo.pen_mask);
+	UINT8 result = tile_draw(tileinfo.pen_data, x0, y0,
+		tileinfo.palette_base, tileinfo.category, tileinfo.group, flags, tileinfo.pen_mask);
 
 	// if mask data is specified, apply it
-	if ((flags & (TILE_FORCE_LAYER0 | TILE_FORCE_LAYER1 | TILE_FORCE_LAYER2)) == 0 && m_tileinfo.mask_data != NULL)
-		m_tileflags[logindex] = tile_apply_bitmask(m_tileinfo.mask_data, x0, y0, m_tileinfo.category, flags);
+	if ((flags & (TILE_FORCE_LAYER0 | TILE_FORCE_LAYER1 | TILE_FORCE_LAYER2)) == 0 && tileinfo.mask_data != NULL)
+		result = tile_apply_bitmask(tileinfo.mask_data, x0, y0, tileinfo.category, flags);
+	return result;
+}
 
-	// track which gfx have been used for this tilemap
-	if (m_tileinfo.gfxnum != 0xff && (m_gfx_used & (1 << m_tileinfo.gfxnum)) == 0)
+
+//-------------------------------------------------
+//  tile_queue_update - if a tile is dirty, fetch
+//  its info and add it to the list of tiles
+//  pending rendering
+//-------------------------------------------------
+
+void tilemap_t::tile_queue_update(logical_index logindex, UINT32 col, UINT32 row)
+{
+	if (m_tileflags[logindex] != TILE_FLAG_DIRTY)
+		return;
+
+	// the get info callback is driver code, so always call it from here
+	tile_fetch_info(logindex);
+
+	pending_tile pending;
+	pending.logindex = logindex;
+	pending.col = col;
+	pending.row = row;
+	pending.info = m_tileinfo;
+	m_pending.push_back(pending);
+
+	// the real flags are filled in at render time; clear the dirty marker
+	// now so that the tile is not queued twice
+	m_tileflags[logindex] = 0;
+}
+
+
+//-------------------------------------------------
+//  realize_pending_tiles - render all the tiles
+//  collected by tile_queue_update, spreading
+//  them across the work queue if there are
+//  enough of them
+//-------------------------------------------------
+
+void tilemap_t::realize_pending_tiles()
+{
+	int count = m_pending.size();
+	if (count == 0)
+		return;
+	m_tiles_updated += count;
+
+	// small batches aren't worth the overhead of the work queue
+	int slices = MIN(count / MIN_SLICE_TILES, MAX_WORK_SLICES);
+	osd_work_queue *queue = (slices < 2) ? NULL : m_manager->work_queue();
+	if (queue == NULL)
 	{
-		m_gfx_used |= 1 << m_tileinfo.gfxnum;
-		m_gfx_dirtyseq[m_tileinfo.gfxnum] = m_tileinfo.decoder->gfx(m_tileinfo.gfxnum)->dirtyseq();
+		for (int index = 0; index < count; index++)
+		{
+			const pending_tile &pending = m_pending[index];
+			m_tileflags[pending.logindex] = tile_render(pending.info, pending.col, pending.row);
+		}
 	}
 
-g_profiler.stop();
+	// otherwise, divide the list evenly; each tile covers its own pixels so
+	// the slices never overlap
+	else
+	{
+		for (int slicenum = 0; slicenum < slices; slicenum++)
+		{
+			work_slice &slice = m_slices[slicenum];
+			slice.tilemap = this;
+			slice.screen = NULL;
+			slice.dest = NULL;
+			slice.start = count * slicenum / slices;
+			slice.end = count * (slicenum + 1) / slices;
+		}
+		run_slices(queue, render_tiles_callback, slices);
+	}
+	m_pending.clear();
+}
+
+
+//-------------------------------------------------
+//  run_slices - hand the first 'slices' entries
+//  of m_slices to the work queue and return once
+//  all of them are done; if the workers stall,
+//  the caller runs whatever they haven't started
+//-------------------------------------------------
+
+void tilemap_t::run_slices(osd_work_queue *queue, osd_work_callback callback, int slices)
+{
+	for (int slicenum = 0; slicenum < slices; slicenum++)
+		m_slices[slicenum].claimed = 0;
+	osd_work_item_queue_multiple(queue, callback, slices, m_slices, sizeof(m_slices[0]), WORK_ITEM_FLAG_AUTO_RELEASE);
+	if (osd_work_queue_wait(queue, osd_ticks_per_second() * 10))
+		return;
+
+	// the callbacks skip slices that are already claimed, so this only
+	// picks up the ones no worker has started yet
+	for (int slicenum = 0; slicenum < slices; slicenum++)
+		(*callback)(&m_slices[slicenum], 0);
+
+	// the slices still in progress write to our data, so they must finish
+	// before the caller moves on
+	while (!osd_work_queue_wait(queue, osd_ticks_per_second() * 10))
+		;
+}
+
+
+//-------------------------------------------------
+//  render_tiles_callback - work queue callback
+//  to render a slice of the pending tiles
+//-------------------------------------------------
+
+void *tilemap_t::render_tiles_callback(void *param, int threadid)
+{
+	work_slice &slice = *(work_slice *)param;
+	if (atomic_exchange32(&slice.claimed, 1) != 0)
+		return NULL;
+	tilemap_t &tmap = *slice.tilemap;
+
+	for (int index = slice.start; index < slice.end; index++)
+	{
+		const pending_tile &pending = tmap.m_pending[index];
+		tmap.m_tileflags[pending.logindex] = tmap.tile_render(pending.info, pending.col, pending.row);
+	}
+	return NULL;
 }
 
 
@@ -941,6 +1113,8 @@ void tilemap_t::draw_common(screen_device &screen, _BitmapClass &dest, const rec
 		return;
 
 g_profiler.start(PROFILER_TILEMAP_DRAW);
+	osd_ticks_t start = osd_ticks();
+
 	// configure the blit parameters based on the input parameters
 	blit_parameters blit;
 	configure_blit_parameters(blit, screen.priority(), cliprect, flags, priority, priority_mask);
@@ -948,6 +1122,9 @@ g_profiler.start(PROFILER_TILEMAP_DRAW);
 	// flush the dirty state to all tiles as appropriate
 	realize_all_dirty_tiles();
 
+	// gather the instances to draw; they are rendered together below
+	m_instances.clear();
+
 	// flip the tilemap around the center of the visible area
 	rectangle visarea = screen.visible_area();
 	UINT32 width = visarea.min_x + visarea.max_x + 1;
@@ -961,7 +1138,7 @@ g_profiler.start(PROFILER_TILEMAP_DRAW);
 		int scrolly = effective_colscroll(0, height);
 		for (int ypos = scrolly - m_height; ypos <= blit.cliprect.max_y; ypos += m_height)
 			for (int xpos = scrollx - m_width; xpos <= blit.cliprect.max_x; xpos += m_width)
-				draw_instance(screen, dest, blit, xpos, ypos);
+				queue_instance(blit, xpos, ypos);
 	}
 
 	// scrolling rows + vertical scroll
@@ -998,7 +1175,7 @@ g_profiler.start(PROFILER_TILEMAP_DRAW);
 
 				// iterate over X to handle wraparound
 				for (int xpos = scrollx - m_width; xpos <= original_cliprect.max_x; xpos += m_width)
-					draw_instance(screen, dest, blit, xpos, ypos);
+					queue_instance(blit, xpos, ypos);
 			}
 		}
 	}
@@ -1034,10 +1211,16 @@ g_profiler.start(PROFILER_TILEMAP_DRAW);
 
 				// iterate over Y to handle wraparound
 				for (int ypos = scrolly - m_height; ypos <= original_cliprect.max_y; ypos += m_height)
-					draw_instance(screen, dest, blit, xpos, ypos);
+					queue_instance(blit, xpos, ypos);
 			}
 		}
 	}
+
+	// draw everything we collected
+	draw_all_instances(screen, dest);
+
+	m_draw_ticks += osd_ticks() - start;
+	m_draw_calls++;
 g_profiler.stop();
 }
 
@@ -1269,6 +1452,117 @@ void tilemap_t::draw_instance(screen_device &screen, _BitmapClass &dest, const b
 }
 
 
+//-------------------------------------------------
+//  realize_instance_tiles - fetch info for all
+//  dirty tiles that draw_instance would touch
+//  for the given instance
+//-------------------------------------------------
+
+void tilemap_t::realize_instance_tiles(const blit_parameters &blit, int xpos, int ypos)
+{
+	// clip exactly as draw_instance does
+	int x1 = MAX(xpos, blit.cliprect.min_x);
+	int x2 = MIN(xpos + (int)m_width, blit.cliprect.max_x + 1);
+	int y1 = MAX(ypos, blit.cliprect.min_y);
+	int y2 = MIN(ypos + (int)m_height, blit.cliprect.max_y + 1);
+	if (x1 >= x2 || y1 >= y2)
+		return;
+
+	// convert to tile coordinates; the last column is never rendered
+	int mincol = (x1 - xpos) / m_tilewidth;
+	int maxcol = (x2 - xpos + m_tilewidth - 1) / m_tilewidth;
+	int minrow = (y1 - ypos) / m_tileheight;
+	int maxrow = (y2 - ypos - 1) / m_tileheight;
+	for (int row = minrow; row <= maxrow; row++)
+		for (int column = mincol; column < maxcol; column++)
+			tile_queue_update(row * m_cols + column, column, row);
+}
+
+
+//-------------------------------------------------
+//  draw_all_instances - draw the instances that
+//  draw_common collected, splitting the target
+//  into horizontal bands across the work queue
+//  when the area is large enough
+//-------------------------------------------------
+
+template<class _BitmapClass>
+void tilemap_t::draw_all_instances(screen_device &screen, _BitmapClass &dest)
+{
+	int count = m_instances.size();
+	if (count == 0)
+		return;
+
+	// compute the range of scanlines covered
+	int miny = m_instances[0].blit.cliprect.min_y;
+	int maxy = m_instances[0].blit.cliprect.max_y;
+	for (int instnum = 1; instnum < count; instnum++)
+	{
+		miny = MIN(miny, m_instances[instnum].blit.cliprect.min_y);
+		maxy = MAX(maxy, m_instances[instnum].blit.cliprect.max_y);
+	}
+
+	// if there is not enough to split up or no work queue, draw directly
+	int slices = MIN((maxy + 1 - miny) / MIN_SLICE_ROWS, MAX_WORK_SLICES);
+	osd_work_queue *queue = (slices < 2) ? NULL : m_manager->work_queue();
+	if (queue == NULL)
+	{
+		for (int instnum = 0; instnum < count; instnum++)
+			draw_instance(screen, dest, m_instances[instnum].blit, m_instances[instnum].xpos, m_instances[instnum].ypos);
+		return;
+	}
+
+	// the workers must never call back into the driver, so bring every
+	// visible tile up to date first
+	for (int instnum = 0; instnum < count; instnum++)
+		realize_instance_tiles(m_instances[instnum].blit, m_instances[instnum].xpos, m_instances[instnum].ypos);
+	realize_pending_tiles();
+
+	// each band owns its own scanlines of both the destination and the
+	// priority bitmap, and instances never overlap, so the result is
+	// identical to drawing serially
+	for (int slicenum = 0; slicenum < slices; slicenum++)
+	{
+		work_slice &slice = m_slices[slicenum];
+		slice.tilemap = this;
+		slice.screen = &screen;
+		slice.dest = &dest;
+		slice.start = miny + (maxy + 1 - miny) * slicenum / slices;
+		slice.end = miny + (maxy + 1 - miny) * (slicenum + 1) / slices - 1;
+	}
+	run_slices(queue, draw_slice_callback<_BitmapClass>, slices);
+}
+
+
+//-------------------------------------------------
+//  draw_slice_callback - work queue callback to
+//  draw all collected instances clipped to a
+//  single horizontal band
+//-------------------------------------------------
+
+template<class _BitmapClass>
+void *tilemap_t::draw_slice_callback(void *param, int threadid)
+{
+	work_slice &slice = *(work_slice *)param;
+	if (atomic_exchange32(&slice.claimed, 1) != 0)
+		return NULL;
+	tilemap_t &tmap = *slice.tilemap;
+	_BitmapClass &dest = *(_BitmapClass *)slice.dest;
+
+	int count = tmap.m_instances.size();
+	for (int instnum = 0; instnum < count; instnum++)
+	{
+		const instance_parameters &inst = tmap.m_instances[instnum];
+		blit_parameters blit = inst.blit;
+		blit.cliprect.min_y = MAX(blit.cliprect.min_y, slice.start);
+		blit.cliprect.max_y = MIN(blit.cliprect.max_y, slice.end);
+		if (blit.cliprect.min_y <= blit.cliprect.max_y)
+			tmap.draw_instance(*slice.screen, dest, blit, inst.xpos, inst.ypos);
+	}
+	return NULL;
+}
+
+
 //-------------------------------------------------
 //  tilemap_draw_roz_core - render the tilemap's
 //  pixmap to the destination with rotation
@@ -1486,8 +1780,10 @@ void tilemap_t::draw_debug(screen_device &screen, bitmap_rgb32 &dest, UINT32 scr
 
 tilemap_manager::tilemap_manager(running_machine &machine)
 	: m_machine(machine),
-		m_instance(0)
+		m_instance(0),
+		m_work_queue(NULL)
 {
+	machine.add_notifier(MACHINE_NOTIFY_EXIT, machine_notify_delegate(FUNC(tilemap_manager::exit), this));
 }
 
 
@@ -1497,6 +1793,10 @@ tilemap_manager::tilemap_manager(running_machine &machine)
 
 tilemap_manager::~tilemap_manager()
 {
+	// free the work queue
+	if (m_work_queue != NULL)
+		osd_work_queue_free(m_work_queue);
+
 	// detach all device tilemaps since they will be destroyed
 	// as subdevices elsewhere
 	bool found = true;
@@ -1514,6 +1814,39 @@ tilemap_manager::~tilemap_manager()
 }
 
 
+//-------------------------------------------------
+//  work_queue - return the queue shared by all
+//  tilemaps, allocating it the first time a
+//  tilemap has enough work to split up
+//-------------------------------------------------
+
+osd_work_queue *tilemap_manager::work_queue()
+{
+	if (m_work_queue == NULL)
+		m_work_queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI | WORK_QUEUE_FLAG_HIGH_FREQ);
+	return m_work_queue;
+}
+
+
+//-------------------------------------------------
+//  exit - report drawing statistics for each
+//  tilemap
+//-------------------------------------------------
+
+void tilemap_manager::exit()
+{
+	osd_ticks_t tps = osd_ticks_per_second();
+	int index = 0;
+	for (tilemap_t *tmap = m_tilemap_list.first(); tmap != NULL; tmap = tmap->next(), index++)
+		if (tmap->draw_calls() != 0)
+			osd_printf_verbose("Tilemap %d (%s): %d draws, %d tiles updated, %.3f ms total, %.3f ms/draw\n", index,
+					(tmap->device() != NULL) ? tmap->device()->tag() : "legacy",
+					tmap->draw_calls(), tmap->tiles_updated(),
+					(double)tmap->draw_ticks() * 1000.0 / (double)tps,
+					(double)tmap->draw_ticks() * 1000.0 / (double)tps / (double)tmap->draw_calls());
+}
+
+
 //-------------------------------------------------
 //  set_flip_all - set a global flip for all the
 //  tilemaps
@@ -486,6 +486,11 @@ class tilemap_t
 	// maximum index in each array
 	static const int MAX_PEN_TO_FLAGS = 256;
 
+	// threaded rendering thresholds
+	static const int MAX_WORK_SLICES = WORK_MAX_THREADS;    // maximum number of slices handed to the work queue
+	static const int MIN_SLICE_ROWS = 16;                   // minimum number of scanlines per drawing slice
+	static const int MIN_SLICE_TILES = 32;                  // minimum number of dirty tiles per rendering slice
+
 protected:
 	// tilemap_manager controlls our allocations
 	tilemap_t();
@@ -514,6 +519,9 @@ public:
 	bitmap_ind8 &flagsmap() { pixmap_update(); return m_flagsmap; }
 	UINT8 *tile_flags() { pixmap_update(); return &m_tileflags[0]; }
 	tilemap_memory_index memory_index(UINT32 col, UINT32 row) { return m_mapper(col, row, m_cols, m_rows); }
+	osd_ticks_t draw_ticks() const { return m_draw_ticks; }
+	UINT32 draw_calls() const { return m_draw_calls; }
+	UINT32 tiles_updated() const { return m_tiles_updated; }
 
 	// setters
 	void enable(bool enable = true) { m_enable = enable; }
@@ -587,10 +595,39 @@ private:
 		UINT8               alpha;
 	};
 
+	// a single instance of the tilemap to be drawn, collected by draw_common
+	struct instance_parameters
+	{
+		blit_parameters     blit;
+		int                 xpos;
+		int                 ypos;
+	};
+
+	// a dirty tile whose info has been fetched but which has not yet been rendered
+	struct pending_tile
+	{
+		logical_index       logindex;
+		UINT32              col;
+		UINT32              row;
+		tile_data           info;
+	};
+
+	// a slice of work handed off to the tilemap work queue
+	struct work_slice
+	{
+		tilemap_t *         tilemap;
+		screen_device *     screen;
+		void *              dest;
+		int                 start;
+		int                 end;
+		INT32 volatile      claimed;        // nonzero once a worker or the caller has taken it
+	};
+
 	// inline helpers
 	INT32 effective_rowscroll(int index, UINT32 screen_width);
 	INT32 effective_colscroll(int index, UINT32 screen_height);
 	bool gfx_elements_changed();
+	void queue_instance(const blit_parameters &blit, int xpos, int ypos);
 
 	// inline scanline rasterizers
 	void scanline_draw_opaque_null(int count, UINT8 *pri, UINT32 pcode);
@@ -611,12 +648,21 @@ private:
 	// internal drawing
 	void pixmap_update();
 	void tile_update(logical_index logindex, UINT32 col, UINT32 row);
+	void tile_fetch_info(logical_index logindex);
+	UINT8 tile_render(const tile_data &tileinfo, UINT32 col, UINT32 row);
+	void tile_queue_update(logical_index logindex, UINT32 col, UINT32 row);
+	void realize_pending_tiles();
+	void run_slices(osd_work_queue *queue, osd_work_callback callback, int slices);
+	void realize_instance_tiles(const blit_parameters &blit, int xpos, int ypos);
+	static void *render_tiles_callback(void *param, int threadid);
 	UINT8 tile_draw(const UINT8 *pendata, UINT32 x0, UINT32 y0, UINT32 palette_base, UINT8 category, UINT8 group, UINT8 flags, UINT8 pen_mask);
 	UINT8 tile_apply_bitmask(const UINT8 *maskdata, UINT32 x0, UINT32 y0, UINT8 category, UINT8 flags);
 	void configure_blit_parameters(blit_parameters &blit, bitmap_ind8 &priority_bitmap, const rectangle &cliprect, UINT32 flags, UINT8 priority, UINT8 priority_mask);
 	template<class _BitmapClass> void draw_common(screen_device &screen, _BitmapClass &dest, const rectangle &cliprect, UINT32 flags, UINT8 priority, UINT8 priority_mask);
 	template<class _BitmapClass> void draw_roz_common(screen_device &screen, _BitmapClass &dest, const rectangle &cliprect, UINT32 startx, UINT32 starty, int incxx, int incxy, int incyx, int incyy, bool wraparound, UINT32 flags, UINT8 priority, UINT8 priority_mask);
 	template<class _BitmapClass> void draw_instance(screen_device &screen, _BitmapClass &dest, const blit_parameters &blit, int xpos, int ypos);
+	template<class _BitmapClass> void draw_all_instances(screen_device &screen, _BitmapClass &dest);
+	template<class _BitmapClass> static void *draw_slice_callback(void *param, int threadid);
 	template<class _BitmapClass> void draw_roz_core(screen_device &screen, _BitmapClass &destbitmap, const blit_parameters &blit, UINT32 startx, UINT32 starty, int incxx, int incxy, int incyx, int incyy, bool wraparound);
 
 	// managers and devices
@@ -673,6 +719,16 @@ private:
 	bitmap_ind8                 m_flagsmap;             // per-pixel flags
 	std::vector<UINT8>               m_tileflags;            // per-tile flags
 	UINT8                       m_pen_to_flags[MAX_PEN_TO_FLAGS * TILEMAP_NUM_GROUPS]; // mapping of pens to flags
+
+	// threaded rendering state
+	std::vector<instance_parameters> m_instances;        // instances collected by the current draw
+	std::vector<pending_tile>   m_pending;              // dirty tiles waiting to be rendered
+	work_slice                  m_slices[MAX_WORK_SLICES]; // slices handed to the work queue
+
+	// statistics
+	osd_ticks_t                 m_draw_ticks;           // total ticks spent drawing and updating
+	UINT32                      m_draw_calls;           // number of draw calls made
+	UINT32                      m_tiles_updated;        // number of tiles rendered into the pixmap
 };
 
 
@@ -690,6 +746,7 @@ public:
 
 	// getters
 	running_machine &machine() const { return m_machine; }
+	osd_work_queue *work_queue();
 
 	// tilemap creation
 	tilemap_t &create(device_gfx_interface &decoder, tilemap_get_info_delegate tile_get_info, tilemap_mapper_delegate mapper, int tilewidth, int tileheight, int cols, int rows, tilemap_t *allocated = NULL);
@@ -707,10 +764,14 @@ private:
 	// allocate an instance index
 	int alloc_instance() { return ++m_instance; }
 
+	// internal helpers
+	void exit();
+
 	// internal state
 	running_machine &       m_machine;
 	simple_list<tilemap_t>  m_tilemap_list;
 	int                     m_instance;
+	osd_work_queue *        m_work_queue;       // allocated on first use by a split tilemap
 };
 
 
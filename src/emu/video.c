@@ -115,6 +115,7 @@ video_manager::video_manager(running_machine &machine)
 
 	// extract initial execution state from global configuration settings
 	update_refresh_speed();
+	drawgfx_set_simd(machine.options().simd_blit());
 
 	// create a render target for snapshots
 	const char *viewname = machine.options().snap_view();
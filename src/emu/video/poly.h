@@ -61,11 +61,13 @@
 #define POLYFLAG_INCLUDE_BOTTOM_EDGE        0x01
 #define POLYFLAG_INCLUDE_RIGHT_EDGE         0x02
 #define POLYFLAG_NO_WORK_QUEUE              0x04
+#define POLYFLAG_BINNED                     0x08        // defer rendering to wait() and render by screen bin
 
 #define SCANLINES_PER_BUCKET                8
 #define CACHE_LINE_SIZE                     64          // this is a general guess
 #define TOTAL_BUCKETS                       (512 / SCANLINES_PER_BUCKET)
 #define UNITS_PER_POLY                      (100 / SCANLINES_PER_BUCKET)
+#define BIN_GROUPS                          WORK_MAX_THREADS
 
 
 
@@ -130,6 +132,14 @@ public:
 	running_machine &machine() const { return m_machine; }
 	screen_device &screen() const { assert(m_screen != NULL); return *m_screen; }
 
+	// statistics
+	UINT32 triangles() const { return m_triangles; }
+	UINT32 quads() const { return m_quads; }
+	UINT64 pixels() const { return m_pixels; }
+	UINT32 units() const { return m_units; }
+	UINT32 work_items() const { return m_work_items; }
+	osd_ticks_t wait_ticks() const { return m_wait_ticks; }
+
 	// synchronization
 	void wait(const char *debug_reason = "general");
 
@@ -168,13 +178,20 @@ private:
 		volatile UINT32     count_next;             // number of scanlines and index of next item to process
 		polygon_info *      polygon;                // pointer to polygon
 		INT16               scanline;               // starting scanline
-		UINT16              previtem;               // index of previous item in the same bucket
+		UINT16              previtem;               // index of previous item in the same bucket (next item once binned)
 	#ifndef PTR64
 		UINT32              dummy;                  // pad to 16 bytes
 	#endif
 		extent_t            extent[SCANLINES_PER_BUCKET]; // array of scanline extents
 	};
 
+	// a group of buckets rendered by a single work item in binned mode
+	struct bin_group
+	{
+		poly_manager *      m_owner;                // pointer back to the poly manager
+		int                 m_index;                // first bucket; the group owns every BIN_GROUPS'th bucket from here
+	};
+
 	// class for managing an array of items
 	template<class _Type, int _Count>
 	class poly_array
@@ -250,7 +267,20 @@ private:
 		return polygon;
 	}
 
+	// queue the work units from startunit onwards, unless they are being binned
+	void queue_units(UINT32 startunit)
+	{
+		UINT32 count = m_unit.count() - startunit;
+		m_units += count;
+		if (m_queue != NULL && !(m_flags & POLYFLAG_BINNED))
+		{
+			osd_work_item_queue_multiple(m_queue, work_item_callback, count, &m_unit[startunit], m_unit.itemsize(), WORK_ITEM_FLAG_AUTO_RELEASE);
+			m_work_items += count;
+		}
+	}
+
 	static void *work_item_callback(void *param, int threadid);
+	static void *bin_callback(void *param, int threadid);
 	void presave() { wait("pre-save"); }
 
 	// queue management
@@ -268,12 +298,16 @@ private:
 
 	// buckets
 	UINT16              m_unit_bucket[TOTAL_BUCKETS]; // buckets for tracking unit usage
+	bin_group           m_bin_group[BIN_GROUPS];    // bucket groups for binned rendering
 
 	// statistics
 	UINT32              m_tiles;                    // number of tiles queued
 	UINT32              m_triangles;                // number of triangles queued
 	UINT32              m_quads;                    // number of quads queued
 	UINT64              m_pixels;                   // number of pixels rendered
+	UINT32              m_units;                    // number of work units built
+	UINT32              m_work_items;               // number of work items queued
+	osd_ticks_t         m_wait_ticks;               // time spent waiting for work to complete
 #if KEEP_POLY_STATISTICS
 	UINT32              m_conflicts[WORK_MAX_THREADS]; // number of conflicts found, per thread
 	UINT32              m_resolved[WORK_MAX_THREADS];   // number of conflicts resolved, per thread
@@ -294,15 +328,27 @@ poly_manager<_BaseType, _ObjectData, _MaxParams, _MaxPolys>::poly_manager(runnin
 		m_object(machine, *this),
 		m_unit(machine, *this),
 		m_flags(flags),
+		m_tiles(0),
 		m_triangles(0),
 		m_quads(0),
-		m_pixels(0)
+		m_pixels(0),
+		m_units(0),
+		m_work_items(0),
+		m_wait_ticks(0)
 {
 #if KEEP_POLY_STATISTICS
 	memset(m_conflicts, 0, sizeof(m_conflicts));
 	memset(m_resolved, 0, sizeof(m_resolved));
 #endif
 
+	// start with empty buckets, and assign them to bin groups
+	memset(m_unit_bucket, 0xff, sizeof(m_unit_bucket));
+	for (int groupnum = 0; groupnum < BIN_GROUPS; groupnum++)
+	{
+		m_bin_group[groupnum].m_owner = this;
+		m_bin_group[groupnum].m_index = groupnum;
+	}
+
 	// create the work queue
 	if (!(flags & POLYFLAG_NO_WORK_QUEUE))
 		m_queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI | WORK_QUEUE_FLAG_HIGH_FREQ);
@@ -321,15 +367,27 @@ poly_manager<_BaseType, _ObjectData, _MaxParams, _MaxPolys>::poly_manager(screen
 		m_object(screen.machine(), *this),
 		m_unit(screen.machine(), *this),
 		m_flags(flags),
+		m_tiles(0),
 		m_triangles(0),
 		m_quads(0),
-		m_pixels(0)
+		m_pixels(0),
+		m_units(0),
+		m_work_items(0),
+		m_wait_ticks(0)
 {
 #if KEEP_POLY_STATISTICS
 	memset(m_conflicts, 0, sizeof(m_conflicts));
 	memset(m_resolved, 0, sizeof(m_resolved));
 #endif
 
+	// start with empty buckets, and assign them to bin groups
+	memset(m_unit_bucket, 0xff, sizeof(m_unit_bucket));
+	for (int groupnum = 0; groupnum < BIN_GROUPS; groupnum++)
+	{
+		m_bin_group[groupnum].m_owner = this;
+		m_bin_group[groupnum].m_index = groupnum;
+	}
+
 	// create the work queue
 	if (!(flags & POLYFLAG_NO_WORK_QUEUE))
 		m_queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI | WORK_QUEUE_FLAG_HIGH_FREQ);
@@ -365,6 +423,7 @@ poly_manager<_BaseType, _ObjectData, _MaxParams, _MaxPolys>::~poly_manager()
 		printf("Total pixels   = %d\n", (UINT32)m_pixels);
 
 	printf("Conflicts:   %d resolved, %d total\n", resolved, conflicts);
+	printf("Work items:  %d queued for %d units%s, %d ms waiting\n", m_work_items, m_units, (m_flags & POLYFLAG_BINNED) ? " (binned)" : "", (int)(m_wait_ticks * 1000 / osd_ticks_per_second()));
 	printf("Units:       %5d used, %5d allocated, %5d waits, %4d bytes each, %7d total\n", m_unit.max(), m_unit.allocated(), m_unit.waits(), m_unit.itemsize(), m_unit.allocated() * m_unit.itemsize());
 	printf("Polygons:    %5d used, %5d allocated, %5d waits, %4d bytes each, %7d total\n", m_polygon.max(), m_polygon.allocated(), m_polygon.waits(), m_polygon.itemsize(), m_polygon.allocated() * m_polygon.itemsize());
 	printf("Object data: %5d used, %5d allocated, %5d waits, %4d bytes each, %7d total\n", m_object.max(), m_object.allocated(), m_object.waits(), m_object.itemsize(), m_object.allocated() * m_object.itemsize());
@@ -439,6 +498,45 @@ void *poly_manager<_BaseType, _ObjectData, _MaxParams, _MaxPolys>::work_item_cal
 }
 
 
+//-------------------------------------------------
+//  bin_callback - render all the buckets in a
+//  bin group
+//-------------------------------------------------
+
+template<typename _BaseType, class _ObjectData, int _MaxParams, int _MaxPolys>
+void *poly_manager<_BaseType, _ObjectData, _MaxParams, _MaxPolys>::bin_callback(void *param, int threadid)
+{
+	bin_group &group = *(bin_group *)param;
+	poly_manager &owner = *group.m_owner;
+
+	// no other work item touches our buckets, so no conflicts can arise here
+	for (int bucketnum = group.m_index; bucketnum < TOTAL_BUCKETS; bucketnum += BIN_GROUPS)
+	{
+		// bucket chains run newest first; reverse ours so polygons render in submission order
+		UINT32 headitem = 0xffff;
+		for (UINT32 unitnum = owner.m_unit_bucket[bucketnum]; unitnum != 0xffff; )
+		{
+			work_unit &unit = owner.m_unit[unitnum];
+			UINT32 previtem = unit.previtem;
+			unit.previtem = headitem;
+			headitem = unitnum;
+			unitnum = previtem;
+		}
+
+		// iterate over units and their extents
+		for (UINT32 unitnum = headitem; unitnum != 0xffff; unitnum = owner.m_unit[unitnum].previtem)
+		{
+			work_unit &unit = owner.m_unit[unitnum];
+			polygon_info &polygon = *unit.polygon;
+			int count = unit.count_next & 0xffff;
+			for (int curscan = 0; curscan < count; curscan++)
+				polygon.m_callback(unit.scanline + curscan, unit.extent[curscan], *polygon.m_object, threadid);
+		}
+	}
+	return NULL;
+}
+
+
 //-------------------------------------------------
 //  wait - stall until all work is complete
 //-------------------------------------------------
@@ -447,11 +545,19 @@ template<typename _BaseType, class _ObjectData, int _MaxParams, int _MaxPolys>
 void poly_manager<_BaseType, _ObjectData, _MaxParams, _MaxPolys>::wait(const char *debug_reason)
 {
 	osd_ticks_t time;
+	osd_ticks_t starttime = osd_ticks();
 
 	// remember the start time if we're logging
 	if (LOG_WAITS)
 		time = get_profile_ticks();
 
+	// in binned mode, this is where the work gets handed out: one work item per group of buckets
+	if (m_queue != NULL && (m_flags & POLYFLAG_BINNED) && m_unit.count() > 0)
+	{
+		osd_work_item_queue_multiple(m_queue, bin_callback, BIN_GROUPS, &m_bin_group[0], sizeof(m_bin_group[0]), WORK_ITEM_FLAG_AUTO_RELEASE);
+		m_work_items += BIN_GROUPS;
+	}
+
 	// wait for all pending work items to complete
 	if (m_queue != NULL)
 		osd_work_queue_wait(m_queue, osd_ticks_per_second() * 100);
@@ -469,6 +575,8 @@ void poly_manager<_BaseType, _ObjectData, _MaxParams, _MaxPolys>::wait(const cha
 			logerror("Poly:Waited %d cycles for %s\n", (int)time, debug_reason);
 	}
 
+	m_wait_ticks += osd_ticks() - starttime;
+
 	// reset the state
 	m_polygon.reset();
 	m_unit.reset();
@@ -620,8 +728,7 @@ UINT32 poly_manager<_BaseType, _ObjectData, _MaxParams, _MaxPolys>::render_tile(
 	}
 
 	// enqueue the work items
-	if (m_queue != NULL)
-		osd_work_item_queue_multiple(m_queue, work_item_callback, m_unit.count() - startunit, &m_unit[startunit], m_unit.itemsize(), WORK_ITEM_FLAG_AUTO_RELEASE);
+	queue_units(startunit);
 
 	// return the total number of pixels in the triangle
 	m_tiles++;
@@ -808,8 +915,7 @@ UINT32 poly_manager<_BaseType, _ObjectData, _MaxParams, _MaxPolys>::render_trian
 	}
 
 	// enqueue the work items
-	if (m_queue != NULL)
-		osd_work_item_queue_multiple(m_queue, work_item_callback, m_unit.count() - startunit, &m_unit[startunit], m_unit.itemsize(), WORK_ITEM_FLAG_AUTO_RELEASE);
+	queue_units(startunit);
 
 	// return the total number of pixels in the triangle
 	m_triangles++;
@@ -924,8 +1030,7 @@ UINT32 poly_manager<_BaseType, _ObjectData, _MaxParams, _MaxPolys>::render_trian
 	}
 
 	// enqueue the work items
-	if (m_queue != NULL)
-		osd_work_item_queue_multiple(m_queue, work_item_callback, m_unit.count() - startunit, &m_unit[startunit], m_unit.itemsize(), WORK_ITEM_FLAG_AUTO_RELEASE);
+	queue_units(startunit);
 
 	// return the total number of pixels in the object
 	m_triangles++;
@@ -1123,8 +1228,7 @@ UINT32 poly_manager<_BaseType, _ObjectData, _MaxParams, _MaxPolys>::render_polyg
 	}
 
 	// enqueue the work items
-	if (m_queue != NULL)
-		osd_work_item_queue_multiple(m_queue, work_item_callback, m_unit.count() - startunit, &m_unit[startunit], m_unit.itemsize(), WORK_ITEM_FLAG_AUTO_RELEASE);
+	queue_units(startunit);
 
 	// return the total number of pixels in the triangle
 	m_quads++;
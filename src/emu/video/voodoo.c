@@ -234,9 +234,6 @@ static void dump_rasterizer_stats(voodoo_state *v);
 
 /* generic rasterizers */
 static void raster_fastfill(void *dest, INT32 scanline, const poly_extent *extent, const void *extradata, int threadid);
-static void raster_generic_0tmu(void *dest, INT32 scanline, const poly_extent *extent, const void *extradata, int threadid);
-static void raster_generic_1tmu(void *dest, INT32 scanline, const poly_extent *extent, const void *extradata, int threadid);
-static void raster_generic_2tmu(void *dest, INT32 scanline, const poly_extent *extent, const void *extradata, int threadid);
 
 
 
@@ -274,6 +271,67 @@ static const raster_info predef_raster_table[] =
 
 
 
+/*************************************
+ *
+ *  Feature-specialised rasterizers
+ *
+ *************************************/
+
+/*
+    Register combinations that are not in the table above get one
+    of these rather than a fully generic rasterizer that tests every
+    mode bit per pixel. They are generic except for the handful of
+    enable bits that gate the most expensive per-pixel work; those
+    are forced to constants so the compiler can drop the disabled
+    paths. Forcing the bits is safe because a rasterizer is only
+    ever chosen for register values whose bits already match.
+*/
+
+#define RASTER_FEATURE_ALPHATEST    0x01    /* alphaMode bit 0 */
+#define RASTER_FEATURE_ALPHABLEND   0x02    /* alphaMode bit 4 */
+#define RASTER_FEATURE_FOG          0x04    /* fogMode bit 0 */
+#define RASTER_FEATURE_DEPTHBUF     0x08    /* fbzMode bit 4 */
+#define RASTER_FEATURE_COUNT        16
+
+#define FORCE_BIT(val, bit, state)  (((val) & ~(1 << (bit))) | ((state) ? (1 << (bit)) : 0))
+
+#define FEATURE_RASTERIZER(TMUS, FEATURES) \
+	RASTERIZER(features_##TMUS##_##FEATURES, TMUS, v->reg[fbzColorPath].u, \
+			FORCE_BIT(v->reg[fbzMode].u, 4, (FEATURES) & RASTER_FEATURE_DEPTHBUF), \
+			FORCE_BIT(FORCE_BIT(v->reg[alphaMode].u, 0, (FEATURES) & RASTER_FEATURE_ALPHATEST), 4, (FEATURES) & RASTER_FEATURE_ALPHABLEND), \
+			FORCE_BIT(v->reg[fogMode].u, 0, (FEATURES) & RASTER_FEATURE_FOG), \
+			((TMUS) >= 1) ? v->tmu[0].reg[textureMode].u : 0, \
+			((TMUS) >= 2) ? v->tmu[1].reg[textureMode].u : 0)
+
+#define FEATURE_RASTERIZER_SET(TMUS) \
+	FEATURE_RASTERIZER(TMUS, 0)  FEATURE_RASTERIZER(TMUS, 1)  FEATURE_RASTERIZER(TMUS, 2)  FEATURE_RASTERIZER(TMUS, 3) \
+	FEATURE_RASTERIZER(TMUS, 4)  FEATURE_RASTERIZER(TMUS, 5)  FEATURE_RASTERIZER(TMUS, 6)  FEATURE_RASTERIZER(TMUS, 7) \
+	FEATURE_RASTERIZER(TMUS, 8)  FEATURE_RASTERIZER(TMUS, 9)  FEATURE_RASTERIZER(TMUS, 10) FEATURE_RASTERIZER(TMUS, 11) \
+	FEATURE_RASTERIZER(TMUS, 12) FEATURE_RASTERIZER(TMUS, 13) FEATURE_RASTERIZER(TMUS, 14) FEATURE_RASTERIZER(TMUS, 15)
+
+FEATURE_RASTERIZER_SET(0)
+FEATURE_RASTERIZER_SET(1)
+FEATURE_RASTERIZER_SET(2)
+
+#define FEATURE_RASTERIZER_ROW(TMUS) \
+	{ raster_features_##TMUS##_0,  raster_features_##TMUS##_1,  raster_features_##TMUS##_2,  raster_features_##TMUS##_3, \
+		raster_features_##TMUS##_4,  raster_features_##TMUS##_5,  raster_features_##TMUS##_6,  raster_features_##TMUS##_7, \
+		raster_features_##TMUS##_8,  raster_features_##TMUS##_9,  raster_features_##TMUS##_10, raster_features_##TMUS##_11, \
+		raster_features_##TMUS##_12, raster_features_##TMUS##_13, raster_features_##TMUS##_14, raster_features_##TMUS##_15 }
+
+static const poly_draw_scanline_func feature_raster_table[3][RASTER_FEATURE_COUNT] =
+{
+	FEATURE_RASTERIZER_ROW(0),
+	FEATURE_RASTERIZER_ROW(1),
+	FEATURE_RASTERIZER_ROW(2)
+};
+
+#undef FEATURE_RASTERIZER_ROW
+#undef FEATURE_RASTERIZER_SET
+#undef FEATURE_RASTERIZER
+
+
+
 /***************************************************************************
     INLINE FUNCTIONS
 ***************************************************************************/
@@ -5755,8 +5813,17 @@ static raster_info *find_rasterizer(voodoo_state *v, int texcount)
 			return info;
 		}
 
-	/* generate a new one using the generic entry */
-	curinfo.callback = (texcount == 0) ? raster_generic_0tmu : (texcount == 1) ? raster_generic_1tmu : raster_generic_2tmu;
+	/* generate a new one using the matching feature-specialised entry */
+	int features = 0;
+	if (ALPHAMODE_ALPHATEST(curinfo.eff_alpha_mode))
+		features |= RASTER_FEATURE_ALPHATEST;
+	if (ALPHAMODE_ALPHABLEND(curinfo.eff_alpha_mode))
+		features |= RASTER_FEATURE_ALPHABLEND;
+	if (FOGMODE_ENABLE_FOG(curinfo.eff_fog_mode))
+		features |= RASTER_FEATURE_FOG;
+	if (FBZMODE_ENABLE_DEPTHBUF(curinfo.eff_fbz_mode))
+		features |= RASTER_FEATURE_DEPTHBUF;
+	curinfo.callback = feature_raster_table[texcount][features];
 	curinfo.is_generic = TRUE;
 	curinfo.display = 0;
 	curinfo.polys = 0;
@@ -5997,30 +6064,6 @@ static void raster_fastfill(void *destbase, INT32 y, const poly_extent *extent,
 }
 
 
-/*-------------------------------------------------
-    generic_0tmu - generic rasterizer for 0 TMUs
--------------------------------------------------*/
-
-RASTERIZER(generic_0tmu, 0, v->reg[fbzColorPath].u, v->reg[fbzMode].u, v->reg[alphaMode].u,
-			v->reg[fogMode].u, 0, 0)
-
-
-/*-------------------------------------------------
-    generic_1tmu - generic rasterizer for 1 TMU
--------------------------------------------------*/
-
-RASTERIZER(generic_1tmu, 1, v->reg[fbzColorPath].u, v->reg[fbzMode].u, v->reg[alphaMode].u,
-			v->reg[fogMode].u, v->tmu[0].reg[textureMode].u, 0)
-
-
-/*-------------------------------------------------
-    generic_2tmu - generic rasterizer for 2 TMUs
--------------------------------------------------*/
-
-RASTERIZER(generic_2tmu, 2, v->reg[fbzColorPath].u, v->reg[fbzMode].u, v->reg[alphaMode].u,
-			v->reg[fogMode].u, v->tmu[0].reg[textureMode].u, v->tmu[1].reg[textureMode].u)
-
-
 #else
 
 
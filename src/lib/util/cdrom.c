@@ -116,6 +116,8 @@ struct cdrom_file
 	chdcd_track_input_info track_info;      /* track info */
 	/** @brief  The fhandle[ CD maximum tracks]. */
 	core_file *         fhandle[CD_MAX_TRACKS];/* file handle */
+	/** @brief  The last hunk read, for prefetching. */
+	UINT32              lasthunk;           /* last hunk read */
 };
 
 
@@ -337,6 +339,7 @@ cdrom_file *cdrom_open(chd_file *chd)
 
 	/* fill in the data */
 	file->chd = chd;
+	file->lasthunk = ~0;
 
 	/* read the CD-ROM metadata */
 	err = cdrom_parse_metadata(chd, &file->cdtoc);
@@ -464,6 +467,14 @@ chd_error read_partial_sector(cdrom_file *file, void *dest, UINT32 lbasector, UI
 	if (file->chd != NULL)
 	{
 		result = file->chd->read_bytes(UINT64(chdsector) * UINT64(CD_FRAME_SIZE) + startoffs, dest, length);
+
+		/* when we move onto a new hunk, start fetching the next one in the background */
+		UINT32 hunk = UINT64(chdsector) * UINT64(CD_FRAME_SIZE) / file->chd->hunk_bytes();
+		if (hunk != file->lasthunk)
+		{
+			file->lasthunk = hunk;
+			file->chd->read_hunk_async(hunk + 1);
+		}
 		/* swap CDDA in the case of LE GDROMs */
 		if ((file->cdtoc.flags & CD_FLAG_GDROMLE) && (file->cdtoc.tracks[tracknum].trktype == CD_TRACK_AUDIO))
 			needswap = true;
@@ -119,6 +119,19 @@ struct chd_file::metadata_hash
 };
 
 
+// ======================> async_request
+
+// a pending asynchronous hunk read
+struct chd_file::async_request
+{
+	chd_file *              m_chd;          // file being read
+	UINT32                  m_hunknum;      // hunk to read
+	UINT8 *                 m_buffer;       // destination, or NULL for the read-ahead ring
+	chd_async_callback      m_callback;     // completion callback, or NULL
+	void *                  m_param;        // parameter to the callback
+};
+
+
 
 //**************************************************************************
 //  INLINE FUNCTIONS
@@ -189,9 +202,11 @@ inline void chd_file::file_read(UINT64 offset, void *dest, UINT32 length)
 	if (m_file == NULL)
 		throw CHDERR_NOT_OPEN;
 
-	// seek and read
+	// seek and read; read-ahead may be doing the same on another thread
+	osd_lock_acquire(m_file_lock);
 	core_fseek(m_file, offset, SEEK_SET);
 	UINT32 count = core_fread(m_file, dest, length);
+	osd_lock_release(m_file_lock);
 	if (count != length)
 		throw CHDERR_READ_ERROR;
 }
@@ -289,10 +304,19 @@ inline UINT8 chd_file::bits_for_value(UINT64 value)
 
 chd_file::chd_file()
 	: m_file(NULL),
-		m_owns_file(false)
+		m_owns_file(false),
+		m_file_lock(osd_lock_alloc()),
+		m_mapped(NULL),
+		m_mapped_length(0),
+		m_cache_size(0),
+		m_cache_lock(osd_lock_alloc()),
+		m_readahead_size(0),
+		m_readahead_lock(osd_lock_alloc()),
+		m_readahead_queue(NULL)
 {
 	// reset state
 	memset(m_decompressor, 0, sizeof(m_decompressor));
+	memset(m_readahead_decompressor, 0, sizeof(m_readahead_decompressor));
 	close();
 }
 
@@ -308,6 +332,11 @@ chd_file::~chd_file()
 {
 	// close any open files
 	close();
+
+	// free the locks
+	osd_lock_free(m_readahead_lock);
+	osd_lock_free(m_cache_lock);
+	osd_lock_free(m_file_lock);
 }
 
 /**
@@ -566,6 +595,50 @@ void chd_file::set_parent_sha1(sha1_t parent)
 	file_write(m_parentsha1_offset, rawbuf, sizeof(rawbuf));
 }
 
+/**
+ * @fn  void chd_file::set_cache_size(UINT32 hunks)
+ *
+ * @brief   -------------------------------------------------
+ *            set_cache_size - set the number of decompressed hunks kept in the cache; 0 selects
+ *            a default based on the hunk size
+ *          -------------------------------------------------.
+ *
+ * @param   hunks   The number of hunks.
+ */
+
+void chd_file::set_cache_size(UINT32 hunks)
+{
+	osd_lock_acquire(m_cache_lock);
+	m_cache_size = hunks;
+	if (m_file != NULL)
+		cache_allocate();
+	osd_lock_release(m_cache_lock);
+}
+
+/**
+ * @fn  void chd_file::set_readahead(UINT32 hunks)
+ *
+ * @brief   -------------------------------------------------
+ *            set_readahead - set the number of hunks to decompress ahead of sequential reads
+ *            on a worker thread; 0 disables read-ahead
+ *          -------------------------------------------------.
+ *
+ * @param   hunks   The number of hunks.
+ */
+
+void chd_file::set_readahead(UINT32 hunks)
+{
+	// let any pass in flight finish; the ring is reallocated on next use
+	if (m_readahead_queue != NULL)
+		osd_work_queue_wait(m_readahead_queue, osd_ticks_per_second() * 100);
+	osd_lock_acquire(m_readahead_lock);
+	m_readahead_size = hunks;
+	m_readahead_end = 0;
+	m_readahead_buffer.clear();
+	m_readahead_hunk.clear();
+	osd_lock_release(m_readahead_lock);
+}
+
 /**
  * @fn  chd_error chd_file::create(core_file &file, UINT64 logicalbytes, UINT32 hunkbytes, UINT32 unitbytes, chd_codec_type compression[4])
  *
@@ -795,6 +868,14 @@ chd_error chd_file::open(core_file &file, bool writeable, chd_file *parent)
 
 void chd_file::close()
 {
+	// let any read-ahead finish before the codecs and file go away
+	if (m_readahead_queue != NULL)
+	{
+		osd_work_queue_wait(m_readahead_queue, osd_ticks_per_second() * 100);
+		osd_work_queue_free(m_readahead_queue);
+		m_readahead_queue = NULL;
+	}
+
 	// reset file characteristics
 	if (m_owns_file && m_file != NULL)
 		core_fclose(m_file);
@@ -802,6 +883,9 @@ void chd_file::close()
 	m_owns_file = false;
 	m_allow_reads = false;
 	m_allow_writes = false;
+	m_mapped = NULL;
+	m_mapped_length = 0;
+	m_mapped_verified.clear();
 
 	// reset core parameters from the header
 	m_version = HEADER_VERSION;
@@ -832,12 +916,34 @@ void chd_file::close()
 	{
 		delete m_decompressor[decompnum];
 		m_decompressor[decompnum] = NULL;
+		delete m_readahead_decompressor[decompnum];
+		m_readahead_decompressor[decompnum] = NULL;
 	}
 	m_compressed.clear();
 
 	// reset caching
 	m_cache.clear();
-	m_cachehunk = ~0;
+	m_cachehunk.clear();
+	m_cachestamp.clear();
+	m_cacheclock = 0;
+	m_cachelast = 0;
+	m_lasthunk = ~0;
+
+	// reset read-ahead
+	m_readahead_allowed = false;
+	m_readahead_busy = false;
+	m_readahead_next = 0;
+	m_readahead_end = 0;
+	m_readahead_compressed.clear();
+	m_readahead_buffer.clear();
+	m_readahead_hunk.clear();
+
+	// reset statistics
+	m_cache_hits = 0;
+	m_cache_misses = 0;
+	m_readahead_hits = 0;
+	m_decompress_ticks = 0;
+	m_readahead_ticks = 0;
 }
 
 /**
@@ -865,128 +971,262 @@ void chd_file::close()
 
 chd_error chd_file::read_hunk(UINT32 hunknum, void *buffer)
 {
+	// uncompressed hunks of mapped files are a straight copy
+	const UINT8 *source = mapped_hunk(hunknum);
+	if (source != NULL && buffer != NULL)
+	{
+		memcpy(buffer, source, m_hunkbytes);
+		return CHDERR_NONE;
+	}
+
 	// wrap this for clean reporting
 	try
 	{
-		// punt if no file
-		if (m_file == NULL)
-			throw CHDERR_NOT_OPEN;
+		read_hunk_internal(hunknum, reinterpret_cast<UINT8 *>(buffer), m_decompressor, m_compressed);
+		return CHDERR_NONE;
+	}
 
-		// return an error if out of range
-		if (hunknum >= m_hunkcount)
-			throw CHDERR_HUNK_OUT_OF_RANGE;
+	// just return errors
+	catch (chd_error &err)
+	{
+		return err;
+	}
+}
 
-		// get a pointer to the map entry
-		UINT64 blockoffs;
-		UINT32 blocklen;
-		UINT32 blockcrc;
-		UINT8 *rawmap;
-		UINT8 *dest = reinterpret_cast<UINT8 *>(buffer);
-		switch (m_version)
-		{
-			// v3/v4 map entries
-			case 3:
-			case 4:
-				rawmap = &m_rawmap[16 * hunknum];
-				blockoffs = be_read(&rawmap[0], 8);
-				blockcrc = be_read(&rawmap[8], 4);
-				switch (rawmap[15] & V34_MAP_ENTRY_FLAG_TYPE_MASK)
-				{
-					case V34_MAP_ENTRY_TYPE_COMPRESSED:
-						blocklen = be_read(&rawmap[12], 2) + (rawmap[14] << 16);
-						file_read(blockoffs, &m_compressed[0], blocklen);
-						m_decompressor[0]->decompress(&m_compressed[0], blocklen, dest, m_hunkbytes);
-						if (!(rawmap[15] & V34_MAP_ENTRY_FLAG_NO_CRC) && dest != NULL && crc32_creator::simple(dest, m_hunkbytes) != blockcrc)
-							throw CHDERR_DECOMPRESSION_ERROR;
-						return CHDERR_NONE;
-
-					case V34_MAP_ENTRY_TYPE_UNCOMPRESSED:
-						file_read(blockoffs, dest, m_hunkbytes);
-						if (!(rawmap[15] & V34_MAP_ENTRY_FLAG_NO_CRC) && crc32_creator::simple(dest, m_hunkbytes) != blockcrc)
-							throw CHDERR_DECOMPRESSION_ERROR;
-						return CHDERR_NONE;
-
-					case V34_MAP_ENTRY_TYPE_MINI:
-						be_write(dest, blockoffs, 8);
-						for (UINT32 bytes = 8; bytes < m_hunkbytes; bytes++)
-							dest[bytes] = dest[bytes - 8];
-						if (!(rawmap[15] & V34_MAP_ENTRY_FLAG_NO_CRC) && crc32_creator::simple(dest, m_hunkbytes) != blockcrc)
-							throw CHDERR_DECOMPRESSION_ERROR;
-						return CHDERR_NONE;
-
-					case V34_MAP_ENTRY_TYPE_SELF_HUNK:
-						return read_hunk(blockoffs, dest);
-
-					case V34_MAP_ENTRY_TYPE_PARENT_HUNK:
-						if (m_parent_missing)
-							throw CHDERR_REQUIRES_PARENT;
-						return m_parent->read_hunk(blockoffs, dest);
-				}
-				break;
+/**
+ * @fn  bool chd_file::hunk_location(UINT32 hunknum, UINT64 &blockoffs, UINT32 &blocklen)
+ *
+ * @brief   -------------------------------------------------
+ *            hunk_location - find where a hunk's data is stored in this file, if it is stored
+ *            as a block of its own rather than as a reference to another hunk
+ *          -------------------------------------------------.
+ *
+ * @param   hunknum             The hunknum.
+ * @param [out] blockoffs       The offset of the stored block.
+ * @param [out] blocklen        The length of the stored block.
+ *
+ * @return  true if the hunk is stored as a block, false otherwise.
+ */
 
-			// v5 map entries
-			case 5:
-				rawmap = &m_rawmap[m_mapentrybytes * hunknum];
+bool chd_file::hunk_location(UINT32 hunknum, UINT64 &blockoffs, UINT32 &blocklen)
+{
+	if (m_file == NULL || hunknum >= m_hunkcount)
+		return false;
 
-				// uncompressed case
-				if (!compressed())
-				{
-					blockoffs = UINT64(be_read(rawmap, 4)) * UINT64(m_hunkbytes);
-					if (blockoffs != 0)
-						file_read(blockoffs, dest, m_hunkbytes);
-					else if (m_parent_missing)
-						throw CHDERR_REQUIRES_PARENT;
-					else if (m_parent != NULL)
-						m_parent->read_hunk(hunknum, dest);
-					else
-						memset(dest, 0, m_hunkbytes);
-					return CHDERR_NONE;
-				}
+	UINT8 *rawmap;
+	switch (m_version)
+	{
+		// v3/v4 map entries
+		case 3:
+		case 4:
+			rawmap = &m_rawmap[16 * hunknum];
+			blockoffs = be_read(&rawmap[0], 8);
+			switch (rawmap[15] & V34_MAP_ENTRY_FLAG_TYPE_MASK)
+			{
+				case V34_MAP_ENTRY_TYPE_COMPRESSED:
+					blocklen = be_read(&rawmap[12], 2) + (rawmap[14] << 16);
+					return true;
 
-				// compressed case
-				blocklen = be_read(&rawmap[1], 3);
-				blockoffs = be_read(&rawmap[4], 6);
-				blockcrc = be_read(&rawmap[10], 2);
-				switch (rawmap[0])
-				{
-					case COMPRESSION_TYPE_0:
-					case COMPRESSION_TYPE_1:
-					case COMPRESSION_TYPE_2:
-					case COMPRESSION_TYPE_3:
-						file_read(blockoffs, &m_compressed[0], blocklen);
-						m_decompressor[rawmap[0]]->decompress(&m_compressed[0], blocklen, dest, m_hunkbytes);
-						if (!m_decompressor[rawmap[0]]->lossy() && dest != NULL && crc16_creator::simple(dest, m_hunkbytes) != blockcrc)
-							throw CHDERR_DECOMPRESSION_ERROR;
-						if (m_decompressor[rawmap[0]]->lossy() && crc16_creator::simple(&m_compressed[0], blocklen) != blockcrc)
-							throw CHDERR_DECOMPRESSION_ERROR;
-						return CHDERR_NONE;
-
-					case COMPRESSION_NONE:
-						file_read(blockoffs, dest, m_hunkbytes);
-						if (crc16_creator::simple(dest, m_hunkbytes) != blockcrc)
-							throw CHDERR_DECOMPRESSION_ERROR;
-						return CHDERR_NONE;
+				case V34_MAP_ENTRY_TYPE_UNCOMPRESSED:
+					blocklen = m_hunkbytes;
+					return true;
+			}
+			return false;
 
-					case COMPRESSION_SELF:
-						return read_hunk(blockoffs, dest);
+		// v5 map entries
+		case 5:
+			rawmap = &m_rawmap[m_mapentrybytes * hunknum];
 
-					case COMPRESSION_PARENT:
-						if (m_parent_missing)
-							throw CHDERR_REQUIRES_PARENT;
-						return m_parent->read_bytes(UINT64(blockoffs) * UINT64(m_parent->unit_bytes()), dest, m_hunkbytes);
-				}
-				break;
-		}
+			// uncompressed case
+			if (!compressed())
+			{
+				blockoffs = UINT64(be_read(rawmap, 4)) * UINT64(m_hunkbytes);
+				blocklen = m_hunkbytes;
+				return (blockoffs != 0);
+			}
 
-		// if we get here, something was wrong
-		throw CHDERR_READ_ERROR;
+			// compressed case
+			blockoffs = be_read(&rawmap[4], 6);
+			switch (rawmap[0])
+			{
+				case COMPRESSION_TYPE_0:
+				case COMPRESSION_TYPE_1:
+				case COMPRESSION_TYPE_2:
+				case COMPRESSION_TYPE_3:
+					blocklen = be_read(&rawmap[1], 3);
+					return true;
+
+				case COMPRESSION_NONE:
+					blocklen = m_hunkbytes;
+					return true;
+			}
+			return false;
 	}
+	return false;
+}
 
-	// just return errors
-	catch (chd_error &err)
+/**
+ * @fn  void chd_file::read_hunk_internal(UINT32 hunknum, UINT8 *dest, chd_decompressor **decompressor, dynamic_buffer &compbuf, const UINT8 *source)
+ *
+ * @brief   -------------------------------------------------
+ *            read_hunk_internal - read a single hunk using the given decompressors and
+ *            compressed data buffer, so that read-ahead can run alongside the caller; if
+ *            source is given, it holds the block found by hunk_location, already read
+ *          -------------------------------------------------.
+ *
+ * @exception   CHDERR_NOT_OPEN             Thrown when a chderr not open error condition occurs.
+ * @exception   CHDERR_HUNK_OUT_OF_RANGE    Thrown when a chderr hunk out of range error
+ *                                          condition occurs.
+ * @exception   CHDERR_DECOMPRESSION_ERROR  Thrown when a chderr decompression error error
+ *                                          condition occurs.
+ * @exception   CHDERR_REQUIRES_PARENT      Thrown when a chderr requires parent error condition
+ *                                          occurs.
+ * @exception   CHDERR_READ_ERROR           Thrown when a chderr read error error condition
+ *                                          occurs.
+ *
+ * @param   hunknum                 The hunknum.
+ * @param [in,out]  dest            If non-null, the destination.
+ * @param [in,out]  decompressor    The decompressors to use.
+ * @param [in,out]  compbuf         The buffer for compressed data.
+ * @param   source                  If non-null, the hunk's stored data.
+ */
+
+void chd_file::read_hunk_internal(UINT32 hunknum, UINT8 *dest, chd_decompressor **decompressor, dynamic_buffer &compbuf, const UINT8 *source)
+{
+	// punt if no file
+	if (m_file == NULL)
+		throw CHDERR_NOT_OPEN;
+
+	// return an error if out of range
+	if (hunknum >= m_hunkcount)
+		throw CHDERR_HUNK_OUT_OF_RANGE;
+
+	// get a pointer to the map entry
+	UINT64 blockoffs;
+	UINT32 blocklen;
+	UINT32 blockcrc;
+	UINT8 *rawmap;
+	chd_error err;
+	switch (m_version)
 	{
-		return err;
+		// v3/v4 map entries
+		case 3:
+		case 4:
+			rawmap = &m_rawmap[16 * hunknum];
+			blockoffs = be_read(&rawmap[0], 8);
+			blockcrc = be_read(&rawmap[8], 4);
+			switch (rawmap[15] & V34_MAP_ENTRY_FLAG_TYPE_MASK)
+			{
+				case V34_MAP_ENTRY_TYPE_COMPRESSED:
+					blocklen = be_read(&rawmap[12], 2) + (rawmap[14] << 16);
+					if (source == NULL)
+					{
+						file_read(blockoffs, &compbuf[0], blocklen);
+						source = &compbuf[0];
+					}
+					decompressor[0]->decompress(source, blocklen, dest, m_hunkbytes);
+					if (!(rawmap[15] & V34_MAP_ENTRY_FLAG_NO_CRC) && dest != NULL && crc32_creator::simple(dest, m_hunkbytes) != blockcrc)
+						throw CHDERR_DECOMPRESSION_ERROR;
+					return;
+
+				case V34_MAP_ENTRY_TYPE_UNCOMPRESSED:
+					if (source != NULL)
+						memcpy(dest, source, m_hunkbytes);
+					else
+						file_read(blockoffs, dest, m_hunkbytes);
+					if (!(rawmap[15] & V34_MAP_ENTRY_FLAG_NO_CRC) && crc32_creator::simple(dest, m_hunkbytes) != blockcrc)
+						throw CHDERR_DECOMPRESSION_ERROR;
+					return;
+
+				case V34_MAP_ENTRY_TYPE_MINI:
+					be_write(dest, blockoffs, 8);
+					for (UINT32 bytes = 8; bytes < m_hunkbytes; bytes++)
+						dest[bytes] = dest[bytes - 8];
+					if (!(rawmap[15] & V34_MAP_ENTRY_FLAG_NO_CRC) && crc32_creator::simple(dest, m_hunkbytes) != blockcrc)
+						throw CHDERR_DECOMPRESSION_ERROR;
+					return;
+
+				case V34_MAP_ENTRY_TYPE_SELF_HUNK:
+					return read_hunk_internal(blockoffs, dest, decompressor, compbuf);
+
+				case V34_MAP_ENTRY_TYPE_PARENT_HUNK:
+					if (m_parent_missing)
+						throw CHDERR_REQUIRES_PARENT;
+					err = m_parent->read_bytes(blockoffs * UINT64(m_parent->hunk_bytes()), dest, m_hunkbytes);
+					if (err != CHDERR_NONE)
+						throw err;
+					return;
+			}
+			break;
+
+		// v5 map entries
+		case 5:
+			rawmap = &m_rawmap[m_mapentrybytes * hunknum];
+
+			// uncompressed case
+			if (!compressed())
+			{
+				blockoffs = UINT64(be_read(rawmap, 4)) * UINT64(m_hunkbytes);
+				if (blockoffs != 0 && source != NULL)
+					memcpy(dest, source, m_hunkbytes);
+				else if (blockoffs != 0)
+					file_read(blockoffs, dest, m_hunkbytes);
+				else if (m_parent_missing)
+					throw CHDERR_REQUIRES_PARENT;
+				else if (m_parent != NULL)
+					m_parent->read_bytes(UINT64(hunknum) * UINT64(m_parent->hunk_bytes()), dest, m_hunkbytes);
+				else
+					memset(dest, 0, m_hunkbytes);
+				return;
+			}
+
+			// compressed case
+			blocklen = be_read(&rawmap[1], 3);
+			blockoffs = be_read(&rawmap[4], 6);
+			blockcrc = be_read(&rawmap[10], 2);
+			switch (rawmap[0])
+			{
+				case COMPRESSION_TYPE_0:
+				case COMPRESSION_TYPE_1:
+				case COMPRESSION_TYPE_2:
+				case COMPRESSION_TYPE_3:
+					if (source == NULL)
+					{
+						file_read(blockoffs, &compbuf[0], blocklen);
+						source = &compbuf[0];
+					}
+					decompressor[rawmap[0]]->decompress(source, blocklen, dest, m_hunkbytes);
+					if (!decompressor[rawmap[0]]->lossy() && dest != NULL && crc16_creator::simple(dest, m_hunkbytes) != blockcrc)
+						throw CHDERR_DECOMPRESSION_ERROR;
+					if (decompressor[rawmap[0]]->lossy() && crc16_creator::simple(source, blocklen) != blockcrc)
+						throw CHDERR_DECOMPRESSION_ERROR;
+					return;
+
+				case COMPRESSION_NONE:
+					if (source != NULL)
+						memcpy(dest, source, m_hunkbytes);
+					else
+						file_read(blockoffs, dest, m_hunkbytes);
+					if (crc16_creator::simple(dest, m_hunkbytes) != blockcrc)
+						throw CHDERR_DECOMPRESSION_ERROR;
+					return;
+
+				case COMPRESSION_SELF:
+					return read_hunk_internal(blockoffs, dest, decompressor, compbuf);
+
+				case COMPRESSION_PARENT:
+					if (m_parent_missing)
+						throw CHDERR_REQUIRES_PARENT;
+					err = m_parent->read_bytes(blockoffs * UINT64(m_parent->unit_bytes()), dest, m_hunkbytes);
+					if (err != CHDERR_NONE)
+						throw err;
+					return;
+			}
+			break;
 	}
+
+	// if we get here, something was wrong
+	throw CHDERR_READ_ERROR;
 }
 
 /**
@@ -1046,9 +1286,14 @@ chd_error chd_file::write_hunk(UINT32 hunknum, const void *buffer)
 					break;
 				}
 
-			// if it's all zeros, do nothing more
+			// if it's all zeros, do nothing more beyond dropping any cached copy
 			if (all_zeros)
+			{
+				osd_lock_acquire(m_cache_lock);
+				cache_invalidate(hunknum);
+				osd_lock_release(m_cache_lock);
 				return CHDERR_NONE;
+			}
 
 			// append new data to the end of the file, aligning the first chunk
 			rawentry = file_append(buffer, m_hunkbytes, m_hunkbytes) / m_hunkbytes;
@@ -1056,15 +1301,18 @@ chd_error chd_file::write_hunk(UINT32 hunknum, const void *buffer)
 			// write the map entry back
 			be_write(rawmap, rawentry, 4);
 			file_write(m_mapoffset + hunknum * 4, rawmap, 4);
-
-			// update the cached hunk if we just wrote it
-			if (hunknum == m_cachehunk && buffer != &m_cache[0])
-				memcpy(&m_cache[0], buffer, m_hunkbytes);
 		}
 
 		// otherwise, just overwrite
 		else
 			file_write(UINT64(rawentry) * UINT64(m_hunkbytes), buffer, m_hunkbytes);
+
+		// update the cached hunk if we just wrote it
+		osd_lock_acquire(m_cache_lock);
+		int slot = cache_find(hunknum);
+		if (slot != -1 && buffer != &m_cache[slot * m_hunkbytes])
+			memcpy(&m_cache[slot * m_hunkbytes], buffer, m_hunkbytes);
+		osd_lock_release(m_cache_lock);
 		return CHDERR_NONE;
 	}
 
@@ -1134,36 +1382,67 @@ chd_error chd_file::read_bytes(UINT64 offset, void *buffer, UINT32 bytes)
 	UINT32 first_hunk = offset / m_hunkbytes;
 	UINT32 last_hunk = (offset + bytes - 1) / m_hunkbytes;
 	UINT8 *dest = reinterpret_cast<UINT8 *>(buffer);
+	chd_error err = CHDERR_NONE;
+	osd_lock_acquire(m_cache_lock);
 	for (UINT32 curhunk = first_hunk; curhunk <= last_hunk; curhunk++)
 	{
 		// determine start/end boundaries
 		UINT32 startoffs = (curhunk == first_hunk) ? (offset % m_hunkbytes) : 0;
 		UINT32 endoffs = (curhunk == last_hunk) ? ((offset + bytes - 1) % m_hunkbytes) : (m_hunkbytes - 1);
 
-		// if it's a full block, just read directly from disk unless it's the cached hunk
-		chd_error err = CHDERR_NONE;
-		if (startoffs == 0 && endoffs == m_hunkbytes - 1 && curhunk != m_cachehunk)
-			err = read_hunk(curhunk, dest);
+		// copy straight out of mapped files, bypassing the cache
+		const UINT8 *source = mapped_hunk(curhunk);
+		if (source != NULL)
+		{
+			memcpy(dest, source + startoffs, endoffs + 1 - startoffs);
+			m_lasthunk = curhunk;
+			dest += endoffs + 1 - startoffs;
+			continue;
+		}
+
+		// if it's a full block, just read directly from disk unless it's a cached hunk
+		int slot = cache_find(curhunk);
+		if (startoffs == 0 && endoffs == m_hunkbytes - 1 && slot == -1)
+		{
+			if (!readahead_fetch(curhunk, dest))
+				err = read_hunk(curhunk, dest);
+		}
 
 		// otherwise, read from the cache
 		else
 		{
-			if (curhunk != m_cachehunk)
+			if (slot == -1)
 			{
-				err = read_hunk(curhunk, &m_cache[0]);
-				if (err != CHDERR_NONE)
-					return err;
-				m_cachehunk = curhunk;
+				m_cache_misses++;
+				slot = cache_claim(curhunk);
+				if (!readahead_fetch(curhunk, &m_cache[slot * m_hunkbytes]))
+				{
+					osd_ticks_t start = osd_ticks();
+					err = read_hunk(curhunk, &m_cache[slot * m_hunkbytes]);
+					m_decompress_ticks += osd_ticks() - start;
+				}
 			}
-			memcpy(dest, &m_cache[startoffs], endoffs + 1 - startoffs);
+			else
+				m_cache_hits++;
+			if (err == CHDERR_NONE)
+				memcpy(dest, &m_cache[slot * m_hunkbytes + startoffs], endoffs + 1 - startoffs);
 		}
 
-		// handle errors and advance
+		// handle errors
 		if (err != CHDERR_NONE)
-			return err;
+		{
+			cache_invalidate(curhunk);
+			break;
+		}
+
+		// start decompressing ahead when reading sequentially, and advance
+		if (curhunk == m_lasthunk + 1)
+			readahead_start(curhunk + 1);
+		m_lasthunk = curhunk;
 		dest += endoffs + 1 - startoffs;
 	}
-	return CHDERR_NONE;
+	osd_lock_release(m_cache_lock);
+	return err;
 }
 
 /**
@@ -1187,82 +1466,306 @@ chd_error chd_file::write_bytes(UINT64 offset, const void *buffer, UINT32 bytes)
 	UINT32 first_hunk = offset / m_hunkbytes;
 	UINT32 last_hunk = (offset + bytes - 1) / m_hunkbytes;
 	const UINT8 *source = reinterpret_cast<const UINT8 *>(buffer);
+	chd_error err = CHDERR_NONE;
+	osd_lock_acquire(m_cache_lock);
 	for (UINT32 curhunk = first_hunk; curhunk <= last_hunk; curhunk++)
 	{
 		// determine start/end boundaries
 		UINT32 startoffs = (curhunk == first_hunk) ? (offset % m_hunkbytes) : 0;
 		UINT32 endoffs = (curhunk == last_hunk) ? ((offset + bytes - 1) % m_hunkbytes) : (m_hunkbytes - 1);
 
-		// if it's a full block, just write directly to disk unless it's the cached hunk
-		chd_error err = CHDERR_NONE;
-		if (startoffs == 0 && endoffs == m_hunkbytes - 1 && curhunk != m_cachehunk)
+		// if it's a full block, just write directly to disk unless it's a cached hunk
+		int slot = cache_find(curhunk);
+		if (startoffs == 0 && endoffs == m_hunkbytes - 1 && slot == -1)
 			err = write_hunk(curhunk, source);
 
 		// otherwise, write from the cache
 		else
 		{
-			if (curhunk != m_cachehunk)
+			if (slot == -1)
+			{
+				slot = cache_claim(curhunk);
+				err = read_hunk(curhunk, &m_cache[slot * m_hunkbytes]);
+			}
+			if (err == CHDERR_NONE)
 			{
-				err = read_hunk(curhunk, &m_cache[0]);
-				if (err != CHDERR_NONE)
-					return err;
-				m_cachehunk = curhunk;
+				memcpy(&m_cache[slot * m_hunkbytes + startoffs], source, endoffs + 1 - startoffs);
+				err = write_hunk(curhunk, &m_cache[slot * m_hunkbytes]);
 			}
-			memcpy(&m_cache[startoffs], source, endoffs + 1 - startoffs);
-			err = write_hunk(curhunk, &m_cache[0]);
 		}
 
 		// handle errors and advance
 		if (err != CHDERR_NONE)
-			return err;
+		{
+			cache_invalidate(curhunk);
+			break;
+		}
 		source += endoffs + 1 - startoffs;
 	}
-	return CHDERR_NONE;
+	osd_lock_release(m_cache_lock);
+	return err;
 }
 
 /**
- * @fn  chd_error chd_file::read_metadata(chd_metadata_tag searchtag, UINT32 searchindex, std::string &output)
+ * @fn  const UINT8 *chd_file::mapped_hunk(UINT32 hunknum)
  *
  * @brief   -------------------------------------------------
- *            read_metadata - read the indexed metadata of the given type
+ *            mapped_hunk - return a direct pointer to a hunk if it is stored uncompressed in a
+ *            memory-mapped file (or its parent), or NULL if it must be read normally
  *          -------------------------------------------------.
  *
- * @exception   CHDERR_METADATA_NOT_FOUND   Thrown when a chderr metadata not found error
- *                                          condition occurs.
- *
- * @param   searchtag       The searchtag.
- * @param   searchindex     The searchindex.
- * @param [in,out]  output  The output.
+ * @param   hunknum The hunknum.
  *
- * @return  The metadata.
+ * @return  A pointer to m_hunkbytes of data, valid until the file is closed, or NULL.
  */
 
-chd_error chd_file::read_metadata(chd_metadata_tag searchtag, UINT32 searchindex, std::string &output)
+const UINT8 *chd_file::mapped_hunk(UINT32 hunknum)
 {
-	// wrap this for clean reporting
-	try
-	{
-		// if we didn't find it, just return
-		metadata_entry metaentry;
-		if (!metadata_find(searchtag, searchindex, metaentry))
-			throw CHDERR_METADATA_NOT_FOUND;
-
-		// read the metadata
-		// TODO: how to properly allocate a dynamic char buffer?
-		char* metabuf = new char[metaentry.length+1];
-		memset(metabuf, 0x00, metaentry.length+1);
-		file_read(metaentry.offset + METADATA_HEADER_SIZE, metabuf, metaentry.length);
-		output.assign(metabuf);
-		delete[] metabuf;
-		return CHDERR_NONE;
-	}
+	// punt if not mapped or out of range
+	if (m_mapped == NULL || hunknum >= m_hunkcount)
+		return NULL;
 
-	// just return errors
-	catch (chd_error &err)
+	// find the hunk's data within the file
+	UINT64 blockoffs;
+	UINT8 *rawmap;
+	bool checkcrc = false;
+	switch (m_version)
 	{
-		return err;
-	}
-}
+		// v3/v4 map entries
+		case 3:
+		case 4:
+			rawmap = &m_rawmap[16 * hunknum];
+			blockoffs = be_read(&rawmap[0], 8);
+			switch (rawmap[15] & V34_MAP_ENTRY_FLAG_TYPE_MASK)
+			{
+				case V34_MAP_ENTRY_TYPE_UNCOMPRESSED:
+					checkcrc = !(rawmap[15] & V34_MAP_ENTRY_FLAG_NO_CRC);
+					break;
+
+				case V34_MAP_ENTRY_TYPE_SELF_HUNK:
+					return mapped_hunk(blockoffs);
+
+				case V34_MAP_ENTRY_TYPE_PARENT_HUNK:
+					if (m_parent_missing || m_parent == NULL || m_parent->hunk_bytes() != m_hunkbytes)
+						return NULL;
+					return m_parent->mapped_hunk(blockoffs);
+
+				default:
+					return NULL;
+			}
+			break;
+
+		// v5 map entries
+		case 5:
+			rawmap = &m_rawmap[m_mapentrybytes * hunknum];
+
+			// uncompressed case
+			if (!compressed())
+			{
+				blockoffs = UINT64(be_read(rawmap, 4)) * UINT64(m_hunkbytes);
+				if (blockoffs != 0)
+					break;
+				if (m_parent_missing || m_parent == NULL || m_parent->hunk_bytes() != m_hunkbytes)
+					return NULL;
+				return m_parent->mapped_hunk(hunknum);
+			}
+
+			// compressed case
+			blockoffs = be_read(&rawmap[4], 6);
+			switch (rawmap[0])
+			{
+				case COMPRESSION_NONE:
+					checkcrc = true;
+					break;
+
+				case COMPRESSION_SELF:
+					return mapped_hunk(blockoffs);
+
+				case COMPRESSION_PARENT:
+					if (m_parent_missing || m_parent == NULL || m_parent->hunk_bytes() != m_hunkbytes)
+						return NULL;
+					blockoffs *= m_parent->unit_bytes();
+					if (blockoffs % m_hunkbytes != 0)
+						return NULL;
+					return m_parent->mapped_hunk(blockoffs / m_hunkbytes);
+
+				default:
+					return NULL;
+			}
+			break;
+
+		default:
+			return NULL;
+	}
+
+	// make sure it is all there
+	if (blockoffs > m_mapped_length || m_mapped_length - blockoffs < m_hunkbytes)
+		return NULL;
+	const UINT8 *data = m_mapped + blockoffs;
+
+	// check the CRC the first time we hand out each hunk; failures are left for the normal
+	// read path to report
+	if (checkcrc && !m_mapped_verified[hunknum])
+	{
+		bool valid = (m_version < 5) ? (crc32_creator::simple(data, m_hunkbytes) == be_read(&rawmap[8], 4))
+				: (crc16_creator::simple(data, m_hunkbytes) == be_read(&rawmap[10], 2));
+		if (!valid)
+			return NULL;
+		m_mapped_verified[hunknum] = 1;
+	}
+	return data;
+}
+
+/**
+ * @fn  const UINT8 *chd_file::mapped_bytes(UINT64 offset, UINT32 bytes)
+ *
+ * @brief   -------------------------------------------------
+ *            mapped_bytes - return a direct pointer to a range of bytes if every hunk it
+ *            touches is mapped and they are contiguous in memory, or NULL otherwise
+ *          -------------------------------------------------.
+ *
+ * @param   offset  The offset.
+ * @param   bytes   The bytes.
+ *
+ * @return  A pointer to the data, valid until the file is closed, or NULL.
+ */
+
+const UINT8 *chd_file::mapped_bytes(UINT64 offset, UINT32 bytes)
+{
+	if (m_mapped == NULL || bytes == 0 || offset + bytes > m_logicalbytes)
+		return NULL;
+
+	// find the first hunk
+	UINT32 first_hunk = offset / m_hunkbytes;
+	UINT32 last_hunk = (offset + bytes - 1) / m_hunkbytes;
+	const UINT8 *base = mapped_hunk(first_hunk);
+	if (base == NULL)
+		return NULL;
+
+	// any further hunks must follow on directly
+	for (UINT32 curhunk = first_hunk + 1; curhunk <= last_hunk; curhunk++)
+		if (mapped_hunk(curhunk) != base + UINT64(curhunk - first_hunk) * m_hunkbytes)
+			return NULL;
+	return base + offset % m_hunkbytes;
+}
+
+/**
+ * @fn  chd_error chd_file::read_hunk_async(UINT32 hunknum, void *buffer, chd_async_callback callback, void *param)
+ *
+ * @brief   -------------------------------------------------
+ *            read_hunk_async - read a single hunk on the read-ahead thread, either into the
+ *            given buffer or, if buffer is NULL, into the read-ahead ring where later reads
+ *            will find it; the callback (if any) is called from the read-ahead thread when
+ *            done. Files that cannot use read-ahead complete the request synchronously, and
+ *            a pure prefetch (no buffer or callback) is then ignored
+ *          -------------------------------------------------.
+ *
+ * @param   hunknum         The hunknum.
+ * @param [in,out]  buffer  If non-null, the buffer, which must remain valid until completion.
+ * @param   callback        If non-null, the completion callback.
+ * @param [in,out]  param   If non-null, the parameter for the callback.
+ *
+ * @return  CHDERR_NONE if the request was queued, otherwise the synchronous result.
+ */
+
+chd_error chd_file::read_hunk_async(UINT32 hunknum, void *buffer, chd_async_callback callback, void *param)
+{
+	// punt if no file or out of range
+	if (m_file == NULL)
+		return CHDERR_NOT_OPEN;
+	if (hunknum >= m_hunkcount)
+		return CHDERR_HUNK_OUT_OF_RANGE;
+
+	// mapped hunks need no prefetching
+	if (buffer == NULL && mapped_hunk(hunknum) != NULL)
+	{
+		if (callback != NULL)
+			(*callback)(param, hunknum, CHDERR_NONE);
+		return CHDERR_NONE;
+	}
+
+	// queue the request on the read-ahead thread if we can
+	osd_lock_acquire(m_readahead_lock);
+	bool queued = readahead_init();
+	if (queued)
+	{
+		async_request *request = new async_request;
+		request->m_chd = this;
+		request->m_hunknum = hunknum;
+		request->m_buffer = reinterpret_cast<UINT8 *>(buffer);
+		request->m_callback = callback;
+		request->m_param = param;
+		osd_work_item_queue(m_readahead_queue, async_read_static, request, WORK_ITEM_FLAG_AUTO_RELEASE);
+	}
+	osd_lock_release(m_readahead_lock);
+	if (queued || (buffer == NULL && callback == NULL))
+		return CHDERR_NONE;
+
+	// otherwise, do it now
+	chd_error err = (buffer != NULL) ? read_hunk(hunknum, buffer) : CHDERR_NONE;
+	if (callback != NULL)
+		(*callback)(param, hunknum, err);
+	return err;
+}
+
+/**
+ * @fn  void chd_file::wait_async()
+ *
+ * @brief   -------------------------------------------------
+ *            wait_async - wait for all outstanding asynchronous reads and read-ahead to
+ *            complete
+ *          -------------------------------------------------.
+ */
+
+void chd_file::wait_async()
+{
+	if (m_readahead_queue != NULL)
+		osd_work_queue_wait(m_readahead_queue, osd_ticks_per_second() * 100);
+}
+
+/**
+ * @fn  chd_error chd_file::read_metadata(chd_metadata_tag searchtag, UINT32 searchindex, std::string &output)
+ *
+ * @brief   -------------------------------------------------
+ *            read_metadata - read the indexed metadata of the given type
+ *          -------------------------------------------------.
+ *
+ * @exception   CHDERR_METADATA_NOT_FOUND   Thrown when a chderr metadata not found error
+ *                                          condition occurs.
+ *
+ * @param   searchtag       The searchtag.
+ * @param   searchindex     The searchindex.
+ * @param [in,out]  output  The output.
+ *
+ * @return  The metadata.
+ */
+
+chd_error chd_file::read_metadata(chd_metadata_tag searchtag, UINT32 searchindex, std::string &output)
+{
+	// wrap this for clean reporting
+	try
+	{
+		// if we didn't find it, just return
+		metadata_entry metaentry;
+		if (!metadata_find(searchtag, searchindex, metaentry))
+			throw CHDERR_METADATA_NOT_FOUND;
+
+		// read the metadata
+		// TODO: how to properly allocate a dynamic char buffer?
+		char* metabuf = new char[metaentry.length+1];
+		memset(metabuf, 0x00, metaentry.length+1);
+		file_read(metaentry.offset + METADATA_HEADER_SIZE, metabuf, metaentry.length);
+		output.assign(metabuf);
+		delete[] metabuf;
+		return CHDERR_NONE;
+	}
+
+	// just return errors
+	catch (chd_error &err)
+	{
+		return err;
+	}
+}
 
 /**
  * @fn  chd_error chd_file::read_metadata(chd_metadata_tag searchtag, UINT32 searchindex, dynamic_buffer &output)
@@ -1626,7 +2129,9 @@ chd_error chd_file::codec_configure(chd_codec_type codec, int param, void *confi
 		for (int codecnum = 0; codecnum < ARRAY_LENGTH(m_compression); codecnum++)
 			if (m_compression[codecnum] == codec)
 			{
+				// configured codecs carry per-read state, so read-ahead can no longer be used
 				m_decompressor[codecnum]->configure(param, config);
+				m_readahead_allowed = false;
 				return CHDERR_NONE;
 			}
 		return CHDERR_INVALID_PARAMETER;
@@ -2461,9 +2966,18 @@ void chd_file::create_open_common()
 	else
 		file_read(m_mapoffset, &m_rawmap[0], m_rawmap.size());
 
-	// allocate the temporary compressed buffer and a buffer for caching
+	// allocate the temporary compressed buffer and the hunk cache
 	m_compressed.resize(m_hunkbytes);
-	m_cache.resize(m_hunkbytes);
+	cache_allocate();
+
+	// read-ahead is only safe while nobody can modify the file underneath it
+	m_readahead_allowed = !m_allow_writes;
+
+	// map the file if possible; this only succeeds for files opened read-only
+	m_mapped = reinterpret_cast<const UINT8 *>(core_fmap(m_file));
+	m_mapped_length = core_fsize(m_file);
+	if (m_mapped != NULL && (m_version < 5 || compressed()))
+		m_mapped_verified.resize(m_hunkcount, 0);
 }
 
 /**
@@ -2601,149 +3115,504 @@ void chd_file::hunk_copy_from_parent(UINT32 hunknum, UINT64 parentunit)
 }
 
 /**
- * @fn  bool chd_file::metadata_find(chd_metadata_tag metatag, INT32 metaindex, metadata_entry &metaentry, bool resume)
+ * @fn  void chd_file::cache_allocate()
  *
  * @brief   -------------------------------------------------
- *            metadata_find - find a metadata entry
+ *            cache_allocate - (re)allocate the hunk cache, discarding its contents
  *          -------------------------------------------------.
- *
- * @param   metatag             The metatag.
- * @param   metaindex           The metaindex.
- * @param [in,out]  metaentry   The metaentry.
- * @param   resume              true to resume.
- *
- * @return  true if it succeeds, false if it fails.
  */
 
-bool chd_file::metadata_find(chd_metadata_tag metatag, INT32 metaindex, metadata_entry &metaentry, bool resume)
+void chd_file::cache_allocate()
 {
-	// start at the beginning unless we're resuming a previous search
-	if (!resume)
-	{
-		metaentry.offset = m_metaoffset;
-		metaentry.prev = 0;
-	}
-	else
-	{
-		metaentry.prev = metaentry.offset;
-		metaentry.offset = metaentry.next;
-	}
-
-	// loop until we run out of options
-	while (metaentry.offset != 0)
-	{
-		// read the raw header
-		UINT8 raw_meta_header[METADATA_HEADER_SIZE];
-		file_read(metaentry.offset, raw_meta_header, sizeof(raw_meta_header));
-
-		// extract the data
-		metaentry.metatag = be_read(&raw_meta_header[0], 4);
-		metaentry.flags = raw_meta_header[4];
-		metaentry.length = be_read(&raw_meta_header[5], 3);
-		metaentry.next = be_read(&raw_meta_header[8], 8);
-
-		// if we got a match, proceed
-		if (metatag == CHDMETATAG_WILDCARD || metaentry.metatag == metatag)
-			if (metaindex-- == 0)
-				return true;
-
-		// no match, fetch the next link
-		metaentry.prev = metaentry.offset;
-		metaentry.offset = metaentry.next;
-	}
-
-	// if we get here, we didn't find it
-	return false;
+	// by default, keep about a megabyte of hunks, but always at least two
+	UINT32 hunks = m_cache_size;
+	if (hunks == 0)
+		hunks = MAX(2, MIN(CACHE_DEFAULT_MAX_HUNKS, CACHE_DEFAULT_BYTES / m_hunkbytes));
+
+	m_cache.resize(hunks * m_hunkbytes);
+	m_cachehunk.assign(hunks, ~0);
+	m_cachestamp.assign(hunks, 0);
+	m_cachelast = 0;
 }
 
 /**
- * @fn  void chd_file::metadata_set_previous_next(UINT64 prevoffset, UINT64 nextoffset)
+ * @fn  int chd_file::cache_find(UINT32 hunknum)
  *
  * @brief   -------------------------------------------------
- *            metadata_set_previous_next - set the 'next' offset of a piece of metadata
+ *            cache_find - find the cache slot holding the given hunk and mark it as used; the
+ *            cache lock must be held
  *          -------------------------------------------------.
  *
- * @param   prevoffset  The prevoffset.
- * @param   nextoffset  The nextoffset.
+ * @param   hunknum The hunknum.
+ *
+ * @return  The slot index, or -1 if the hunk is not cached.
  */
 
-void chd_file::metadata_set_previous_next(UINT64 prevoffset, UINT64 nextoffset)
+int chd_file::cache_find(UINT32 hunknum)
 {
-	UINT64 offset = 0;
-
-	// if we were the first entry, make the next entry the first
-	if (prevoffset == 0)
+	// check the most recently used slot first
+	if (m_cachehunk.empty())
+		return -1;
+	if (m_cachehunk[m_cachelast] != hunknum)
 	{
-		offset = m_metaoffset_offset;
-		m_metaoffset = nextoffset;
+		UINT32 slot;
+		for (slot = 0; slot < m_cachehunk.size(); slot++)
+			if (m_cachehunk[slot] == hunknum)
+				break;
+		if (slot == m_cachehunk.size())
+			return -1;
+		m_cachelast = slot;
 	}
-
-	// otherwise, update the link in the previous header
-	else
-		offset = prevoffset + 8;
-
-	// create a big-endian version
-	UINT8 rawbuf[sizeof(UINT64)];
-	be_write(rawbuf, nextoffset, 8);
-
-	// write to the header and update our local copy
-	file_write(offset, rawbuf, sizeof(rawbuf));
+	m_cachestamp[m_cachelast] = ++m_cacheclock;
+	return m_cachelast;
 }
 
 /**
- * @fn  void chd_file::metadata_update_hash()
+ * @fn  int chd_file::cache_claim(UINT32 hunknum)
  *
  * @brief   -------------------------------------------------
- *            metadata_update_hash - compute the SHA1 hash of all metadata that requests it
+ *            cache_claim - assign the least recently used cache slot to the given hunk; the
+ *            caller must fill it, and the cache lock must be held
  *          -------------------------------------------------.
+ *
+ * @param   hunknum The hunknum.
+ *
+ * @return  The slot index.
  */
 
-void chd_file::metadata_update_hash()
+int chd_file::cache_claim(UINT32 hunknum)
 {
-	// only works for V4 and above, and only for compressed CHDs
-	if (m_version < 4 || !compressed())
-		return;
-
-	// compute the new overall hash
-	sha1_t fullsha1 = compute_overall_sha1(raw_sha1());
-
-	// create a big-endian version
-	UINT8 rawbuf[sizeof(sha1_t)];
-	be_write_sha1(&rawbuf[0], fullsha1);
+	// compare ages rather than stamps so that wrapping the clock is harmless
+	UINT32 victim = 0;
+	for (UINT32 slot = 0; slot < m_cachehunk.size(); slot++)
+	{
+		if (m_cachehunk[slot] == UINT32(~0))
+		{
+			victim = slot;
+			break;
+		}
+		if (m_cacheclock - m_cachestamp[slot] > m_cacheclock - m_cachestamp[victim])
+			victim = slot;
+	}
 
-	// write to the header
-	file_write(m_sha1_offset, rawbuf, sizeof(rawbuf));
+	m_cachehunk[victim] = hunknum;
+	m_cachestamp[victim] = ++m_cacheclock;
+	m_cachelast = victim;
+	return victim;
 }
 
 /**
- * @fn  int CLIB_DECL chd_file::metadata_hash_compare(const void *elem1, const void *elem2)
+ * @fn  void chd_file::cache_invalidate(UINT32 hunknum)
  *
  * @brief   -------------------------------------------------
- *            metadata_hash_compare - compare two hash entries
+ *            cache_invalidate - drop the given hunk from the cache; the cache lock must be held
  *          -------------------------------------------------.
  *
- * @param   elem1   The first element.
- * @param   elem2   The second element.
- *
- * @return  A CLIB_DECL.
+ * @param   hunknum The hunknum.
  */
 
-int CLIB_DECL chd_file::metadata_hash_compare(const void *elem1, const void *elem2)
+void chd_file::cache_invalidate(UINT32 hunknum)
 {
-	return memcmp(elem1, elem2, sizeof(metadata_hash));
+	int slot = cache_find(hunknum);
+	if (slot != -1)
+		m_cachehunk[slot] = ~0;
 }
 
-
-
-//**************************************************************************
-//  CHD COMPRESSOR
-//**************************************************************************
-
 /**
- * @fn  chd_file_compressor::chd_file_compressor()
+ * @fn  bool chd_file::readahead_init()
  *
  * @brief   -------------------------------------------------
- *            chd_file_compressor - constructor
+ *            readahead_init - allocate the read-ahead queue, codecs and ring on first use; the
+ *            read-ahead lock must be held
+ *          -------------------------------------------------.
+ *
+ * @return  true if read-ahead work can be queued, false otherwise.
+ */
+
+bool chd_file::readahead_init()
+{
+	if (!m_readahead_allowed)
+		return false;
+
+	// allocate the queue and a private set of codecs
+	if (m_readahead_queue == NULL)
+	{
+		for (int decompnum = 0; decompnum < ARRAY_LENGTH(m_compression); decompnum++)
+			m_readahead_decompressor[decompnum] = chd_codec_list::new_decompressor(m_compression[decompnum], *this);
+		m_readahead_compressed.resize(m_hunkbytes);
+		m_readahead_queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_IO);
+		if (m_readahead_queue == NULL)
+		{
+			m_readahead_allowed = false;
+			return false;
+		}
+	}
+
+	// allocate the ring
+	if (m_readahead_hunk.empty())
+	{
+		UINT32 slots = MAX(m_readahead_size, READAHEAD_MIN_SLOTS);
+		m_readahead_buffer.resize(slots * m_hunkbytes);
+		m_readahead_hunk.assign(slots, ~0);
+	}
+	return true;
+}
+
+/**
+ * @fn  bool chd_file::readahead_fetch(UINT32 hunknum, UINT8 *dest)
+ *
+ * @brief   -------------------------------------------------
+ *            readahead_fetch - copy the given hunk out of the read-ahead ring if it has
+ *            already been decompressed there
+ *          -------------------------------------------------.
+ *
+ * @param   hunknum         The hunknum.
+ * @param [in,out]  dest    The destination.
+ *
+ * @return  true if the hunk was copied, false if it must be read normally.
+ */
+
+bool chd_file::readahead_fetch(UINT32 hunknum, UINT8 *dest)
+{
+	osd_lock_acquire(m_readahead_lock);
+	bool found = false;
+	if (!m_readahead_hunk.empty())
+	{
+		UINT32 slot = hunknum % m_readahead_hunk.size();
+		if (m_readahead_hunk[slot] == hunknum)
+		{
+			memcpy(dest, &m_readahead_buffer[slot * m_hunkbytes], m_hunkbytes);
+			m_readahead_hits++;
+			found = true;
+		}
+	}
+	osd_lock_release(m_readahead_lock);
+	return found;
+}
+
+/**
+ * @fn  chd_error chd_file::readahead_hunk(UINT32 hunknum)
+ *
+ * @brief   -------------------------------------------------
+ *            readahead_hunk - decompress a hunk into the read-ahead ring unless it is already
+ *            there; only called from the read-ahead thread
+ *          -------------------------------------------------.
+ *
+ * @param   hunknum The hunknum.
+ *
+ * @return  A chd_error.
+ */
+
+chd_error chd_file::readahead_hunk(UINT32 hunknum)
+{
+	// claim the ring slot, unless it already holds this hunk
+	UINT32 slot = hunknum % m_readahead_hunk.size();
+	osd_lock_acquire(m_readahead_lock);
+	bool present = (m_readahead_hunk[slot] == hunknum);
+	if (!present)
+		m_readahead_hunk[slot] = ~0;
+	osd_lock_release(m_readahead_lock);
+	if (present)
+		return CHDERR_NONE;
+
+	// decompress outside of the lock
+	osd_ticks_t start = osd_ticks();
+	try
+	{
+		read_hunk_internal(hunknum, &m_readahead_buffer[slot * m_hunkbytes], m_readahead_decompressor, m_readahead_compressed);
+	}
+	catch (chd_error &err)
+	{
+		return err;
+	}
+
+	// publish the result
+	osd_lock_acquire(m_readahead_lock);
+	m_readahead_hunk[slot] = hunknum;
+	m_readahead_ticks += osd_ticks() - start;
+	osd_lock_release(m_readahead_lock);
+	return CHDERR_NONE;
+}
+
+/**
+ * @fn  void chd_file::readahead_start(UINT32 hunknum)
+ *
+ * @brief   -------------------------------------------------
+ *            readahead_start - begin decompressing hunks starting at the given hunk on the
+ *            read-ahead thread, unless a pass is already running
+ *          -------------------------------------------------.
+ *
+ * @param   hunknum The first hunk to read ahead.
+ */
+
+void chd_file::readahead_start(UINT32 hunknum)
+{
+	osd_lock_acquire(m_readahead_lock);
+
+	// nothing to do if disabled, busy, or off the end; only top up the window once the reader
+	// is halfway through it, unless the reader has moved elsewhere
+	UINT32 window = m_readahead_size;
+	bool restart = (hunknum > m_readahead_end || hunknum + window < m_readahead_end);
+	if (window != 0 && !m_readahead_busy && hunknum < m_hunkcount && (restart || hunknum + window / 2 >= m_readahead_end) && readahead_init())
+	{
+		m_readahead_next = restart ? hunknum : m_readahead_end;
+		m_readahead_end = MIN(hunknum + window, m_hunkcount);
+
+		// mark busy before queueing: auto-released items always come back NULL, and with no
+		// worker threads the pass runs (and clears the flag) inside the queue call
+		m_readahead_busy = true;
+		osd_work_item_queue(m_readahead_queue, readahead_static, this, WORK_ITEM_FLAG_AUTO_RELEASE);
+	}
+
+	osd_lock_release(m_readahead_lock);
+}
+
+/**
+ * @fn  void *chd_file::readahead_static(void *param, int threadid)
+ *
+ * @brief   -------------------------------------------------
+ *            readahead_static - thread entry point for read-ahead
+ *          -------------------------------------------------.
+ *
+ * @param [in,out]  param   If non-null, the parameter.
+ * @param   threadid        The threadid.
+ *
+ * @return  null if it fails, else a void*.
+ */
+
+void *chd_file::readahead_static(void *param, int threadid)
+{
+	reinterpret_cast<chd_file *>(param)->readahead();
+	return NULL;
+}
+
+/**
+ * @fn  void chd_file::readahead()
+ *
+ * @brief   -------------------------------------------------
+ *            readahead - decompress the requested hunks into the read-ahead ring; this never
+ *            touches the cache, so the reader is not held up, and errors are left for the
+ *            reader to discover
+ *          -------------------------------------------------.
+ */
+
+void chd_file::readahead()
+{
+	osd_lock_acquire(m_readahead_lock);
+	UINT32 first = m_readahead_next;
+	UINT32 last = m_readahead_end;
+	osd_lock_release(m_readahead_lock);
+
+	for (UINT32 hunknum = first; hunknum < last; hunknum++)
+		if (readahead_hunk(hunknum) != CHDERR_NONE)
+			break;
+
+	osd_lock_acquire(m_readahead_lock);
+	m_readahead_busy = false;
+	osd_lock_release(m_readahead_lock);
+}
+
+/**
+ * @fn  void *chd_file::async_read_static(void *param, int threadid)
+ *
+ * @brief   -------------------------------------------------
+ *            async_read_static - thread entry point for asynchronous reads
+ *          -------------------------------------------------.
+ *
+ * @param [in,out]  param   If non-null, the parameter.
+ * @param   threadid        The threadid.
+ *
+ * @return  null if it fails, else a void*.
+ */
+
+void *chd_file::async_read_static(void *param, int threadid)
+{
+	async_request *request = reinterpret_cast<async_request *>(param);
+	request->m_chd->async_read(*request);
+	delete request;
+	return NULL;
+}
+
+/**
+ * @fn  void chd_file::async_read(async_request &request)
+ *
+ * @brief   -------------------------------------------------
+ *            async_read - perform an asynchronous read, either into the caller's buffer or
+ *            into the read-ahead ring, and report the result
+ *          -------------------------------------------------.
+ *
+ * @param [in,out]  request The request.
+ */
+
+void chd_file::async_read(async_request &request)
+{
+	chd_error err = CHDERR_NONE;
+	if (request.m_buffer != NULL)
+	{
+		osd_ticks_t start = osd_ticks();
+		try
+		{
+			read_hunk_internal(request.m_hunknum, request.m_buffer, m_readahead_decompressor, m_readahead_compressed);
+		}
+		catch (chd_error &error)
+		{
+			err = error;
+		}
+		osd_lock_acquire(m_readahead_lock);
+		m_readahead_ticks += osd_ticks() - start;
+		osd_lock_release(m_readahead_lock);
+	}
+	else
+		err = readahead_hunk(request.m_hunknum);
+
+	if (request.m_callback != NULL)
+		(*request.m_callback)(request.m_param, request.m_hunknum, err);
+}
+
+/**
+ * @fn  bool chd_file::metadata_find(chd_metadata_tag metatag, INT32 metaindex, metadata_entry &metaentry, bool resume)
+ *
+ * @brief   -------------------------------------------------
+ *            metadata_find - find a metadata entry
+ *          -------------------------------------------------.
+ *
+ * @param   metatag             The metatag.
+ * @param   metaindex           The metaindex.
+ * @param [in,out]  metaentry   The metaentry.
+ * @param   resume              true to resume.
+ *
+ * @return  true if it succeeds, false if it fails.
+ */
+
+bool chd_file::metadata_find(chd_metadata_tag metatag, INT32 metaindex, metadata_entry &metaentry, bool resume)
+{
+	// start at the beginning unless we're resuming a previous search
+	if (!resume)
+	{
+		metaentry.offset = m_metaoffset;
+		metaentry.prev = 0;
+	}
+	else
+	{
+		metaentry.prev = metaentry.offset;
+		metaentry.offset = metaentry.next;
+	}
+
+	// loop until we run out of options
+	while (metaentry.offset != 0)
+	{
+		// read the raw header
+		UINT8 raw_meta_header[METADATA_HEADER_SIZE];
+		file_read(metaentry.offset, raw_meta_header, sizeof(raw_meta_header));
+
+		// extract the data
+		metaentry.metatag = be_read(&raw_meta_header[0], 4);
+		metaentry.flags = raw_meta_header[4];
+		metaentry.length = be_read(&raw_meta_header[5], 3);
+		metaentry.next = be_read(&raw_meta_header[8], 8);
+
+		// if we got a match, proceed
+		if (metatag == CHDMETATAG_WILDCARD || metaentry.metatag == metatag)
+			if (metaindex-- == 0)
+				return true;
+
+		// no match, fetch the next link
+		metaentry.prev = metaentry.offset;
+		metaentry.offset = metaentry.next;
+	}
+
+	// if we get here, we didn't find it
+	return false;
+}
+
+/**
+ * @fn  void chd_file::metadata_set_previous_next(UINT64 prevoffset, UINT64 nextoffset)
+ *
+ * @brief   -------------------------------------------------
+ *            metadata_set_previous_next - set the 'next' offset of a piece of metadata
+ *          -------------------------------------------------.
+ *
+ * @param   prevoffset  The prevoffset.
+ * @param   nextoffset  The nextoffset.
+ */
+
+void chd_file::metadata_set_previous_next(UINT64 prevoffset, UINT64 nextoffset)
+{
+	UINT64 offset = 0;
+
+	// if we were the first entry, make the next entry the first
+	if (prevoffset == 0)
+	{
+		offset = m_metaoffset_offset;
+		m_metaoffset = nextoffset;
+	}
+
+	// otherwise, update the link in the previous header
+	else
+		offset = prevoffset + 8;
+
+	// create a big-endian version
+	UINT8 rawbuf[sizeof(UINT64)];
+	be_write(rawbuf, nextoffset, 8);
+
+	// write to the header and update our local copy
+	file_write(offset, rawbuf, sizeof(rawbuf));
+}
+
+/**
+ * @fn  void chd_file::metadata_update_hash()
+ *
+ * @brief   -------------------------------------------------
+ *            metadata_update_hash - compute the SHA1 hash of all metadata that requests it
+ *          -------------------------------------------------.
+ */
+
+void chd_file::metadata_update_hash()
+{
+	// only works for V4 and above, and only for compressed CHDs
+	if (m_version < 4 || !compressed())
+		return;
+
+	// compute the new overall hash
+	sha1_t fullsha1 = compute_overall_sha1(raw_sha1());
+
+	// create a big-endian version
+	UINT8 rawbuf[sizeof(sha1_t)];
+	be_write_sha1(&rawbuf[0], fullsha1);
+
+	// write to the header
+	file_write(m_sha1_offset, rawbuf, sizeof(rawbuf));
+}
+
+/**
+ * @fn  int CLIB_DECL chd_file::metadata_hash_compare(const void *elem1, const void *elem2)
+ *
+ * @brief   -------------------------------------------------
+ *            metadata_hash_compare - compare two hash entries
+ *          -------------------------------------------------.
+ *
+ * @param   elem1   The first element.
+ * @param   elem2   The second element.
+ *
+ * @return  A CLIB_DECL.
+ */
+
+int CLIB_DECL chd_file::metadata_hash_compare(const void *elem1, const void *elem2)
+{
+	return memcmp(elem1, elem2, sizeof(metadata_hash));
+}
+
+
+
+//**************************************************************************
+//  CHD COMPRESSOR
+//**************************************************************************
+
+/**
+ * @fn  chd_file_compressor::chd_file_compressor()
+ *
+ * @brief   -------------------------------------------------
+ *            chd_file_compressor - constructor
  *          -------------------------------------------------.
  */
 
@@ -3277,3 +4146,326 @@ void chd_file_compressor::hashmap::add(UINT64 itemnum, crc16_t crc16, sha1_t sha
 	entry->m_next = m_map[crc16];
 	m_map[crc16] = entry;
 }
+
+
+
+//**************************************************************************
+//  CHD VERIFIER
+//**************************************************************************
+
+/**
+ * @fn  chd_verifier::chd_verifier(chd_file &chd)
+ *
+ * @brief   -------------------------------------------------
+ *            chd_verifier - constructor
+ *          -------------------------------------------------.
+ *
+ * @param [in,out]  chd The CHD to read.
+ */
+
+chd_verifier::chd_verifier(chd_file &chd)
+	: m_chd(chd),
+		m_first_hunk(0),
+		m_end_hunk(0),
+		m_next_hunk(0),
+		m_last_item(NULL),
+		m_hash(false),
+		m_bytes_done(0),
+		m_read_queue(NULL),
+		m_read_queue_hunk(0),
+		m_read_done_hunk(0),
+		m_work_queue(NULL)
+{
+	// zap arrays
+	memset(m_decompressor, 0, sizeof(m_decompressor));
+
+	// allocate work queues
+	m_read_queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_IO);
+	m_work_queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI);
+}
+
+/**
+ * @fn  chd_verifier::~chd_verifier()
+ *
+ * @brief   -------------------------------------------------
+ *            ~chd_verifier - destructor
+ *          -------------------------------------------------.
+ */
+
+chd_verifier::~chd_verifier()
+{
+	// let any outstanding work finish; reads must finish first, since they queue work
+	osd_work_queue_wait(m_read_queue, 30 * osd_ticks_per_second());
+	osd_work_queue_wait(m_work_queue, 30 * osd_ticks_per_second());
+	for (int itemnum = 0; itemnum < WORK_BUFFER_HUNKS; itemnum++)
+		if (m_work_item[itemnum].m_osd != NULL)
+			osd_work_item_release(m_work_item[itemnum].m_osd);
+
+	// free the work queues
+	osd_work_queue_free(m_read_queue);
+	osd_work_queue_free(m_work_queue);
+
+	// delete allocated arrays
+	for (int threadnum = 0; threadnum < WORK_MAX_THREADS; threadnum++)
+		for (int decompnum = 0; decompnum < ARRAY_LENGTH(m_decompressor[threadnum]); decompnum++)
+			delete m_decompressor[threadnum][decompnum];
+}
+
+/**
+ * @fn  void chd_verifier::verify_begin(UINT32 firsthunk, UINT32 numhunks, bool hash)
+ *
+ * @brief   -------------------------------------------------
+ *            verify_begin - initiate reading back a range of hunks; only one range may be
+ *            read per verifier
+ *          -------------------------------------------------.
+ *
+ * @param   firsthunk   The first hunk to read.
+ * @param   numhunks    The number of hunks to read, clamped to the end of the CHD.
+ * @param   hash        true to compute the SHA-1 of the data read.
+ */
+
+void chd_verifier::verify_begin(UINT32 firsthunk, UINT32 numhunks, bool hash)
+{
+	// reset state
+	m_first_hunk = MIN(firsthunk, m_chd.hunk_count());
+	m_end_hunk = m_first_hunk + MIN(numhunks, m_chd.hunk_count() - m_first_hunk);
+	m_next_hunk = m_first_hunk;
+	m_last_item = NULL;
+	m_hash = hash;
+	m_rawsha1.reset();
+	m_bytes_done = 0;
+
+	// reset read state
+	m_read_queue_hunk = m_first_hunk;
+	m_read_done_hunk = m_first_hunk;
+
+	// reset work item state
+	UINT32 hunkbytes = m_chd.hunk_bytes();
+	m_work_buffer.resize(hunkbytes * WORK_BUFFER_HUNKS);
+	m_compressed_buffer.resize(hunkbytes * WORK_BUFFER_HUNKS);
+	for (int itemnum = 0; itemnum < WORK_BUFFER_HUNKS; itemnum++)
+	{
+		work_item &item = m_work_item[itemnum];
+		item.m_verifier = this;
+		item.m_data = &m_work_buffer[hunkbytes * itemnum];
+		item.m_compressed = &m_compressed_buffer[hunkbytes * itemnum];
+	}
+
+	// initialize codec instances
+	for (int threadnum = 0; threadnum < WORK_MAX_THREADS; threadnum++)
+	{
+		for (int decompnum = 0; decompnum < ARRAY_LENGTH(m_decompressor[threadnum]); decompnum++)
+		{
+			delete m_decompressor[threadnum][decompnum];
+			m_decompressor[threadnum][decompnum] = chd_codec_list::new_decompressor(m_chd.compression(decompnum), m_chd);
+		}
+		m_thread_compressed[threadnum].resize(hunkbytes);
+	}
+}
+
+/**
+ * @fn  chd_error chd_verifier::verify_continue(const UINT8 *&data, UINT32 &length)
+ *
+ * @brief   -------------------------------------------------
+ *            verify_continue - wait for the next hunk in order; data is set to NULL once all
+ *            hunks have been returned, and otherwise remains valid until the next call
+ *          -------------------------------------------------.
+ *
+ * @param [out] data    The hunk data.
+ * @param [out] length  The number of valid bytes in the hunk.
+ *
+ * @return  A chd_error.
+ */
+
+chd_error chd_verifier::verify_continue(const UINT8 *&data, UINT32 &length)
+{
+	// the hunk we handed back last time can now be reused
+	if (m_last_item != NULL)
+		atomic_exchange32(&m_last_item->m_status, WS_READY);
+	m_last_item = NULL;
+
+	// if we're done, say so
+	data = NULL;
+	length = 0;
+	if (m_next_hunk >= m_end_hunk)
+		return CHDERR_NONE;
+
+	// queue reads of each half of the buffer as it frees up
+	while (m_read_queue_hunk < m_end_hunk)
+	{
+		UINT32 startitem = (m_read_queue_hunk - m_first_hunk) % WORK_BUFFER_HUNKS;
+		UINT32 numhunks = MIN(WORK_BUFFER_HUNKS / 2, m_end_hunk - m_read_queue_hunk);
+		UINT32 curitem;
+		for (curitem = startitem; curitem < startitem + numhunks; curitem++)
+			if (m_work_item[curitem].m_status != WS_READY)
+				break;
+
+		// if it's not all clear, defer
+		if (curitem != startitem + numhunks)
+			break;
+
+		// mark the items as reading and queue the read
+		for (curitem = startitem; curitem < startitem + numhunks; curitem++)
+			atomic_exchange32(&m_work_item[curitem].m_status, WS_READING);
+		osd_work_item_queue(m_read_queue, async_read_static, this, WORK_ITEM_FLAG_AUTO_RELEASE);
+		m_read_queue_hunk += numhunks;
+	}
+
+	// wait for the next hunk; until the reader has queued it, wait on the reader
+	work_item &item = m_work_item[(m_next_hunk - m_first_hunk) % WORK_BUFFER_HUNKS];
+	while (item.m_status != WS_COMPLETE)
+	{
+		osd_work_item *osd = (item.m_status == WS_QUEUED) ? item.m_osd : NULL;
+		if (osd != NULL)
+			osd_work_item_wait(osd, osd_ticks_per_second());
+		else
+			osd_work_queue_wait(m_read_queue, osd_ticks_per_second());
+	}
+
+	// hand it back, accumulating the SHA-1 over the logical data
+	m_last_item = &item;
+	if (item.m_error != CHDERR_NONE)
+		return item.m_error;
+	data = item.m_data;
+	length = MIN(UINT64(m_chd.hunk_bytes()), m_chd.logical_bytes() - UINT64(item.m_hunknum) * m_chd.hunk_bytes());
+	if (m_hash)
+		m_rawsha1.append(data, length);
+	m_bytes_done += length;
+	m_next_hunk++;
+	return CHDERR_NONE;
+}
+
+/**
+ * @fn  sha1_t chd_verifier::verify_finish()
+ *
+ * @brief   -------------------------------------------------
+ *            verify_finish - return the SHA-1 of all the data read
+ *          -------------------------------------------------.
+ *
+ * @return  A sha1_t.
+ */
+
+sha1_t chd_verifier::verify_finish()
+{
+	return m_rawsha1.finish();
+}
+
+/**
+ * @fn  void *chd_verifier::async_read_static(void *param, int threadid)
+ *
+ * @brief   -------------------------------------------------
+ *            async_read_static - handle asynchronous reads of stored hunk data
+ *          -------------------------------------------------.
+ *
+ * @param [in,out]  param   If non-null, the parameter.
+ * @param   threadid        The threadid.
+ *
+ * @return  null if it fails, else a void*.
+ */
+
+void *chd_verifier::async_read_static(void *param, int threadid)
+{
+	reinterpret_cast<chd_verifier *>(param)->async_read();
+	return NULL;
+}
+
+/**
+ * @fn  void chd_verifier::async_read()
+ *
+ * @brief   -------------------------------------------------
+ *            async_read - read the stored data for the next half buffer of hunks in file
+ *            order and hand each hunk off to be decompressed
+ *          -------------------------------------------------.
+ */
+
+void chd_verifier::async_read()
+{
+	UINT32 numhunks = MIN(WORK_BUFFER_HUNKS / 2, m_end_hunk - m_read_done_hunk);
+	for (UINT32 hunknum = m_read_done_hunk; hunknum < m_read_done_hunk + numhunks; hunknum++)
+	{
+		work_item &item = m_work_item[(hunknum - m_first_hunk) % WORK_BUFFER_HUNKS];
+		assert(item.m_status == WS_READING);
+
+		// release the previous work on this item
+		if (item.m_osd != NULL)
+			osd_work_item_release(item.m_osd);
+		item.m_osd = NULL;
+		item.m_hunknum = hunknum;
+		item.m_source = NULL;
+
+		// fetch blocks stored in this file; anything else, and any errors, is left to the
+		// decompressor to sort out
+		UINT64 blockoffs;
+		UINT32 blocklen;
+		if (m_chd.hunk_location(hunknum, blockoffs, blocklen) && blocklen <= m_chd.hunk_bytes())
+		{
+			if (m_chd.m_mapped != NULL && blockoffs <= m_chd.m_mapped_length && m_chd.m_mapped_length - blockoffs >= blocklen)
+				item.m_source = m_chd.m_mapped + blockoffs;
+			else
+			{
+				try
+				{
+					m_chd.file_read(blockoffs, item.m_compressed, blocklen);
+					item.m_source = item.m_compressed;
+				}
+				catch (chd_error &)
+				{
+				}
+			}
+		}
+
+		// spawn off work for the hunk
+		atomic_exchange32(&item.m_status, WS_QUEUED);
+		item.m_osd = osd_work_item_queue(m_work_queue, async_decompress_hunk_static, &item, 0);
+	}
+
+	// advance the read pointer
+	m_read_done_hunk += numhunks;
+}
+
+/**
+ * @fn  void *chd_verifier::async_decompress_hunk_static(void *param, int threadid)
+ *
+ * @brief   -------------------------------------------------
+ *            async_decompress_hunk_static - handle asynchronous decompression of a hunk
+ *          -------------------------------------------------.
+ *
+ * @param [in,out]  param   If non-null, the parameter.
+ * @param   threadid        The threadid.
+ *
+ * @return  null if it fails, else a void*.
+ */
+
+void *chd_verifier::async_decompress_hunk_static(void *param, int threadid)
+{
+	work_item *item = reinterpret_cast<work_item *>(param);
+	item->m_verifier->async_decompress_hunk(*item, threadid);
+	return NULL;
+}
+
+/**
+ * @fn  void chd_verifier::async_decompress_hunk(work_item &item, int threadid)
+ *
+ * @brief   -------------------------------------------------
+ *            async_decompress_hunk - decompress a single hunk using this thread's codecs
+ *          -------------------------------------------------.
+ *
+ * @param [in,out]  item    The item.
+ * @param   threadid        The threadid.
+ */
+
+void chd_verifier::async_decompress_hunk(work_item &item, int threadid)
+{
+	try
+	{
+		m_chd.read_hunk_internal(item.m_hunknum, item.m_data, m_decompressor[threadid], m_thread_compressed[threadid], item.m_source);
+		item.m_error = CHDERR_NONE;
+	}
+	catch (chd_error &err)
+	{
+		item.m_error = err;
+	}
+
+	// mark us complete
+	atomic_exchange32(&item.m_status, WS_COMPLETE);
+}
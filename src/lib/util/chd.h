@@ -282,6 +282,9 @@ enum chd_error
 
 class chd_codec;
 
+// callback for asynchronous hunk reads; called from the read-ahead thread
+typedef void (*chd_async_callback)(void *param, UINT32 hunknum, chd_error err);
+
 
 // ======================> chd_file
 
@@ -297,6 +300,9 @@ class chd_file
 	static const UINT32 V4_HEADER_SIZE = 108;
 	static const UINT32 V5_HEADER_SIZE = 124;
 	static const UINT32 MAX_HEADER_SIZE = V5_HEADER_SIZE;
+	static const UINT32 CACHE_DEFAULT_BYTES = 1024 * 1024;
+	static const UINT32 CACHE_DEFAULT_MAX_HUNKS = 64;
+	static const UINT32 READAHEAD_MIN_SLOTS = 8;
 
 public:
 	// construction/destruction
@@ -322,9 +328,18 @@ public:
 	sha1_t parent_sha1();
 	chd_error hunk_info(UINT32 hunknum, chd_codec_type &compressor, UINT32 &compbytes);
 
+	// cache statistics
+	UINT32 cache_hunks() const { return m_cachehunk.size(); }
+	UINT64 cache_hits() const { return m_cache_hits; }
+	UINT64 cache_misses() const { return m_cache_misses; }
+	UINT64 readahead_hits() const { return m_readahead_hits; }
+	osd_ticks_t decompress_ticks() const { return m_decompress_ticks + m_readahead_ticks; }
+
 	// setters
 	void set_raw_sha1(sha1_t rawdata);
 	void set_parent_sha1(sha1_t parent);
+	void set_cache_size(UINT32 hunks);
+	void set_readahead(UINT32 hunks);
 
 	// file create
 	chd_error create(const char *filename, UINT64 logicalbytes, UINT32 hunkbytes, UINT32 unitbytes, chd_codec_type compression[4]);
@@ -347,6 +362,14 @@ public:
 	chd_error read_bytes(UINT64 offset, void *buffer, UINT32 bytes);
 	chd_error write_bytes(UINT64 offset, const void *buffer, UINT32 bytes);
 
+	// direct access to uncompressed hunks of memory-mapped files
+	const UINT8 *mapped_hunk(UINT32 hunknum);
+	const UINT8 *mapped_bytes(UINT64 offset, UINT32 bytes);
+
+	// asynchronous reads
+	chd_error read_hunk_async(UINT32 hunknum, void *buffer = NULL, chd_async_callback callback = NULL, void *param = NULL);
+	void wait_async();
+
 	// metadata management
 	chd_error read_metadata(chd_metadata_tag searchtag, UINT32 searchindex, std::string &output);
 	chd_error read_metadata(chd_metadata_tag searchtag, UINT32 searchindex, dynamic_buffer &output);
@@ -370,6 +393,7 @@ public:
 private:
 	struct metadata_entry;
 	struct metadata_hash;
+	struct async_request;
 
 	// inline helpers
 	UINT64 be_read(const UINT8 *base, int numbytes);
@@ -395,6 +419,20 @@ private:
 	void hunk_write_compressed(UINT32 hunknum, INT8 compression, const UINT8 *compressed, UINT32 complength, crc16_t crc16);
 	void hunk_copy_from_self(UINT32 hunknum, UINT32 otherhunk);
 	void hunk_copy_from_parent(UINT32 hunknum, UINT64 parentunit);
+	bool hunk_location(UINT32 hunknum, UINT64 &blockoffs, UINT32 &blocklen);
+	void read_hunk_internal(UINT32 hunknum, UINT8 *dest, chd_decompressor **decompressor, dynamic_buffer &compbuf, const UINT8 *source = NULL);
+	void cache_allocate();
+	int cache_find(UINT32 hunknum);
+	int cache_claim(UINT32 hunknum);
+	void cache_invalidate(UINT32 hunknum);
+	bool readahead_init();
+	bool readahead_fetch(UINT32 hunknum, UINT8 *dest);
+	chd_error readahead_hunk(UINT32 hunknum);
+	void readahead_start(UINT32 hunknum);
+	static void *readahead_static(void *param, int threadid);
+	void readahead();
+	static void *async_read_static(void *param, int threadid);
+	void async_read(async_request &request);
 	bool metadata_find(chd_metadata_tag metatag, INT32 metaindex, metadata_entry &metaentry, bool resume = false);
 	void metadata_set_previous_next(UINT64 prevoffset, UINT64 nextoffset);
 	void metadata_update_hash();
@@ -405,6 +443,10 @@ private:
 	bool                    m_owns_file;        // flag indicating if this file should be closed on chd_close()
 	bool                    m_allow_reads;      // permit reads from this CHD?
 	bool                    m_allow_writes;     // permit writes to this CHD?
+	osd_lock *              m_file_lock;        // lock protecting seek/read pairs on m_file
+	const UINT8 *           m_mapped;           // memory-mapped file data, or NULL
+	UINT64                  m_mapped_length;    // length of the mapped data
+	std::vector<UINT8>      m_mapped_verified;  // which mapped hunks have had their CRC checked?
 
 	// core parameters from the header
 	UINT32                  m_version;          // version of the header
@@ -435,8 +477,34 @@ private:
 	dynamic_buffer          m_compressed;       // temporary buffer for compressed data
 
 	// caching
-	dynamic_buffer          m_cache;            // single-hunk cache for partial reads/writes
-	UINT32                  m_cachehunk;        // which hunk is in the cache?
+	UINT32                  m_cache_size;       // requested cache size in hunks (0 = default)
+	osd_lock *              m_cache_lock;       // lock protecting the cache
+	dynamic_buffer          m_cache;            // LRU cache of hunks for partial reads/writes
+	std::vector<UINT32>     m_cachehunk;        // which hunk is in each cache slot?
+	std::vector<UINT32>     m_cachestamp;       // last use of each cache slot
+	UINT32                  m_cacheclock;       // current LRU timestamp
+	UINT32                  m_cachelast;        // most recently used cache slot
+	UINT32                  m_lasthunk;         // last hunk accessed through the cache
+
+	// read-ahead
+	UINT32                  m_readahead_size;   // number of hunks to decompress ahead (0 = disabled)
+	osd_lock *              m_readahead_lock;   // lock protecting the read-ahead ring and state
+	bool                    m_readahead_allowed;// can read-ahead run on this file?
+	bool                    m_readahead_busy;   // is a read-ahead pass queued or running?
+	UINT32                  m_readahead_next;   // first hunk of the pending read-ahead pass
+	UINT32                  m_readahead_end;    // end of the hunks requested so far
+	osd_work_queue *        m_readahead_queue;  // queue for read-ahead work
+	chd_decompressor *      m_readahead_decompressor[4]; // decompression codecs for read-ahead
+	dynamic_buffer          m_readahead_compressed; // compressed data buffer for read-ahead
+	dynamic_buffer          m_readahead_buffer; // ring of hunks decompressed ahead of the reader
+	std::vector<UINT32>     m_readahead_hunk;   // which hunk is in each ring slot?
+
+	// statistics
+	UINT64                  m_cache_hits;       // reads satisfied by the cache
+	UINT64                  m_cache_misses;     // reads requiring a decompression
+	UINT64                  m_readahead_hits;   // misses satisfied by read-ahead
+	osd_ticks_t             m_decompress_ticks; // time spent decompressing on the reader's thread
+	osd_ticks_t             m_readahead_ticks;  // time spent decompressing on the read-ahead thread
 };
 
 
@@ -580,4 +648,89 @@ private:
 };
 
 
+// ======================> chd_verifier
+
+// reads back a range of hunks in order, decompressing them in parallel
+class chd_verifier
+{
+public:
+	// construction/destruction
+	chd_verifier(chd_file &chd);
+	~chd_verifier();
+
+	// verification management
+	void verify_begin(UINT32 firsthunk = 0, UINT32 numhunks = ~0, bool hash = true);
+	chd_error verify_continue(const UINT8 *&data, UINT32 &length);
+	sha1_t verify_finish();
+
+	// progress
+	double progress() const { return (m_end_hunk == m_first_hunk) ? 1.0 : double(m_next_hunk - m_first_hunk) / double(m_end_hunk - m_first_hunk); }
+	UINT64 bytes_done() const { return m_bytes_done; }
+
+private:
+	// status of a given work item
+	enum work_status
+	{
+		WS_READY = 0,
+		WS_READING,
+		WS_QUEUED,
+		WS_COMPLETE
+	};
+
+	// a single work item
+	struct work_item
+	{
+		work_item()
+			: m_osd(NULL)
+			, m_verifier(NULL)
+			, m_status(WS_READY)
+			, m_hunknum(0)
+			, m_data(NULL)
+			, m_compressed(NULL)
+			, m_source(NULL)
+			, m_error(CHDERR_NONE)
+		{ }
+
+		osd_work_item *     m_osd;              // OSD work item running on this block
+		chd_verifier *      m_verifier;         // pointer back to the verifier
+		volatile INT32      m_status;           // current status of this item
+		UINT32              m_hunknum;          // number of the hunk we're working on
+		UINT8 *             m_data;             // pointer to the decompressed data
+		UINT8 *             m_compressed;       // pointer to a buffer for the stored data
+		const UINT8 *       m_source;           // stored data read ahead of time, or NULL
+		chd_error           m_error;            // result of decompression
+	};
+
+	// internal helpers
+	static void *async_read_static(void *param, int threadid);
+	void async_read();
+	static void *async_decompress_hunk_static(void *param, int threadid);
+	void async_decompress_hunk(work_item &item, int threadid);
+
+	// range being read
+	chd_file &              m_chd;              // file we are reading
+	UINT32                  m_first_hunk;       // first hunk to read
+	UINT32                  m_end_hunk;         // hunk after the last one to read
+	UINT32                  m_next_hunk;        // next hunk to hand back
+	work_item *             m_last_item;        // item handed back last time
+	bool                    m_hash;             // are we computing the SHA-1?
+	sha1_creator            m_rawsha1;          // running SHA-1 on raw data
+	UINT64                  m_bytes_done;       // total bytes handed back
+
+	// read I/O thread
+	osd_work_queue *        m_read_queue;       // work queue for reading
+	UINT32                  m_read_queue_hunk;  // next hunk to enqueue
+	UINT32                  m_read_done_hunk;   // next hunk that will complete
+
+	// work item thread
+	static const int WORK_BUFFER_HUNKS = 256;
+	osd_work_queue *        m_work_queue;       // queue for doing work on other threads
+	dynamic_buffer          m_work_buffer;      // buffer containing decompressed hunks
+	dynamic_buffer          m_compressed_buffer;// buffer containing stored data
+	work_item               m_work_item[WORK_BUFFER_HUNKS]; // status of each hunk
+	chd_decompressor *      m_decompressor[WORK_MAX_THREADS][4]; // decompressors for each thread
+	dynamic_buffer          m_thread_compressed[WORK_MAX_THREADS]; // compressed data buffers for each thread
+};
+
+
 #endif // __CHD_H__
@@ -18,6 +18,9 @@
 #include <zlib.h>
 #include "lzma/C/LzmaEnc.h"
 #include "lzma/C/LzmaDec.h"
+#ifdef USE_ZSTD
+#include <zstd.h>
+#endif
 #include <new>
 
 
@@ -159,6 +162,46 @@ private:
 };
 
 
+#ifdef USE_ZSTD
+// ======================> chd_zstd_compressor
+
+// Zstandard compressor
+class chd_zstd_compressor : public chd_compressor
+{
+public:
+	// construction/destruction
+	chd_zstd_compressor(chd_file &chd, UINT32 hunkbytes, bool lossy);
+	~chd_zstd_compressor();
+
+	// core functionality
+	virtual UINT32 compress(const UINT8 *src, UINT32 srclen, UINT8 *dest);
+
+private:
+	// internal state
+	ZSTD_CCtx *             m_context;
+};
+
+
+// ======================> chd_zstd_decompressor
+
+// Zstandard decompressor
+class chd_zstd_decompressor : public chd_decompressor
+{
+public:
+	// construction/destruction
+	chd_zstd_decompressor(chd_file &chd, UINT32 hunkbytes, bool lossy);
+	~chd_zstd_decompressor();
+
+	// core functionality
+	virtual void decompress(const UINT8 *src, UINT32 complen, UINT8 *dest, UINT32 destlen);
+
+private:
+	// internal state
+	ZSTD_DCtx *             m_context;
+};
+#endif
+
+
 // ======================> chd_huffman_compressor
 
 // Huffman compressor
@@ -468,11 +511,17 @@ const chd_codec_list::codec_entry chd_codec_list::s_codec_list[] =
 	{ CHD_CODEC_LZMA,       false,  "LZMA",                 &chd_codec_list::construct_compressor<chd_lzma_compressor>,     &chd_codec_list::construct_decompressor<chd_lzma_decompressor> },
 	{ CHD_CODEC_HUFFMAN,    false,  "Huffman",              &chd_codec_list::construct_compressor<chd_huffman_compressor>,  &chd_codec_list::construct_decompressor<chd_huffman_decompressor> },
 	{ CHD_CODEC_FLAC,       false,  "FLAC",                 &chd_codec_list::construct_compressor<chd_flac_compressor>,     &chd_codec_list::construct_decompressor<chd_flac_decompressor> },
+#ifdef USE_ZSTD
+	{ CHD_CODEC_ZSTD,       false,  "Zstandard",            &chd_codec_list::construct_compressor<chd_zstd_compressor>,     &chd_codec_list::construct_decompressor<chd_zstd_decompressor> },
+#endif
 
 	// general codecs with CD frontend
 	{ CHD_CODEC_CD_ZLIB,    false,  "CD Deflate",           &chd_codec_list::construct_compressor<chd_cd_compressor<chd_zlib_compressor, chd_zlib_compressor> >,        &chd_codec_list::construct_decompressor<chd_cd_decompressor<chd_zlib_decompressor, chd_zlib_decompressor> > },
 	{ CHD_CODEC_CD_LZMA,    false,  "CD LZMA",              &chd_codec_list::construct_compressor<chd_cd_compressor<chd_lzma_compressor, chd_zlib_compressor> >,        &chd_codec_list::construct_decompressor<chd_cd_decompressor<chd_lzma_decompressor, chd_zlib_decompressor> > },
 	{ CHD_CODEC_CD_FLAC,    false,  "CD FLAC",              &chd_codec_list::construct_compressor<chd_cd_flac_compressor>,  &chd_codec_list::construct_decompressor<chd_cd_flac_decompressor> },
+#ifdef USE_ZSTD
+	{ CHD_CODEC_CD_ZSTD,    false,  "CD Zstandard",         &chd_codec_list::construct_compressor<chd_cd_compressor<chd_zstd_compressor, chd_zlib_compressor> >,        &chd_codec_list::construct_decompressor<chd_cd_decompressor<chd_zstd_decompressor, chd_zlib_decompressor> > },
+#endif
 
 	// A/V codecs
 	{ CHD_CODEC_AVHUFF,     false,  "A/V Huffman",          &chd_codec_list::construct_compressor<chd_avhuff_compressor>,   &chd_codec_list::construct_decompressor<chd_avhuff_decompressor> },
@@ -577,6 +626,34 @@ chd_decompressor *chd_codec_list::new_decompressor(chd_codec_type type, chd_file
 }
 
 
+//-------------------------------------------------
+//  new_compressor - create a new compressor
+//  instance of the given type for hunks of an
+//  explicit size
+//-------------------------------------------------
+
+chd_compressor *chd_codec_list::new_compressor(chd_codec_type type, chd_file &chd, UINT32 hunkbytes)
+{
+	// find in the list and construct the class
+	const codec_entry *entry = find_in_list(type);
+	return (entry == NULL) ? NULL : (*entry->m_construct_compressor)(chd, hunkbytes, entry->m_lossy);
+}
+
+
+//-------------------------------------------------
+//  new_decompressor - create a new decompressor
+//  instance of the given type for hunks of an
+//  explicit size
+//-------------------------------------------------
+
+chd_decompressor *chd_codec_list::new_decompressor(chd_codec_type type, chd_file &chd, UINT32 hunkbytes)
+{
+	// find in the list and construct the class
+	const codec_entry *entry = find_in_list(type);
+	return (entry == NULL) ? NULL : (*entry->m_construct_decompressor)(chd, hunkbytes, entry->m_lossy);
+}
+
+
 //-------------------------------------------------
 //  codec_name - return the name of the given
 //  codec
@@ -590,6 +667,18 @@ const char *chd_codec_list::codec_name(chd_codec_type type)
 }
 
 
+//-------------------------------------------------
+//  codec_by_index - return the type of the
+//  index'th known codec, or CHD_CODEC_NONE past
+//  the end of the list
+//-------------------------------------------------
+
+chd_codec_type chd_codec_list::codec_by_index(int index)
+{
+	return (index >= 0 && index < ARRAY_LENGTH(s_codec_list)) ? s_codec_list[index].m_type : CHD_CODEC_NONE;
+}
+
+
 //-------------------------------------------------
 //  find_in_list - create a new compressor
 //  instance of the given type
@@ -1178,6 +1267,95 @@ void chd_lzma_decompressor::decompress(const UINT8 *src, UINT32 complen, UINT8 *
 
 
 
+#ifdef USE_ZSTD
+
+//**************************************************************************
+//  ZSTANDARD COMPRESSOR
+//**************************************************************************
+
+//-------------------------------------------------
+//  chd_zstd_compressor - constructor
+//-------------------------------------------------
+
+chd_zstd_compressor::chd_zstd_compressor(chd_file &chd, UINT32 hunkbytes, bool lossy)
+	: chd_compressor(chd, hunkbytes, lossy),
+		m_context(ZSTD_createCCtx())
+{
+	if (m_context == NULL)
+		throw CHDERR_CODEC_ERROR;
+}
+
+
+//-------------------------------------------------
+//  ~chd_zstd_compressor - destructor
+//-------------------------------------------------
+
+chd_zstd_compressor::~chd_zstd_compressor()
+{
+	ZSTD_freeCCtx(m_context);
+}
+
+
+//-------------------------------------------------
+//  compress - compress data using the Zstandard
+//  codec
+//-------------------------------------------------
+
+UINT32 chd_zstd_compressor::compress(const UINT8 *src, UINT32 srclen, UINT8 *dest)
+{
+	// the context is reused across hunks so only the tables are reset; a
+	// result that doesn't fit in the hunk comes back as an error
+	size_t complen = ZSTD_compressCCtx(m_context, dest, hunkbytes(), src, srclen, ZSTD_maxCLevel());
+	if (ZSTD_isError(complen) || complen >= hunkbytes())
+		throw CHDERR_COMPRESSION_ERROR;
+	return complen;
+}
+
+
+
+//**************************************************************************
+//  ZSTANDARD DECOMPRESSOR
+//**************************************************************************
+
+//-------------------------------------------------
+//  chd_zstd_decompressor - constructor
+//-------------------------------------------------
+
+chd_zstd_decompressor::chd_zstd_decompressor(chd_file &chd, UINT32 hunkbytes, bool lossy)
+	: chd_decompressor(chd, hunkbytes, lossy),
+		m_context(ZSTD_createDCtx())
+{
+	if (m_context == NULL)
+		throw CHDERR_CODEC_ERROR;
+}
+
+
+//-------------------------------------------------
+//  ~chd_zstd_decompressor - destructor
+//-------------------------------------------------
+
+chd_zstd_decompressor::~chd_zstd_decompressor()
+{
+	ZSTD_freeDCtx(m_context);
+}
+
+
+//-------------------------------------------------
+//  decompress - decompress data using the
+//  Zstandard codec
+//-------------------------------------------------
+
+void chd_zstd_decompressor::decompress(const UINT8 *src, UINT32 complen, UINT8 *dest, UINT32 destlen)
+{
+	size_t decodedlen = ZSTD_decompressDCtx(m_context, dest, destlen, src, complen);
+	if (ZSTD_isError(decodedlen) || decodedlen != destlen)
+		throw CHDERR_DECOMPRESSION_ERROR;
+}
+
+#endif
+
+
+
 //**************************************************************************
 //  HUFFMAN COMPRESSOR
 //**************************************************************************
@@ -106,10 +106,13 @@ public:
 	// create compressors or decompressors
 	static chd_compressor *new_compressor(chd_codec_type type, chd_file &file);
 	static chd_decompressor *new_decompressor(chd_codec_type type, chd_file &file);
+	static chd_compressor *new_compressor(chd_codec_type type, chd_file &file, UINT32 hunkbytes);
+	static chd_decompressor *new_decompressor(chd_codec_type type, chd_file &file, UINT32 hunkbytes);
 
 	// utilities
 	static bool codec_exists(chd_codec_type type) { return (find_in_list(type) != NULL); }
 	static const char *codec_name(chd_codec_type type);
+	static chd_codec_type codec_by_index(int index);
 
 private:
 	// an entry in the list
@@ -174,11 +177,13 @@ const chd_codec_type CHD_CODEC_ZLIB         = CHD_MAKE_TAG('z','l','i','b');
 const chd_codec_type CHD_CODEC_LZMA         = CHD_MAKE_TAG('l','z','m','a');
 const chd_codec_type CHD_CODEC_HUFFMAN      = CHD_MAKE_TAG('h','u','f','f');
 const chd_codec_type CHD_CODEC_FLAC         = CHD_MAKE_TAG('f','l','a','c');
+const chd_codec_type CHD_CODEC_ZSTD         = CHD_MAKE_TAG('z','s','t','d');
 
 // general codecs with CD frontend
 const chd_codec_type CHD_CODEC_CD_ZLIB      = CHD_MAKE_TAG('c','d','z','l');
 const chd_codec_type CHD_CODEC_CD_LZMA      = CHD_MAKE_TAG('c','d','l','z');
 const chd_codec_type CHD_CODEC_CD_FLAC      = CHD_MAKE_TAG('c','d','f','l');
+const chd_codec_type CHD_CODEC_CD_ZSTD      = CHD_MAKE_TAG('c','d','z','s');
 
 // A/V codecs
 const chd_codec_type CHD_CODEC_AVHUFF       = CHD_MAKE_TAG('a','v','h','u');
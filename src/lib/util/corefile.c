@@ -70,6 +70,7 @@ struct core_file
 	UINT32          openflags;                  /* flags we were opened with */
 	UINT8           data_allocated;             /* was the data allocated by us? */
 	UINT8 *         data;                       /* file data, if RAM-based */
+	const void *    mapped;                     /* file data, if memory-mapped */
 	UINT64          offset;                     /* current file offset */
 	UINT64          length;                     /* total file length */
 	text_file_type  text_type;                  /* text output format */
@@ -214,6 +215,8 @@ void core_fclose(core_file *file)
 		core_fcompress(file, FCOMPRESS_NONE);
 	if (file->file != NULL)
 		osd_close(file->file);
+	if (file->mapped != NULL)
+		osd_unmap(file->mapped, file->length);
 	if (file->data != NULL && file->data_allocated)
 		free(file->data);
 	free(file);
@@ -684,6 +687,30 @@ const void *core_fbuffer(core_file *file)
 }
 
 
+/*-------------------------------------------------
+    core_fmap - return a pointer to the file data
+    mapped into memory, or NULL if the file cannot
+    be mapped; unlike core_fbuffer, this never
+    reads the file into RAM
+-------------------------------------------------*/
+
+const void *core_fmap(core_file *file)
+{
+	/* RAM-based files are already in memory */
+	if (file->data != NULL)
+		return file->data;
+	if (file->mapped != NULL)
+		return file->mapped;
+
+	/* only plain files opened read-only can be mapped */
+	if (file->file == NULL || file->zdata != NULL || (file->openflags & OPEN_FLAG_WRITE) != 0 || !file->length)
+		return NULL;
+	if (osd_map(file->file, file->length, &file->mapped) != FILERR_NONE)
+		file->mapped = NULL;
+	return file->mapped;
+}
+
+
 /*-------------------------------------------------
     core_fload - open a file with the specified
     filename, read it into memory, and return a
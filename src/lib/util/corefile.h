@@ -99,6 +99,10 @@ char *core_fgets(char *s, int n, core_file *file);
 /* this function may cause the full file data to be read */
 const void *core_fbuffer(core_file *file);
 
+/* get a pointer to the full file data mapped into memory; returns NULL if the file cannot be mapped */
+/* only works for files opened read-only; the pointer remains valid until the file is closed */
+const void *core_fmap(core_file *file);
+
 /* open a file with the specified filename, read it into memory, and return a pointer */
 file_error core_fload(const char *filename, void **data, UINT32 *length);
 file_error core_fload(const char *filename, dynamic_buffer &data);
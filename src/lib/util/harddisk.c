@@ -23,6 +23,7 @@ struct hard_disk_file
 {
 	chd_file *          chd;                /* CHD file */
 	hard_disk_info      info;               /* hard disk info */
+	UINT32              lasthunk;           /* last hunk read, for prefetching */
 };
 
 
@@ -67,6 +68,7 @@ hard_disk_file *hard_disk_open(chd_file *chd)
 	file->info.heads = heads;
 	file->info.sectors = sectors;
 	file->info.sectorbytes = sectorbytes;
+	file->lasthunk = ~0;
 	return file;
 }
 
@@ -133,6 +135,14 @@ hard_disk_info *hard_disk_get_info(hard_disk_file *file)
 UINT32 hard_disk_read(hard_disk_file *file, UINT32 lbasector, void *buffer)
 {
 	chd_error err = file->chd->read_units(lbasector, buffer);
+
+	/* when we move onto a new hunk, start fetching the next one in the background */
+	UINT32 hunk = UINT64(lbasector) * file->chd->unit_bytes() / file->chd->hunk_bytes();
+	if (hunk != file->lasthunk)
+	{
+		file->lasthunk = hunk;
+		file->chd->read_hunk_async(hunk + 1);
+	}
 	return (err == CHDERR_NONE);
 }
 
@@ -159,3 +169,27 @@ UINT32 hard_disk_write(hard_disk_file *file, UINT32 lbasector, const void *buffe
 	chd_error err = file->chd->write_units(lbasector, buffer);
 	return (err == CHDERR_NONE);
 }
+
+
+/*-------------------------------------------------
+    hard_disk_get_sector_pointer - return a
+    direct pointer to a sector of a memory-mapped
+    uncompressed disk, or NULL if the sector must
+    be read with hard_disk_read
+-------------------------------------------------*/
+
+/**
+ * @fn  const void *hard_disk_get_sector_pointer(hard_disk_file *file, UINT32 lbasector)
+ *
+ * @brief   Hard disk get sector pointer.
+ *
+ * @param [in,out]  file    If non-null, the file.
+ * @param   lbasector       The lbasector.
+ *
+ * @return  null if the sector is not mapped, else a pointer to the sector data.
+ */
+
+const void *hard_disk_get_sector_pointer(hard_disk_file *file, UINT32 lbasector)
+{
+	return file->chd->mapped_bytes(UINT64(lbasector) * file->chd->unit_bytes(), file->chd->unit_bytes());
+}
@@ -11,6 +11,22 @@
 #include "hashing.h"
 #include <zlib.h>
 
+// x86 hosts whose compiler can target single functions at instruction set
+// extensions get PCLMULQDQ CRC-32 and SHA-NI SHA-1, chosen at runtime
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define HASHING_X86         1
+#define HASHING_TARGET(x)   __attribute__((target(x)))
+#include <cpuid.h>
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define HASHING_X86         1
+#define HASHING_TARGET(x)
+#include <intrin.h>
+#include <immintrin.h>
+#else
+#define HASHING_X86         0
+#endif
+
 
 //**************************************************************************
 //  CONSTANTS
@@ -23,6 +39,275 @@ const sha1_t sha1_t::null = { { 0 } };
 
 
 
+//**************************************************************************
+//  TYPE DEFINITIONS
+//**************************************************************************
+
+// a CRC-32 implementation; takes and returns the CRC in zlib's convention
+typedef UINT32 (*crc32_func)(UINT32 crc, const UINT8 *data, UINT32 length);
+
+
+
+//**************************************************************************
+//  PORTABLE IMPLEMENTATIONS
+//**************************************************************************
+
+//-------------------------------------------------
+//  crc32_zlib - CRC-32 via zlib
+//-------------------------------------------------
+
+static UINT32 crc32_zlib(UINT32 crc, const UINT8 *data, UINT32 length)
+{
+	return crc32(crc, reinterpret_cast<const Bytef *>(data), length);
+}
+
+
+
+//**************************************************************************
+//  X86 IMPLEMENTATIONS
+//**************************************************************************
+
+#if HASHING_X86
+
+// CPU features we care about
+const UINT32 X86_PCLMUL = 0x01;
+const UINT32 X86_SSSE3  = 0x02;
+const UINT32 X86_SSE41  = 0x04;
+const UINT32 X86_SHA    = 0x08;
+
+
+//-------------------------------------------------
+//  x86_features - query CPUID for the features
+//  the accelerated implementations need
+//-------------------------------------------------
+
+static UINT32 x86_features()
+{
+	UINT32 maxleaf, ecx1 = 0, ebx7 = 0;
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	maxleaf = info[0];
+	if (maxleaf >= 1)
+	{
+		__cpuid(info, 1);
+		ecx1 = info[2];
+	}
+	if (maxleaf >= 7)
+	{
+		__cpuidex(info, 7, 0);
+		ebx7 = info[1];
+	}
+#else
+	unsigned int eax, ebx, ecx, edx;
+	maxleaf = __get_cpuid_max(0, NULL);
+	if (maxleaf >= 1)
+	{
+		__cpuid(1, eax, ebx, ecx, edx);
+		ecx1 = ecx;
+	}
+	if (maxleaf >= 7)
+	{
+		__cpuid_count(7, 0, eax, ebx, ecx, edx);
+		ebx7 = ebx;
+	}
+#endif
+
+	UINT32 result = 0;
+	if (ecx1 & (1 << 1)) result |= X86_PCLMUL;
+	if (ecx1 & (1 << 9)) result |= X86_SSSE3;
+	if (ecx1 & (1 << 19)) result |= X86_SSE41;
+	if (ebx7 & (1 << 29)) result |= X86_SHA;
+	return result;
+}
+
+
+//-------------------------------------------------
+//  crc32_pclmul_fold - fold a multiple of 16
+//  bytes (at least 64) into an inverted CRC using
+//  carry-less multiplies, per Intel's "Fast CRC
+//  Computation for Generic Polynomials Using
+//  PCLMULQDQ Instruction"
+//-------------------------------------------------
+
+HASHING_TARGET("pclmul,sse4.1")
+static UINT32 crc32_pclmul_fold(UINT32 crc, const UINT8 *data, UINT32 length)
+{
+	// bit-reflected constants for the zlib polynomial: x^(4*128+-64) and
+	// x^(128+-64) mod P for folding, x^64 mod P for the 64-bit step, then
+	// P and mu for the Barrett reduction
+	const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596LL, 0x0154442bd4LL);
+	const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009eLL, 0x01751997d0LL);
+	const __m128i k5k0 = _mm_set_epi64x(0, 0x0163cd6124LL);
+	const __m128i poly = _mm_set_epi64x(0x01f7011641LL, 0x01db710641LL);
+	const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+
+	// start four lanes of 128 bits each, with the CRC mixed into the first
+	__m128i x1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x00));
+	__m128i x2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x10));
+	__m128i x3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x20));
+	__m128i x4 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x30));
+	x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(crc));
+	data += 64;
+	length -= 64;
+
+	// fold 64 bytes at a time into the four lanes
+	while (length >= 64)
+	{
+		__m128i x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+		__m128i x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+		__m128i x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+		__m128i x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+		x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+		x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+		x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x00)));
+		x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x10)));
+		x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x20)));
+		x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x30)));
+		data += 64;
+		length -= 64;
+	}
+
+	// fold the four lanes down into one
+	__m128i x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+	x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x2), x5);
+	x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+	x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x3), x5);
+	x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+	x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x4), x5);
+
+	// fold any remaining 16-byte blocks into it
+	while (length >= 16)
+	{
+		x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+		x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), _mm_loadu_si128(reinterpret_cast<const __m128i *>(data))), x5);
+		data += 16;
+		length -= 16;
+	}
+
+	// reduce 128 bits to 64
+	x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+	x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+	x2 = _mm_srli_si128(x1, 4);
+	x1 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k5k0, 0x00), x2);
+
+	// Barrett reduce to 32 bits
+	x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), poly, 0x10);
+	x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, mask32), poly, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+	return _mm_extract_epi32(x1, 1);
+}
+
+
+//-------------------------------------------------
+//  crc32_pclmul - CRC-32 using PCLMULQDQ for the
+//  bulk of the data and zlib for the tail
+//-------------------------------------------------
+
+static UINT32 crc32_pclmul(UINT32 crc, const UINT8 *data, UINT32 length)
+{
+	if (length >= 64)
+	{
+		UINT32 chunk = length & ~15;
+		crc = ~crc32_pclmul_fold(~crc, data, chunk);
+		data += chunk;
+		length -= chunk;
+	}
+	return (length == 0) ? crc : crc32_zlib(crc, data, length);
+}
+
+
+//-------------------------------------------------
+//  sha1_shani - SHA-1 block compression using
+//  the SHA extensions; each group of four rounds
+//  also advances the message schedule for the
+//  groups after it
+//-------------------------------------------------
+
+#define SHA1_SHANI_GROUP(g, func, enext, esave) \
+	enext = _mm_sha1nexte_epu32(enext, msg[(g) & 3]); \
+	esave = abcd; \
+	if ((g) >= 3 && (g) <= 18) msg[((g) + 1) & 3] = _mm_sha1msg2_epu32(msg[((g) + 1) & 3], msg[(g) & 3]); \
+	abcd = _mm_sha1rnds4_epu32(abcd, enext, func); \
+	if ((g) >= 1 && (g) <= 16) msg[((g) + 3) & 3] = _mm_sha1msg1_epu32(msg[((g) + 3) & 3], msg[(g) & 3]); \
+	if ((g) >= 2 && (g) <= 17) msg[((g) + 2) & 3] = _mm_xor_si128(msg[((g) + 2) & 3], msg[(g) & 3]);
+
+HASHING_TARGET("sha,ssse3,sse4.1")
+static void sha1_shani(UINT32 *state, const UINT8 *data, unsigned blocks)
+{
+	const __m128i bswap = _mm_set_epi64x(0x0001020304050607LL, 0x08090a0b0c0d0e0fLL);
+
+	// state words go in high-to-low lane order
+	__m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(state)), 0x1b);
+	__m128i e0 = _mm_set_epi32(state[4], 0, 0, 0);
+	__m128i e1;
+	__m128i msg[4];
+
+	for ( ; blocks != 0; blocks--, data += 64)
+	{
+		__m128i abcd_save = abcd;
+		__m128i e0_save = e0;
+
+		for (int index = 0; index < 4; index++)
+			msg[index] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + index * 16)), bswap);
+
+		// the first group adds E directly; the rest derive it from the saved A
+		e0 = _mm_add_epi32(e0, msg[0]);
+		e1 = abcd;
+		abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+		SHA1_SHANI_GROUP( 1, 0, e1, e0)
+		SHA1_SHANI_GROUP( 2, 0, e0, e1)
+		SHA1_SHANI_GROUP( 3, 0, e1, e0)
+		SHA1_SHANI_GROUP( 4, 0, e0, e1)
+		SHA1_SHANI_GROUP( 5, 1, e1, e0)
+		SHA1_SHANI_GROUP( 6, 1, e0, e1)
+		SHA1_SHANI_GROUP( 7, 1, e1, e0)
+		SHA1_SHANI_GROUP( 8, 1, e0, e1)
+		SHA1_SHANI_GROUP( 9, 1, e1, e0)
+		SHA1_SHANI_GROUP(10, 2, e0, e1)
+		SHA1_SHANI_GROUP(11, 2, e1, e0)
+		SHA1_SHANI_GROUP(12, 2, e0, e1)
+		SHA1_SHANI_GROUP(13, 2, e1, e0)
+		SHA1_SHANI_GROUP(14, 2, e0, e1)
+		SHA1_SHANI_GROUP(15, 3, e1, e0)
+		SHA1_SHANI_GROUP(16, 3, e0, e1)
+		SHA1_SHANI_GROUP(17, 3, e1, e0)
+		SHA1_SHANI_GROUP(18, 3, e0, e1)
+		SHA1_SHANI_GROUP(19, 3, e1, e0)
+
+		// add this block's result into the state
+		e0 = _mm_sha1nexte_epu32(e0, e0_save);
+		abcd = _mm_add_epi32(abcd, abcd_save);
+	}
+
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(state), _mm_shuffle_epi32(abcd, 0x1b));
+	state[4] = _mm_extract_epi32(e0, 3);
+}
+
+#undef SHA1_SHANI_GROUP
+
+#endif // HASHING_X86
+
+
+
+//**************************************************************************
+//  IMPLEMENTATION SELECTION
+//**************************************************************************
+
+// implementations in use
+static crc32_func s_crc32_func = crc32_zlib;
+static const char *s_crc32_name = "zlib";
+static const char *s_sha1_name = "portable";
+
+// pick the fastest available ones at startup
+static const bool s_crc32_accelerated = crc32_creator::set_accelerated(true);
+static const bool s_sha1_accelerated = sha1_creator::set_accelerated(true);
+
+
+
 //**************************************************************************
 //  INLINE FUNCTIONS
 //**************************************************************************
@@ -88,6 +373,38 @@ const char *sha1_t::as_string(std::string &buffer) const
 }
 
 
+//-------------------------------------------------
+//  set_accelerated - use a CPU-specific
+//  implementation if one is available; returns
+//  true if one is now in use
+//-------------------------------------------------
+
+bool sha1_creator::set_accelerated(bool enable)
+{
+	sha1_set_compress(NULL);
+	s_sha1_name = "portable";
+#if HASHING_X86
+	if (enable && (x86_features() & (X86_SHA | X86_SSSE3 | X86_SSE41)) == (X86_SHA | X86_SSSE3 | X86_SSE41))
+	{
+		sha1_set_compress(sha1_shani);
+		s_sha1_name = "sha-ni";
+	}
+#endif
+	return (strcmp(s_sha1_name, "portable") != 0);
+}
+
+
+//-------------------------------------------------
+//  implementation - name of the implementation
+//  in use
+//-------------------------------------------------
+
+const char *sha1_creator::implementation()
+{
+	return s_sha1_name;
+}
+
+
 //**************************************************************************
 //  MD-5 HELPERS
 //**************************************************************************
@@ -180,7 +497,39 @@ const char *crc32_t::as_string(std::string &buffer) const
 
 void crc32_creator::append(const void *data, UINT32 length)
 {
-	m_accum.m_raw = crc32(m_accum, reinterpret_cast<const Bytef *>(data), length);
+	m_accum.m_raw = (*s_crc32_func)(m_accum, reinterpret_cast<const UINT8 *>(data), length);
+}
+
+
+//-------------------------------------------------
+//  set_accelerated - use a CPU-specific
+//  implementation if one is available; returns
+//  true if one is now in use
+//-------------------------------------------------
+
+bool crc32_creator::set_accelerated(bool enable)
+{
+	s_crc32_func = crc32_zlib;
+	s_crc32_name = "zlib";
+#if HASHING_X86
+	if (enable && (x86_features() & (X86_PCLMUL | X86_SSE41)) == (X86_PCLMUL | X86_SSE41))
+	{
+		s_crc32_func = crc32_pclmul;
+		s_crc32_name = "pclmulqdq";
+	}
+#endif
+	return (s_crc32_func != crc32_zlib);
+}
+
+
+//-------------------------------------------------
+//  implementation - name of the implementation
+//  in use
+//-------------------------------------------------
+
+const char *crc32_creator::implementation()
+{
+	return s_crc32_name;
 }
 
 
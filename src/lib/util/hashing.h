@@ -69,6 +69,10 @@ public:
 		return creator.finish();
 	}
 
+	// implementation selection
+	static bool set_accelerated(bool enable);
+	static const char *implementation();
+
 protected:
 	// internal state
 	struct sha1_ctx     m_context;      // internal context
@@ -165,6 +169,10 @@ public:
 		return creator.finish();
 	}
 
+	// implementation selection
+	static bool set_accelerated(bool enable);
+	static const char *implementation();
+
 protected:
 	// internal state
 	crc32_t             m_accum;        // internal accumulator
@@ -119,6 +119,23 @@ static void WRITE_UINT32(unsigned char* data, UINT32 val)
 #define subRound(a, b, c, d, e, f, k, data) \
 	( e += ROTL( 5, a ) + f( b, c, d ) + k + data, b = ROTL( 30, b ) )
 
+/* Accelerated block compression, or NULL to use sha1_transform */
+static sha1_compress_func sha1_compress;
+
+/**
+ * @fn  void sha1_set_compress(sha1_compress_func compress)
+ *
+ * @brief   Sets the function used to compress whole blocks.
+ *
+ * @param   compress    The function, or NULL for the portable implementation.
+ */
+
+void
+sha1_set_compress(sha1_compress_func compress)
+{
+	sha1_compress = compress;
+}
+
 /* Initialize the SHA values */
 
 /**
@@ -324,6 +341,16 @@ sha1_update(struct sha1_ctx *ctx,
 		length -= left;
 	}
 	}
+	if (sha1_compress != NULL && length >= SHA1_DATA_SIZE)
+	{ /* Hand whole blocks to the accelerated implementation */
+		unsigned blocks = length / SHA1_DATA_SIZE;
+		(*sha1_compress)(ctx->digest, buffer, blocks);
+		ctx->count_low += blocks;
+		if (ctx->count_low < blocks)
+	++ctx->count_high;
+		buffer += blocks * SHA1_DATA_SIZE;
+		length -= blocks * SHA1_DATA_SIZE;
+	}
 	while (length >= SHA1_DATA_SIZE)
 	{
 		sha1_block(ctx, buffer);
@@ -44,6 +44,13 @@ struct sha1_ctx
 	unsigned int index;                     /* index into buffer */
 };
 
+/* Compresses whole blocks straight from the input; used to plug in
+   CPU-specific implementations. */
+typedef void (*sha1_compress_func)(UINT32 *state, const UINT8 *data, unsigned blocks);
+
+void
+sha1_set_compress(sha1_compress_func compress);
+
 void
 sha1_init(struct sha1_ctx *ctx);
 
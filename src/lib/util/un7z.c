@@ -11,6 +11,7 @@
 // this is based on unzip.c, with modifications needed to use the 7zip library
 
 #include "osdcore.h"
+#include "eminline.h"
 #include "un7z.h"
 
 #include <ctype.h>
@@ -158,8 +159,26 @@ void FileOutStream_CreateVTable(CFileOutStream *p)
     CONSTANTS
 ***************************************************************************/
 
-/* number of open files to cache */
-#define _7Z_CACHE_SIZE  8
+/* number of open files to cache; each may hold a decompressed solid block */
+#define _7Z_CACHE_SIZE  16
+
+/* end of a chain in the member index */
+#define _7Z_INDEX_END   0xffffffff
+
+
+/***************************************************************************
+    TYPE DEFINITIONS
+***************************************************************************/
+
+/* hash tables for finding contained files by name or crc */
+struct _7z_index
+{
+	UINT32          buckets;                /* number of buckets (a power of 2) */
+	UINT32 *        name_head;              /* first file in each name bucket */
+	UINT32 *        crc_head;               /* first file in each crc bucket */
+	UINT32 *        name_next;              /* next file with the same name hash */
+	UINT32 *        crc_next;               /* next file with the same crc hash */
+};
 
 
 /***************************************************************************
@@ -167,6 +186,11 @@ void FileOutStream_CreateVTable(CFileOutStream *p)
 ***************************************************************************/
 
 static _7z_file *_7z_cache[_7Z_CACHE_SIZE];
+static osd_lock *_7z_cache_lock;
+
+/* statistics; all but searches are protected by the cache lock */
+static _7z_cache_stats _7z_stats;
+static INT32 volatile _7z_searches;
 
 /***************************************************************************
     FUNCTION PROTOTYPES
@@ -174,6 +198,45 @@ static _7z_file *_7z_cache[_7Z_CACHE_SIZE];
 
 /* cache management */
 static void free__7z_file(_7z_file *_7z);
+static void _7z_cache_acquire(void);
+
+/* indexing */
+static _7z_error build_index(_7z_file *_7z);
+
+
+
+/***************************************************************************
+    INLINE FUNCTIONS
+***************************************************************************/
+
+/*-------------------------------------------------
+    hash_name - hash a filename, folding ASCII
+    case the same way the name search does
+-------------------------------------------------*/
+
+INLINE UINT32 hash_name(const char *name, int length)
+{
+	UINT32 hash = 2166136261U;
+	while (length-- > 0)
+	{
+		UINT16 c = (UINT8)*name++;
+		if (c >= 0x41 && c <= 0x5a) c += 0x20;
+		hash = (hash ^ c) * 16777619U;
+	}
+	return hash;
+}
+
+INLINE UINT32 hash_name(const UInt16 *name, int length)
+{
+	UINT32 hash = 2166136261U;
+	while (length-- > 0)
+	{
+		UINT16 c = *name++;
+		if (c >= 0x41 && c <= 0x5a) c += 0x20;
+		hash = (hash ^ c) * 16777619U;
+	}
+	return hash;
+}
 
 
 /***************************************************************************
@@ -189,7 +252,22 @@ int _7z_search_crc_match(_7z_file *new_7z, UINT32 search_crc, const char* search
 	UInt16 *temp = NULL;
 	size_t tempSize = 0;
 
-	for (int i = 0; i < new_7z->db.db.NumFiles; i++)
+	/* nothing can match if we aren't matching anything */
+	if (!matchcrc && !matchname)
+		return -1;
+
+	/* index the headers on first use */
+	if (new_7z->index == NULL && build_index(new_7z) != _7ZERR_NONE)
+		return -1;
+	atomic_increment32(&_7z_searches);
+
+	/* walk the chain of files that might match; name searches use the name chain */
+	_7z_index *index = new_7z->index;
+	UINT32 *head = matchname ? index->name_head : index->crc_head;
+	UINT32 *next = matchname ? index->name_next : index->crc_next;
+	UINT32 bucket = (matchname ? hash_name(search_filename, search_filename_length) : search_crc) & (index->buckets - 1);
+
+	for (UINT32 i = head[bucket]; i != _7Z_INDEX_END; i = next[i])
 	{
 		const CSzFileItem *f = new_7z->db.db.Files + i;
 		size_t len;
@@ -290,19 +368,27 @@ _7z_error _7z_file_open(const char *filename, _7z_file **_7z)
 	/* ensure we start with a NULL result */
 	*_7z = NULL;
 
+	UINT32 hash = hash_name(filename, strlen(filename));
+
 	/* see if we are in the cache, and reopen if so */
+	_7z_cache_acquire();
 	for (cachenum = 0; cachenum < ARRAY_LENGTH(_7z_cache); cachenum++)
 	{
 		_7z_file *cached = _7z_cache[cachenum];
 
 		/* if we have a valid entry and it matches our filename, use it and remove from the cache */
-		if (cached != NULL && cached->filename != NULL && strcmp(filename, cached->filename) == 0)
+		if (cached != NULL && cached->filename_hash == hash && cached->filename != NULL && strcmp(filename, cached->filename) == 0)
 		{
 			*_7z = cached;
-			_7z_cache[cachenum] = NULL;
+			memmove(&_7z_cache[cachenum], &_7z_cache[cachenum + 1], (ARRAY_LENGTH(_7z_cache) - cachenum - 1) * sizeof(_7z_cache[0]));
+			_7z_cache[ARRAY_LENGTH(_7z_cache) - 1] = NULL;
+			_7z_stats.hits++;
+			osd_lock_release(_7z_cache_lock);
 			return _7ZERR_NONE;
 		}
 	}
+	_7z_stats.misses++;
+	osd_lock_release(_7z_cache_lock);
 
 	/* allocate memory for the _7z_file structure */
 	new_7z = (_7z_file *)malloc(sizeof(*new_7z));
@@ -362,6 +448,7 @@ _7z_error _7z_file_open(const char *filename, _7z_file **_7z)
 	}
 	strcpy(string, filename);
 	new_7z->filename = string;
+	new_7z->filename_hash = hash;
 	*_7z = new_7z;
 	return _7ZERR_NONE;
 
@@ -386,18 +473,23 @@ void _7z_file_close(_7z_file *_7z)
 	_7z->archiveStream.file._7z_osdfile = NULL;
 
 	/* find the first NULL entry in the cache */
+	_7z_cache_acquire();
 	for (cachenum = 0; cachenum < ARRAY_LENGTH(_7z_cache); cachenum++)
 		if (_7z_cache[cachenum] == NULL)
 			break;
 
 	/* if no room left in the cache, free the bottommost entry */
 	if (cachenum == ARRAY_LENGTH(_7z_cache))
+	{
 		free__7z_file(_7z_cache[--cachenum]);
+		_7z_stats.evictions++;
+	}
 
 	/* move everyone else down and place us at the top */
 	if (cachenum != 0)
 		memmove(&_7z_cache[1], &_7z_cache[0], cachenum * sizeof(_7z_cache[0]));
 	_7z_cache[0] = _7z;
+	osd_lock_release(_7z_cache_lock);
 }
 
 
@@ -411,12 +503,28 @@ void _7z_file_cache_clear(void)
 	int cachenum;
 
 	/* clear call cache entries */
+	_7z_cache_acquire();
 	for (cachenum = 0; cachenum < ARRAY_LENGTH(_7z_cache); cachenum++)
 		if (_7z_cache[cachenum] != NULL)
 		{
 			free__7z_file(_7z_cache[cachenum]);
 			_7z_cache[cachenum] = NULL;
 		}
+	osd_lock_release(_7z_cache_lock);
+}
+
+
+/*-------------------------------------------------
+    _7z_file_cache_stats - return statistics on
+    the _7Z file cache
+-------------------------------------------------*/
+
+void _7z_file_cache_stats(_7z_cache_stats *stats)
+{
+	_7z_cache_acquire();
+	*stats = _7z_stats;
+	stats->searches = _7z_searches;
+	osd_lock_release(_7z_cache_lock);
 }
 
 
@@ -488,7 +596,116 @@ static void free__7z_file(_7z_file *_7z)
 		if (_7z->outBuffer) IAlloc_Free(&_7z->allocImp, _7z->outBuffer);
 		if (_7z->inited) SzArEx_Free(&_7z->db, &_7z->allocImp);
 
+		if (_7z->index != NULL)
+		{
+			free(_7z->index->name_head);
+			free(_7z->index->crc_head);
+			free(_7z->index->name_next);
+			free(_7z->index->crc_next);
+			free(_7z->index);
+		}
+
 
 		free(_7z);
 	}
 }
+
+
+/*-------------------------------------------------
+    _7z_cache_acquire - acquire the cache lock,
+    allocating it on first use
+-------------------------------------------------*/
+
+/**
+ * @fn  static void _7z_cache_acquire(void)
+ *
+ * @brief   Acquires the 7z cache lock.
+ */
+
+static void _7z_cache_acquire(void)
+{
+	/* allocate the lock on first use; if two threads race, the loser frees its copy */
+	if (_7z_cache_lock == NULL)
+	{
+		osd_lock *lock = osd_lock_alloc();
+		if (compare_exchange_ptr((void * volatile *)&_7z_cache_lock, NULL, lock) != NULL)
+			osd_lock_free(lock);
+	}
+	osd_lock_acquire(_7z_cache_lock);
+}
+
+
+
+/***************************************************************************
+    INDEXING
+***************************************************************************/
+
+/*-------------------------------------------------
+    build_index - build the tables used to find
+    contained files by name and crc
+-------------------------------------------------*/
+
+static _7z_error build_index(_7z_file *_7z)
+{
+	UINT32 files = _7z->db.db.NumFiles;
+	UInt16 *temp = NULL;
+	size_t tempSize = 0;
+
+	/* size the tables to keep chains short */
+	UINT32 buckets = 16;
+	while (buckets < files)
+		buckets *= 2;
+
+	_7z_index *index = (_7z_index *)malloc(sizeof(*index));
+	if (index == NULL)
+		return _7ZERR_OUT_OF_MEMORY;
+	index->buckets = buckets;
+	index->name_head = (UINT32 *)malloc(buckets * sizeof(index->name_head[0]));
+	index->crc_head = (UINT32 *)malloc(buckets * sizeof(index->crc_head[0]));
+	index->name_next = (UINT32 *)malloc(MAX(files, 1) * sizeof(index->name_next[0]));
+	index->crc_next = (UINT32 *)malloc(MAX(files, 1) * sizeof(index->crc_next[0]));
+	if (index->name_head == NULL || index->crc_head == NULL || index->name_next == NULL || index->crc_next == NULL)
+		goto error;
+	memset(index->name_head, 0xff, buckets * sizeof(index->name_head[0]));
+	memset(index->crc_head, 0xff, buckets * sizeof(index->crc_head[0]));
+
+	/* link the files in reverse so chains run in archive order; directories are never matched */
+	for (UINT32 i = files; i-- > 0; )
+	{
+		const CSzFileItem *f = _7z->db.db.Files + i;
+		if (f->IsDir)
+			continue;
+
+		size_t len = SzArEx_GetFileNameUtf16(&_7z->db, i, NULL);
+		if (len > tempSize)
+		{
+			SZipFree(NULL, temp);
+			tempSize = len;
+			temp = (UInt16 *)SZipAlloc(NULL, tempSize * sizeof(temp[0]));
+			if (temp == NULL)
+				goto error;
+		}
+		SzArEx_GetFileNameUtf16(&_7z->db, i, temp);
+
+		/* the length includes the terminating NUL */
+		UINT32 namebucket = hash_name(temp, (len > 0) ? len - 1 : 0) & (buckets - 1);
+		UINT32 crcbucket = f->Crc & (buckets - 1);
+		index->name_next[i] = index->name_head[namebucket];
+		index->name_head[namebucket] = i;
+		index->crc_next[i] = index->crc_head[crcbucket];
+		index->crc_head[crcbucket] = i;
+	}
+	SZipFree(NULL, temp);
+
+	_7z->index = index;
+	return _7ZERR_NONE;
+
+error:
+	SZipFree(NULL, temp);
+	free(index->name_head);
+	free(index->crc_head);
+	free(index->name_next);
+	free(index->crc_next);
+	free(index);
+	return _7ZERR_OUT_OF_MEMORY;
+}
@@ -89,10 +89,16 @@ enum _7z_error
     TYPE DEFINITIONS
 ***************************************************************************/
 
+/* member lookup tables for a _7Z file; private to un7z.c */
+struct _7z_index;
+
+
 /* describes an open _7Z file */
 struct  _7z_file
 {
 	const char *    filename;               /* copy of _7Z filename (for caching) */
+	UINT32          filename_hash;          /* hash of the filename (for caching) */
+	_7z_index *     index;                  /* member lookup tables, built on first search */
 
 	int curr_file_idx;                      /* current file index */
 	UINT64 uncompressed_length;             /* current file uncompressed length */
@@ -114,6 +120,17 @@ struct  _7z_file
 
 
 
+/* activity of the _7Z file cache */
+struct _7z_cache_stats
+{
+	UINT32          hits;                   /* opens satisfied from the cache */
+	UINT32          misses;                 /* opens that had to read the headers */
+	UINT32          evictions;              /* files dropped to make room in the cache */
+	UINT32          searches;               /* indexed searches for contained files */
+};
+
+
+
 /***************************************************************************
     FUNCTION PROTOTYPES
 ***************************************************************************/
@@ -130,6 +147,9 @@ void _7z_file_close(_7z_file *_7z);
 /* clear out all open _7Z files from the cache */
 void _7z_file_cache_clear(void);
 
+/* return statistics on the _7Z file cache */
+void _7z_file_cache_stats(_7z_cache_stats *stats);
+
 
 /* ----- contained file access ----- */
 
@@ -9,6 +9,8 @@
 ***************************************************************************/
 
 #include "osdcore.h"
+#include "eminline.h"
+#include "corestr.h"
 #include "unzip.h"
 
 #include <ctype.h>
@@ -22,7 +24,10 @@
 ***************************************************************************/
 
 /* number of open files to cache */
-#define ZIP_CACHE_SIZE  8
+#define ZIP_CACHE_SIZE  64
+
+/* end of a chain in the member index */
+#define ZIP_INDEX_END   0xffffffff
 
 /* offsets in end of central directory structure */
 #define ZIPESIG         0x00
@@ -94,6 +99,32 @@
 
 
 
+/***************************************************************************
+    TYPE DEFINITIONS
+***************************************************************************/
+
+/* one contained file in the member index */
+struct zip_index_entry
+{
+	UINT32          cd_pos;                 /* position of the header in the central directory */
+	UINT32          crc;                    /* crc-32 */
+	UINT32          name_next;              /* next entry with the same name hash */
+	UINT32          crc_next;               /* next entry with the same crc hash */
+	bool            is_path;                /* true if this is a directory entry */
+};
+
+
+/* hash tables for finding contained files by name or crc */
+struct zip_index
+{
+	UINT32          buckets;                /* number of buckets (a power of 2) */
+	UINT32 *        name_head;              /* first entry in each name bucket */
+	UINT32 *        crc_head;               /* first entry in each crc bucket */
+	zip_index_entry *entry;                 /* one entry per contained file */
+};
+
+
+
 /***************************************************************************
     INLINE FUNCTIONS
 ***************************************************************************/
@@ -128,6 +159,44 @@ INLINE UINT32 read_dword(UINT8 *buf)
 	return (buf[3] << 24) | (buf[2] << 16) | (buf[1] << 8) | buf[0];
 }
 
+/**
+ * @fn  INLINE UINT32 hash_name(const char *name, int length)
+ *
+ * @brief   Hashes a name case-insensitively.
+ *
+ * @param   name    The name.
+ * @param   length  The length of the name.
+ *
+ * @return  The hash.
+ */
+
+INLINE UINT32 hash_name(const char *name, int length)
+{
+	UINT32 hash = 2166136261U;
+	while (length-- > 0)
+		hash = (hash ^ tolower((UINT8)*name++)) * 16777619U;
+	return hash;
+}
+
+/**
+ * @fn  INLINE const char *final_component(const char *name, int length)
+ *
+ * @brief   Finds the part of a ZIP path after the last separator.
+ *
+ * @param   name    The path.
+ * @param   length  The length of the path.
+ *
+ * @return  A pointer to the start of the final component.
+ */
+
+INLINE const char *final_component(const char *name, int length)
+{
+	const char *end = name + length;
+	while (end > name && end[-1] != '/')
+		end--;
+	return end;
+}
+
 
 
 /***************************************************************************
@@ -137,6 +206,13 @@ INLINE UINT32 read_dword(UINT8 *buf)
 /** @brief  The zip cache[ zip cache size]. */
 static zip_file *zip_cache[ZIP_CACHE_SIZE];
 
+/** @brief  Lock protecting the zip cache, so archives can be closed from worker threads. */
+static osd_lock *zip_cache_lock;
+
+/** @brief  Statistics on the zip cache; all but searches are protected by the cache lock. */
+static zip_cache_stats zip_stats;
+static INT32 volatile zip_searches;
+
 
 
 /***************************************************************************
@@ -145,9 +221,12 @@ static zip_file *zip_cache[ZIP_CACHE_SIZE];
 
 /* cache management */
 static void free_zip_file(zip_file *zip);
+static void zip_cache_acquire(void);
 
 /* ZIP file parsing */
 static zip_error read_ecd(zip_file *zip);
+static zip_error build_index(zip_file *zip);
+static bool filename_match(const zip_file_header *header, const char *filename, int length);
 static zip_error get_compressed_data_offset(zip_file *zip, UINT64 *offset);
 
 /* decompression interfaces */
@@ -183,23 +262,30 @@ zip_error zip_file_open(const char *filename, zip_file **zip)
 	zip_file *newzip;
 	char *string;
 	int cachenum;
+	UINT32 hash = hash_name(filename, strlen(filename));
 
 	/* ensure we start with a NULL result */
 	*zip = NULL;
 
 	/* see if we are in the cache, and reopen if so */
+	zip_cache_acquire();
 	for (cachenum = 0; cachenum < ARRAY_LENGTH(zip_cache); cachenum++)
 	{
 		zip_file *cached = zip_cache[cachenum];
 
 		/* if we have a valid entry and it matches our filename, use it and remove from the cache */
-		if (cached != NULL && cached->filename != NULL && strcmp(filename, cached->filename) == 0)
+		if (cached != NULL && cached->filename_hash == hash && cached->filename != NULL && strcmp(filename, cached->filename) == 0)
 		{
 			*zip = cached;
-			zip_cache[cachenum] = NULL;
+			memmove(&zip_cache[cachenum], &zip_cache[cachenum + 1], (ARRAY_LENGTH(zip_cache) - cachenum - 1) * sizeof(zip_cache[0]));
+			zip_cache[ARRAY_LENGTH(zip_cache) - 1] = NULL;
+			zip_stats.hits++;
+			osd_lock_release(zip_cache_lock);
 			return ZIPERR_NONE;
 		}
 	}
+	zip_stats.misses++;
+	osd_lock_release(zip_cache_lock);
 
 	/* allocate memory for the zip_file structure */
 	newzip = (zip_file *)malloc(sizeof(*newzip));
@@ -252,6 +338,7 @@ zip_error zip_file_open(const char *filename, zip_file **zip)
 	}
 	strcpy(string, filename);
 	newzip->filename = string;
+	newzip->filename_hash = hash;
 	*zip = newzip;
 	return ZIPERR_NONE;
 
@@ -284,18 +371,23 @@ void zip_file_close(zip_file *zip)
 	zip->file = NULL;
 
 	/* find the first NULL entry in the cache */
+	zip_cache_acquire();
 	for (cachenum = 0; cachenum < ARRAY_LENGTH(zip_cache); cachenum++)
 		if (zip_cache[cachenum] == NULL)
 			break;
 
 	/* if no room left in the cache, free the bottommost entry */
 	if (cachenum == ARRAY_LENGTH(zip_cache))
+	{
 		free_zip_file(zip_cache[--cachenum]);
+		zip_stats.evictions++;
+	}
 
 	/* move everyone else down and place us at the top */
 	if (cachenum != 0)
 		memmove(&zip_cache[1], &zip_cache[0], cachenum * sizeof(zip_cache[0]));
 	zip_cache[0] = zip;
+	osd_lock_release(zip_cache_lock);
 }
 
 
@@ -315,12 +407,36 @@ void zip_file_cache_clear(void)
 	int cachenum;
 
 	/* clear call cache entries */
+	zip_cache_acquire();
 	for (cachenum = 0; cachenum < ARRAY_LENGTH(zip_cache); cachenum++)
 		if (zip_cache[cachenum] != NULL)
 		{
 			free_zip_file(zip_cache[cachenum]);
 			zip_cache[cachenum] = NULL;
 		}
+	osd_lock_release(zip_cache_lock);
+}
+
+
+/*-------------------------------------------------
+    zip_file_cache_stats - return statistics on
+    the ZIP file cache
+-------------------------------------------------*/
+
+/**
+ * @fn  void zip_file_cache_stats(zip_cache_stats *stats)
+ *
+ * @brief   Zip file cache statistics.
+ *
+ * @param [out] stats   The statistics.
+ */
+
+void zip_file_cache_stats(zip_cache_stats *stats)
+{
+	zip_cache_acquire();
+	*stats = zip_stats;
+	stats->searches = zip_searches;
+	osd_lock_release(zip_cache_lock);
 }
 
 
@@ -419,6 +535,68 @@ const zip_file_header *zip_file_next_file(zip_file *zip)
 }
 
 
+/*-------------------------------------------------
+    zip_file_search - find a file by crc, by
+    name (ignoring any directory in the ZIP) or
+    by both, and make it the current file
+-------------------------------------------------*/
+
+/**
+ * @fn  const zip_file_header *zip_file_search(zip_file *zip, UINT32 search_crc, const char *search_filename, bool matchcrc, bool matchname)
+ *
+ * @brief   Zip file search.
+ *
+ * @param [in,out]  zip         If non-null, the zip.
+ * @param   search_crc          The crc to search for.
+ * @param   search_filename     The filename to search for.
+ * @param   matchcrc            true to require a crc match.
+ * @param   matchname           true to require a filename match.
+ *
+ * @return  null if no file matches, else the first matching zip_file_header*.
+ */
+
+const zip_file_header *zip_file_search(zip_file *zip, UINT32 search_crc, const char *search_filename, bool matchcrc, bool matchname)
+{
+	/* index the central directory on first use */
+	if (zip->index == NULL && build_index(zip) != ZIPERR_NONE)
+		return NULL;
+	atomic_increment32(&zip_searches);
+
+	zip_index *index = zip->index;
+	const zip_file_header *header;
+	UINT32 entrynum;
+
+	/* names are hashed on their final component; walk that chain and check the rest */
+	if (matchname)
+	{
+		int length = strlen(search_filename);
+		const char *name = final_component(search_filename, length);
+		UINT32 bucket = hash_name(name, search_filename + length - name) & (index->buckets - 1);
+		for (entrynum = index->name_head[bucket]; entrynum != ZIP_INDEX_END; entrynum = index->entry[entrynum].name_next)
+			if (!matchcrc || index->entry[entrynum].crc == search_crc)
+			{
+				zip->cd_pos = index->entry[entrynum].cd_pos;
+				header = zip_file_next_file(zip);
+				if (header != NULL && filename_match(header, search_filename, length))
+					return header;
+			}
+	}
+
+	/* crc-only matches skip directory entries */
+	else if (matchcrc)
+	{
+		UINT32 bucket = search_crc & (index->buckets - 1);
+		for (entrynum = index->crc_head[bucket]; entrynum != ZIP_INDEX_END; entrynum = index->entry[entrynum].crc_next)
+			if (index->entry[entrynum].crc == search_crc && !index->entry[entrynum].is_path)
+			{
+				zip->cd_pos = index->entry[entrynum].cd_pos;
+				return zip_file_next_file(zip);
+			}
+	}
+	return NULL;
+}
+
+
 /*-------------------------------------------------
     zip_file_decompress - decompress a file
     from a ZIP into the target buffer
@@ -474,6 +652,38 @@ zip_error zip_file_decompress(zip_file *zip, void *buffer, UINT32 length)
 
 
 
+/*-------------------------------------------------
+    zip_file_stored_offset - return the offset
+    within the ZIP of the most recently found
+    file's data, if it is stored uncompressed
+-------------------------------------------------*/
+
+/**
+ * @fn  zip_error zip_file_stored_offset(zip_file *zip, UINT64 *offset)
+ *
+ * @brief   Zip file stored offset.
+ *
+ * @param [in,out]  zip     If non-null, the zip.
+ * @param [in,out]  offset  If non-null, the offset.
+ *
+ * @return  A zip_error; ZIPERR_UNSUPPORTED if the file is compressed.
+ */
+
+zip_error zip_file_stored_offset(zip_file *zip, UINT64 *offset)
+{
+	/* only stored data can be used in place */
+	if (zip->header.compression != 0 || zip->header.compressed_length != zip->header.uncompressed_length)
+		return ZIPERR_UNSUPPORTED;
+
+	/* make sure the info in the header aligns with what we know */
+	if (zip->header.start_disk_number != zip->ecd.disk_number)
+		return ZIPERR_UNSUPPORTED;
+
+	return get_compressed_data_offset(zip, offset);
+}
+
+
+
 /***************************************************************************
     CACHE MANAGEMENT
 ***************************************************************************/
@@ -503,11 +713,42 @@ static void free_zip_file(zip_file *zip)
 			free(zip->ecd.raw);
 		if (zip->cd != NULL)
 			free(zip->cd);
+		if (zip->index != NULL)
+		{
+			free(zip->index->name_head);
+			free(zip->index->crc_head);
+			free(zip->index->entry);
+			free(zip->index);
+		}
 		free(zip);
 	}
 }
 
 
+/*-------------------------------------------------
+    zip_cache_acquire - acquire the cache lock,
+    allocating it on first use
+-------------------------------------------------*/
+
+/**
+ * @fn  static void zip_cache_acquire(void)
+ *
+ * @brief   Acquires the zip cache lock.
+ */
+
+static void zip_cache_acquire(void)
+{
+	/* allocate the lock on first use; if two threads race, the loser frees its copy */
+	if (zip_cache_lock == NULL)
+	{
+		osd_lock *lock = osd_lock_alloc();
+		if (compare_exchange_ptr((void * volatile *)&zip_cache_lock, NULL, lock) != NULL)
+			osd_lock_free(lock);
+	}
+	osd_lock_acquire(zip_cache_lock);
+}
+
+
 
 /***************************************************************************
     ZIP FILE PARSING
@@ -596,6 +837,112 @@ static zip_error read_ecd(zip_file *zip)
 }
 
 
+/*-------------------------------------------------
+    build_index - build the tables used to find
+    contained files by name and crc
+-------------------------------------------------*/
+
+/**
+ * @fn  static zip_error build_index(zip_file *zip)
+ *
+ * @brief   Builds the member index.
+ *
+ * @param [in,out]  zip If non-null, the zip.
+ *
+ * @return  A zip_error.
+ */
+
+static zip_error build_index(zip_file *zip)
+{
+	const zip_file_header *header;
+	UINT32 entries = 0;
+	UINT32 entrynum;
+
+	/* count the entries and size the tables to keep chains short */
+	for (header = zip_file_first_file(zip); header != NULL; header = zip_file_next_file(zip))
+		entries++;
+	UINT32 buckets = 16;
+	while (buckets < entries)
+		buckets *= 2;
+
+	/* allocate the tables */
+	zip_index *index = (zip_index *)malloc(sizeof(*index));
+	UINT32 *namehash = (UINT32 *)malloc(MAX(entries, 1) * sizeof(namehash[0]));
+	if (index == NULL || namehash == NULL)
+	{
+		free(index);
+		free(namehash);
+		return ZIPERR_OUT_OF_MEMORY;
+	}
+	index->buckets = buckets;
+	index->name_head = (UINT32 *)malloc(buckets * sizeof(index->name_head[0]));
+	index->crc_head = (UINT32 *)malloc(buckets * sizeof(index->crc_head[0]));
+	index->entry = (zip_index_entry *)malloc(MAX(entries, 1) * sizeof(index->entry[0]));
+	if (index->name_head == NULL || index->crc_head == NULL || index->entry == NULL)
+	{
+		free(index->name_head);
+		free(index->crc_head);
+		free(index->entry);
+		free(index);
+		free(namehash);
+		return ZIPERR_OUT_OF_MEMORY;
+	}
+	memset(index->name_head, 0xff, buckets * sizeof(index->name_head[0]));
+	memset(index->crc_head, 0xff, buckets * sizeof(index->crc_head[0]));
+
+	/* record where each entry lives, then link them in reverse so chains run in directory order */
+	entrynum = 0;
+	for (zip->cd_pos = 0; entrynum < entries; entrynum++)
+	{
+		UINT32 cd_pos = zip->cd_pos;
+		header = zip_file_next_file(zip);
+		const char *name = final_component(header->filename, header->filename_length);
+		index->entry[entrynum].cd_pos = cd_pos;
+		index->entry[entrynum].crc = header->crc;
+		index->entry[entrynum].is_path = (header->filename_length > 0 && header->filename[header->filename_length - 1] == '/');
+		namehash[entrynum] = hash_name(name, header->filename + header->filename_length - name);
+	}
+	while (entrynum-- > 0)
+	{
+		UINT32 namebucket = namehash[entrynum] & (buckets - 1);
+		UINT32 crcbucket = index->entry[entrynum].crc & (buckets - 1);
+		index->entry[entrynum].name_next = index->name_head[namebucket];
+		index->name_head[namebucket] = entrynum;
+		index->entry[entrynum].crc_next = index->crc_head[crcbucket];
+		index->crc_head[crcbucket] = entrynum;
+	}
+	free(namehash);
+
+	zip->index = index;
+	return ZIPERR_NONE;
+}
+
+
+/*-------------------------------------------------
+    filename_match - compare a contained file's
+    name to an expected filename, ignoring any
+    directory in the ZIP
+-------------------------------------------------*/
+
+/**
+ * @fn  static bool filename_match(const zip_file_header *header, const char *filename, int length)
+ *
+ * @brief   Compares a contained file's name to a filename.
+ *
+ * @param   header      The header.
+ * @param   filename    The expected filename.
+ * @param   length      The length of the expected filename.
+ *
+ * @return  true if the names match.
+ */
+
+static bool filename_match(const zip_file_header *header, const char *filename, int length)
+{
+	const char *zipfile = header->filename + header->filename_length - length;
+	return (zipfile >= header->filename && core_stricmp(filename, zipfile) == 0 && (zipfile == header->filename || zipfile[-1] == '/'));
+}
+
+
 /*-------------------------------------------------
     get_compressed_data_offset - return the
     offset of the compressed data
@@ -88,10 +88,15 @@ struct zip_ecd
 };
 
 
+/* member lookup tables for a ZIP file; private to unzip.c */
+struct zip_index;
+
+
 /* describes an open ZIP file */
 struct zip_file
 {
 	const char *    filename;               /* copy of ZIP filename (for caching) */
+	UINT32          filename_hash;          /* hash of the filename (for caching) */
 	osd_file *      file;                   /* OSD file handle */
 	UINT64          length;                 /* length of zip file */
 
@@ -100,12 +105,24 @@ struct zip_file
 	UINT8 *         cd;                     /* central directory raw data */
 	UINT32          cd_pos;                 /* position in central directory */
 	zip_file_header header;                 /* current file header */
+	zip_index *     index;                  /* member lookup tables, built on first search */
 
 	UINT8           buffer[ZIP_DECOMPRESS_BUFSIZE]; /* buffer for decompression */
 };
 
 
 
+/* activity of the ZIP file cache */
+struct zip_cache_stats
+{
+	UINT32          hits;                   /* opens satisfied from the cache */
+	UINT32          misses;                 /* opens that had to read the central directory */
+	UINT32          evictions;              /* files dropped to make room in the cache */
+	UINT32          searches;               /* indexed searches for contained files */
+};
+
+
+
 /***************************************************************************
     FUNCTION PROTOTYPES
 ***************************************************************************/
@@ -122,6 +139,9 @@ void zip_file_close(zip_file *zip);
 /* clear out all open ZIP files from the cache */
 void zip_file_cache_clear(void);
 
+/* return statistics on the ZIP file cache */
+void zip_file_cache_stats(zip_cache_stats *stats);
+
 
 /* ----- contained file access ----- */
 
@@ -131,8 +151,14 @@ const zip_file_header *zip_file_first_file(zip_file *zip);
 /* find the next file in the ZIP */
 const zip_file_header *zip_file_next_file(zip_file *zip);
 
+/* find a file by crc, filename or both, ignoring any directory in the ZIP */
+const zip_file_header *zip_file_search(zip_file *zip, UINT32 search_crc, const char *search_filename, bool matchcrc, bool matchname);
+
 /* decompress the most recently found file in the ZIP */
 zip_error zip_file_decompress(zip_file *zip, void *buffer, UINT32 length);
 
+/* return the offset of the most recently found file's data if it is stored uncompressed */
+zip_error zip_file_stored_offset(zip_file *zip, UINT64 *offset);
+
 
 #endif  /* __UNZIP_H__ */
@@ -2301,7 +2301,8 @@ void n64_rdp::cmd_sync_tile(UINT32 w1, UINT32 w2)
 
 void n64_rdp::cmd_sync_full(UINT32 w1, UINT32 w2)
 {
-	//wait("SyncFull");
+	// spans are binned until the next wait, so render them before the CPU is told the frame is done
+	wait("SyncFull");
 	dp_full_sync(*m_machine);
 }
 
@@ -2901,7 +2902,9 @@ void n64_rdp::cmd_set_mask_image(UINT32 w1, UINT32 w2)
 
 void n64_rdp::cmd_set_color_image(UINT32 w1, UINT32 w2)
 {
-	//wait("SetColorImage");
+	// a new target may be loaded as a texture from the old one, so finish drawing into it first
+	if ((w2 & 0x01ffffff) != m_misc_state.m_fb_address)
+		wait("SetColorImage");
 
 	m_misc_state.m_fb_format  = (w1 >> 21) & 0x7;
 	m_misc_state.m_fb_size    = (w1 >> 19) & 0x3;
@@ -3039,7 +3042,7 @@ void n64_rdp::process_command_list()
 
 /*****************************************************************************/
 
-n64_rdp::n64_rdp(n64_state &state) : poly_manager<UINT32, rdp_poly_state, 8, 32000>(state.machine())
+n64_rdp::n64_rdp(n64_state &state) : poly_manager<UINT32, rdp_poly_state, 8, 32000>(state.machine(), POLYFLAG_BINNED)
 {
 	m_aux_buf_ptr = 0;
 	m_aux_buf = NULL;
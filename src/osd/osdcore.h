@@ -183,6 +183,45 @@ file_error osd_write(osd_file *file, const void *buffer, UINT64 offset, UINT32 l
 file_error osd_truncate(osd_file *file, UINT64 offset);
 
 
+/*-----------------------------------------------------------------------------
+    osd_map: map the contents of an open file into memory for reading
+
+    Parameters:
+
+        file - handle to a file previously opened via osd_open
+
+        length - number of bytes to map, starting at the beginning of the file
+
+        base - pointer to a pointer to receive the address of the mapped data
+
+    Return value:
+
+        a file_error describing any error that occurred while mapping the
+        file, or FILERR_NONE if no error occurred; callers must fall back
+        to osd_read if the file cannot be mapped
+
+    Notes:
+
+        The mapping is read-only and remains valid after the file is
+        closed, until it is released with osd_unmap. The contents of the
+        mapping are undefined if the file is modified or truncated while
+        it is mapped.
+-----------------------------------------------------------------------------*/
+file_error osd_map(osd_file *file, UINT64 length, const void **base);
+
+
+/*-----------------------------------------------------------------------------
+    osd_unmap: release a mapping created by osd_map
+
+    Parameters:
+
+        base - the address returned by osd_map
+
+        length - the length that was passed to osd_map
+-----------------------------------------------------------------------------*/
+void osd_unmap(const void *base, UINT64 length);
+
+
 /*-----------------------------------------------------------------------------
     osd_rmfile: deletes a file
 
@@ -286,6 +325,7 @@ struct osd_directory_entry
 	const char *        name;           /* name of the entry */
 	osd_dir_entry_type  type;           /* type of the entry */
 	UINT64              size;           /* size of the entry */
+	UINT64              last_modified;  /* last modification time, in OS-dependent units; 0 if unknown */
 };
 
 
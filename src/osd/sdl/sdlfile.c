@@ -33,6 +33,9 @@
 #endif
 
 #include <sys/stat.h>
+#if !defined(SDLMAME_OS2) && !defined(SDLMAME_EMSCRIPTEN)
+#include <sys/mman.h>
+#endif
 #include <fcntl.h>
 #include <unistd.h>
 #include <stdio.h>
@@ -385,6 +388,42 @@ file_error osd_truncate(osd_file *file, UINT64 offset)
 }
 
 
+//============================================================
+//  osd_map
+//============================================================
+
+file_error osd_map(osd_file *file, UINT64 length, const void **base)
+{
+#if defined(SDLMAME_OS2) || defined(SDLMAME_EMSCRIPTEN)
+	return FILERR_FAILURE;
+#else
+	void *result;
+
+	if (!file || file->type != SDLFILE_FILE || length == 0 || (size_t)length != length)
+		return FILERR_FAILURE;
+
+	result = mmap(NULL, length, PROT_READ, MAP_SHARED, file->handle, 0);
+	if (result == MAP_FAILED)
+		return error_to_file_error(errno);
+
+	*base = result;
+	return FILERR_NONE;
+#endif
+}
+
+
+//============================================================
+//  osd_unmap
+//============================================================
+
+void osd_unmap(const void *base, UINT64 length)
+{
+#if !defined(SDLMAME_OS2) && !defined(SDLMAME_EMSCRIPTEN)
+	munmap(const_cast<void *>(base), length);
+#endif
+}
+
+
 //============================================================
 //  osd_close
 //============================================================
@@ -530,6 +569,7 @@ osd_directory_entry *osd_stat(const char *path)
 	result->name = ((char *) result) + sizeof(*result);
 	result->type = S_ISDIR(st.st_mode) ? ENTTYPE_DIR : ENTTYPE_FILE;
 	result->size = (UINT64)st.st_size;
+	result->last_modified = (UINT64)st.st_mtime;
 
 	return result;
 }
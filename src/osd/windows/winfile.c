@@ -273,6 +273,44 @@ file_error osd_truncate(osd_file *file, UINT64 offset)
 }
 
 
+//============================================================
+//  osd_map
+//============================================================
+
+file_error osd_map(osd_file *file, UINT64 length, const void **base)
+{
+	HANDLE mapping;
+	void *result;
+
+	if (file->type != WINFILE_FILE || length == 0 || (SIZE_T)length != length)
+		return FILERR_FAILURE;
+
+	// create a read-only mapping of the whole file and a view of the requested length
+	mapping = CreateFileMapping(file->handle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping == NULL)
+		return win_error_to_mame_file_error(GetLastError());
+	result = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, (SIZE_T)length);
+
+	// the view keeps the mapping alive, so we can close our handle now
+	CloseHandle(mapping);
+	if (result == NULL)
+		return win_error_to_mame_file_error(GetLastError());
+
+	*base = result;
+	return FILERR_NONE;
+}
+
+
+//============================================================
+//  osd_unmap
+//============================================================
+
+void osd_unmap(const void *base, UINT64 length)
+{
+	UnmapViewOfFile(base);
+}
+
+
 //============================================================
 //  osd_close
 //============================================================
@@ -481,6 +519,7 @@ osd_directory_entry *osd_stat(const char *path)
 	result->name = ((char *) result) + sizeof(*result);
 	result->type = win_attributes_to_entry_type(find_data.dwFileAttributes);
 	result->size = find_data.nFileSizeLow | ((UINT64) find_data.nFileSizeHigh << 32);
+	result->last_modified = find_data.ftLastWriteTime.dwLowDateTime | ((UINT64) find_data.ftLastWriteTime.dwHighDateTime << 32);
 
 done:
 	if (t_path != NULL)
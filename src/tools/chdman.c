@@ -37,6 +37,9 @@ const UINT32 IDE_SECTOR_SIZE = 512;
 // temporary input buffer size
 const UINT32 TEMP_BUFFER_SIZE = 32 * 1024 * 1024;
 
+// hunks to decompress ahead when extracting CDs
+const UINT32 CD_READAHEAD_HUNKS = 64;
+
 // modes
 const int MODE_NORMAL = 0;
 const int MODE_CUEBIN = 1;
@@ -61,6 +64,7 @@ const int MODE_GDI = 2;
 #define COMMAND_ADD_METADATA "addmeta"
 #define COMMAND_DEL_METADATA "delmeta"
 #define COMMAND_DUMP_METADATA "dumpmeta"
+#define COMMAND_BENCHMARK "benchmark"
 
 // option strings
 #define OPTION_INPUT "input"
@@ -112,6 +116,7 @@ static void do_extract_ld(parameters_t &params);
 static void do_add_metadata(parameters_t &params);
 static void do_del_metadata(parameters_t &params);
 static void do_dump_metadata(parameters_t &params);
+static void do_benchmark(parameters_t &params);
 
 
 
@@ -531,7 +536,7 @@ static const option_description s_options[] =
 	{ OPTION_INDEX,                 "ix",   true, " <index>: indexed instance of this metadata tag" },
 	{ OPTION_VALUE_TEXT,            "vt",   true, " <text>: text for the metadata" },
 	{ OPTION_VALUE_FILE,            "vf",   true, " <file>: file containing data to add" },
-	{ OPTION_NUMPROCESSORS,         "np",   true, " <processors>: limit the number of processors to use during compression" },
+	{ OPTION_NUMPROCESSORS,         "np",   true, " <processors>: limit the number of processors to use during compression or decompression" },
 	{ OPTION_NO_CHECKSUM,           "nocs", false, ": do not include this metadata information in the overall SHA-1" },
 	{ OPTION_FIX,                   "f",    false, ": fix the SHA-1 if it is incorrect" },
 	{ OPTION_VERBOSE,               "v",    false, ": output additional information" },
@@ -552,7 +557,8 @@ static const command_description s_commands[] =
 	{ COMMAND_VERIFY, do_verify, ": verifies a CHD's integrity",
 		{
 			REQUIRED OPTION_INPUT,
-			OPTION_INPUT_PARENT
+			OPTION_INPUT_PARENT,
+			OPTION_NUMPROCESSORS
 		}
 	},
 
@@ -628,7 +634,8 @@ static const command_description s_commands[] =
 			OPTION_INPUT_START_BYTE,
 			OPTION_INPUT_START_HUNK,
 			OPTION_INPUT_LENGTH_BYTES,
-			OPTION_INPUT_LENGTH_HUNKS
+			OPTION_INPUT_LENGTH_HUNKS,
+			OPTION_NUMPROCESSORS
 		}
 	},
 
@@ -641,7 +648,8 @@ static const command_description s_commands[] =
 			OPTION_INPUT_START_BYTE,
 			OPTION_INPUT_START_HUNK,
 			OPTION_INPUT_LENGTH_BYTES,
-			OPTION_INPUT_LENGTH_HUNKS
+			OPTION_INPUT_LENGTH_HUNKS,
+			OPTION_NUMPROCESSORS
 		}
 	},
 
@@ -710,6 +718,17 @@ static const command_description s_commands[] =
 			REQUIRED OPTION_TAG,
 			OPTION_INDEX
 		}
+	},
+
+	{ COMMAND_BENCHMARK, do_benchmark, ": measure ratio and throughput of each codec on a CHD or raw input file",
+		{
+			REQUIRED OPTION_INPUT,
+			OPTION_INPUT_PARENT,
+			OPTION_INPUT_START_BYTE,
+			OPTION_INPUT_LENGTH_BYTES,
+			OPTION_HUNK_SIZE,
+			OPTION_COMPRESSION
+		}
 	}
 };
 
@@ -760,6 +779,18 @@ static void ATTR_PRINTF(2,3) progress(bool forceit, const char *format, ...)
 }
 
 
+//-------------------------------------------------
+//  megabytes_per_second - compute the throughput
+//  of an operation that started at the given time
+//-------------------------------------------------
+
+static double megabytes_per_second(UINT64 bytes, osd_ticks_t start)
+{
+	double seconds = double(osd_ticks() - start) / double(osd_ticks_per_second());
+	return (seconds > 0) ? double(bytes) / (1024.0 * 1024.0) / seconds : 0;
+}
+
+
 //-------------------------------------------------
 //  print_help - print help for all the commands
 //-------------------------------------------------
@@ -1499,26 +1530,26 @@ static void do_verify(parameters_t &params)
 	if (raw_sha1 == sha1_t::null)
 		report_error(0, "No verification to be done; CHD has no checksum");
 
-	// create an array to read into
-	dynamic_buffer buffer((TEMP_BUFFER_SIZE / input_chd.hunk_bytes()) * input_chd.hunk_bytes());
-
-	// read all the data and build up an SHA-1
-	sha1_creator rawsha1;
-	for (UINT64 offset = 0; offset < input_chd.logical_bytes(); )
+	// read all the data, decompressing in parallel, and build up an SHA-1
+	parse_numprocessors(params);
+	chd_verifier verifier(input_chd);
+	verifier.verify_begin();
+	osd_ticks_t start = osd_ticks();
+	for (;;)
 	{
-		progress(false, "Verifying, %.1f%% complete... \r", 100.0 * double(offset) / double(input_chd.logical_bytes()));
+		progress(false, "Verifying, %.1f%% complete... \r", 100.0 * verifier.progress());
 
-		// determine how much to read
-		UINT32 bytes_to_read = MIN((UINT32)buffer.size(), input_chd.logical_bytes() - offset);
-		chd_error err = input_chd.read_bytes(offset, &buffer[0], bytes_to_read);
+		// wait for the next hunk
+		const UINT8 *data;
+		UINT32 length;
+		chd_error err = verifier.verify_continue(data, length);
 		if (err != CHDERR_NONE)
 			report_error(1, "Error reading CHD file (%s): %s", params.find(OPTION_INPUT)->c_str(), chd_file::error_string(err));
-
-		// add to the checksum
-		rawsha1.append(&buffer[0], bytes_to_read);
-		offset += bytes_to_read;
+		if (data == NULL)
+			break;
 	}
-	sha1_t computed_sha1 = rawsha1.finish();
+	sha1_t computed_sha1 = verifier.verify_finish();
+	printf("Verification complete (%.1f MB/s)                     \n", megabytes_per_second(verifier.bytes_done(), start));
 
 	// finish up
 	if (raw_sha1 != computed_sha1)
@@ -2246,30 +2277,55 @@ static void do_extract_raw(parameters_t &params)
 		if (filerr != FILERR_NONE)
 			report_error(1, "Unable to open file (%s)", output_file_str->c_str());
 
+		// decompress the hunks covering the range in parallel
+		parse_numprocessors(params);
+		UINT32 hunkbytes = input_chd.hunk_bytes();
+		UINT32 first_hunk = input_start / hunkbytes;
+		UINT32 end_hunk = (input_end + hunkbytes - 1) / hunkbytes;
+		chd_verifier verifier(input_chd);
+		verifier.verify_begin(first_hunk, end_hunk - first_hunk, false);
+
 		// copy all data
-		dynamic_buffer buffer((TEMP_BUFFER_SIZE / input_chd.hunk_bytes()) * input_chd.hunk_bytes());
-		for (UINT64 offset = input_start; offset < input_end; )
+		dynamic_buffer buffer((TEMP_BUFFER_SIZE / hunkbytes) * hunkbytes);
+		UINT32 bufferoffs = 0;
+		UINT64 offset = UINT64(first_hunk) * hunkbytes;
+		osd_ticks_t start = osd_ticks();
+		for (;;)
 		{
-			progress(false, "Extracting, %.1f%% complete... \r", 100.0 * double(offset - input_start) / double(input_end - input_start));
+			progress(false, "Extracting, %.1f%% complete... \r", 100.0 * verifier.progress());
 
-			// determine how much to read
-			UINT32 bytes_to_read = MIN((UINT32)buffer.size(), input_end - offset);
-			chd_error err = input_chd.read_bytes(offset, &buffer[0], bytes_to_read);
+			// wait for the next hunk
+			const UINT8 *data;
+			UINT32 length;
+			chd_error err = verifier.verify_continue(data, length);
 			if (err != CHDERR_NONE)
 				report_error(1, "Error reading CHD file (%s): %s", params.find(OPTION_INPUT)->c_str(), chd_file::error_string(err));
 
-			// write to the output
-			UINT32 count = core_fwrite(output_file, &buffer[0], bytes_to_read);
-			if (count != bytes_to_read)
-				report_error(1, "Error writing to file; check disk space (%s)", output_file_str->c_str());
+			// append the part within the requested range to the buffer
+			if (data != NULL)
+			{
+				UINT32 skip = (offset < input_start) ? input_start - offset : 0;
+				UINT32 count = MIN(UINT64(length), input_end - offset) - skip;
+				memcpy(&buffer[bufferoffs], data + skip, count);
+				bufferoffs += count;
+				offset += length;
+			}
 
-			// advance
-			offset += bytes_to_read;
+			// write to the output when full or done
+			if (bufferoffs != 0 && (data == NULL || buffer.size() - bufferoffs < hunkbytes))
+			{
+				UINT32 count = core_fwrite(output_file, &buffer[0], bufferoffs);
+				if (count != bufferoffs)
+					report_error(1, "Error writing to file; check disk space (%s)", output_file_str->c_str());
+				bufferoffs = 0;
+			}
+			if (data == NULL)
+				break;
 		}
 
 		// finish up
 		core_fclose(output_file);
-		printf("Extraction complete                                    \n");
+		printf("Extraction complete (%.1f MB/s)                        \n", megabytes_per_second(input_end - input_start, start));
 	}
 	catch (...)
 	{
@@ -2366,6 +2422,10 @@ static void do_extract_cd(parameters_t &params)
 			core_fprintf(output_toc_file, "%d\n", toc->numtrks);
 		}
 
+		// decompress ahead of the extraction on another thread
+		input_chd.set_readahead(CD_READAHEAD_HUNKS);
+		osd_ticks_t start = osd_ticks();
+
 		// iterate over tracks and copy all data
 		UINT64 outputoffs = 0;
 		UINT32 discoffs = 0;
@@ -2469,7 +2529,7 @@ static void do_extract_cd(parameters_t &params)
 		// finish up
 		core_fclose(output_bin_file);
 		core_fclose(output_toc_file);
-		printf("Extraction complete                                    \n");
+		printf("Extraction complete (%.1f MB/s)                        \n", megabytes_per_second(total_bytes, start));
 	}
 	catch (...)
 	{
@@ -2834,6 +2894,214 @@ static void do_dump_metadata(parameters_t &params)
 }
 
 
+//-------------------------------------------------
+//  do_benchmark - compress and decompress an
+//  input image with each codec in turn and
+//  report the ratio and throughput of each
+//-------------------------------------------------
+
+static void do_benchmark(parameters_t &params)
+{
+	// the input can be a CHD, in which case its decompressed hunks are used, or a raw image
+	chd_file input_parent_chd;
+	chd_file input_chd;
+	core_file *input_file = NULL;
+	std::string *input_str = params.find(OPTION_INPUT);
+	std::string *input_parent_str = params.find(OPTION_INPUT_PARENT);
+	if (input_parent_str != NULL)
+	{
+		chd_error err = input_parent_chd.open(input_parent_str->c_str());
+		if (err != CHDERR_NONE)
+			report_error(1, "Error opening parent CHD file (%s): %s", input_parent_str->c_str(), chd_file::error_string(err));
+	}
+	chd_error err = input_chd.open(input_str->c_str(), false, input_parent_chd.opened() ? &input_parent_chd : NULL);
+	if (err == CHDERR_INVALID_FILE)
+	{
+		file_error filerr = core_fopen(input_str->c_str(), OPEN_FLAG_READ, &input_file);
+		if (filerr != FILERR_NONE)
+			report_error(1, "Unable to open file (%s)", input_str->c_str());
+	}
+	else if (err != CHDERR_NONE)
+		report_error(1, "Error opening CHD file (%s): %s", input_str->c_str(), chd_file::error_string(err));
+
+	// determine the hunk size and the range to test
+	UINT32 hunk_size = 4096;
+	UINT64 logical_size;
+	if (input_file != NULL)
+	{
+		parse_hunk_size(params, 1, hunk_size);
+		logical_size = core_fsize(input_file);
+	}
+	else
+	{
+		hunk_size = input_chd.hunk_bytes();
+		logical_size = input_chd.logical_bytes();
+	}
+	UINT64 input_start;
+	UINT64 input_end;
+	parse_input_start_end(params, logical_size, hunk_size, hunk_size, input_start, input_end);
+	UINT32 first_hunk = input_start / hunk_size;
+	UINT32 end_hunk = (input_end + hunk_size - 1) / hunk_size;
+
+	// determine the codecs to measure; by default, every codec we know about
+	chd_codec_type compression[4] = { CHD_CODEC_NONE, CHD_CODEC_NONE, CHD_CODEC_NONE, CHD_CODEC_NONE };
+	parse_compression(params, compression);
+	std::vector<chd_codec_type> codecs;
+	for (int index = 0; index < 4 && compression[index] != CHD_CODEC_NONE; index++)
+		codecs.push_back(compression[index]);
+	if (codecs.empty())
+		for (int index = 0; chd_codec_list::codec_by_index(index) != CHD_CODEC_NONE; index++)
+			codecs.push_back(chd_codec_list::codec_by_index(index));
+
+	// create the codecs up front; some of them only work with particular hunk sizes
+	std::vector<chd_compressor *> compressors(codecs.size(), (chd_compressor *)NULL);
+	std::vector<chd_decompressor *> decompressors(codecs.size(), (chd_decompressor *)NULL);
+	for (int codecnum = 0; codecnum < codecs.size(); codecnum++)
+	{
+		try
+		{
+			compressors[codecnum] = chd_codec_list::new_compressor(codecs[codecnum], input_chd, hunk_size);
+			decompressors[codecnum] = chd_codec_list::new_decompressor(codecs[codecnum], input_chd, hunk_size);
+		}
+		catch (chd_error &)
+		{
+			delete compressors[codecnum];
+			compressors[codecnum] = NULL;
+		}
+	}
+
+	// per-codec totals
+	std::vector<UINT64> compressed_bytes(codecs.size(), 0);
+	std::vector<UINT32> compressed_hunks(codecs.size(), 0);
+	std::vector<osd_ticks_t> compress_ticks(codecs.size(), 0);
+	std::vector<osd_ticks_t> decompress_ticks(codecs.size(), 0);
+	std::vector<bool> mismatch(codecs.size(), false);
+
+	// read the input in batches so that I/O stays out of the timings
+	const UINT32 batch_hunks = MAX(1, (32 * 1024 * 1024) / hunk_size);
+	dynamic_buffer source(batch_hunks * hunk_size);
+	dynamic_buffer compressed(hunk_size);
+	dynamic_buffer decompressed(hunk_size);
+	try
+	{
+		for (UINT32 batchstart = first_hunk; batchstart < end_hunk; batchstart += batch_hunks)
+		{
+			UINT32 batchcount = MIN(batch_hunks, end_hunk - batchstart);
+			progress(false, "Benchmarking, %.1f%% complete... \r", 100.0 * double(batchstart - first_hunk) / double(end_hunk - first_hunk));
+
+			// fetch the batch, padding the final hunk of a raw file with zeros like the compressor does
+			if (input_file != NULL)
+			{
+				memset(&source[0], 0, batchcount * hunk_size);
+				core_fseek(input_file, UINT64(batchstart) * hunk_size, SEEK_SET);
+				core_fread(input_file, &source[0], batchcount * hunk_size);
+			}
+			else
+				for (UINT32 hunknum = 0; hunknum < batchcount; hunknum++)
+				{
+					err = input_chd.read_hunk(batchstart + hunknum, &source[hunknum * hunk_size]);
+					if (err != CHDERR_NONE)
+						report_error(1, "Error reading CHD file (%s): %s", input_str->c_str(), chd_file::error_string(err));
+				}
+
+			// run each codec over the whole batch; hunks a codec can't shrink are stored as-is
+			for (int codecnum = 0; codecnum < codecs.size(); codecnum++)
+				if (compressors[codecnum] != NULL)
+					for (UINT32 hunknum = 0; hunknum < batchcount; hunknum++)
+					{
+						const UINT8 *src = &source[hunknum * hunk_size];
+						UINT32 complen = hunk_size;
+						osd_ticks_t start = osd_ticks();
+						try
+						{
+							complen = compressors[codecnum]->compress(src, hunk_size, &compressed[0]);
+						}
+						catch (chd_error &)
+						{
+						}
+						compress_ticks[codecnum] += osd_ticks() - start;
+						compressed_bytes[codecnum] += complen;
+						if (complen == hunk_size)
+							continue;
+						compressed_hunks[codecnum]++;
+
+						start = osd_ticks();
+						try
+						{
+							decompressors[codecnum]->decompress(&compressed[0], complen, &decompressed[0], hunk_size);
+						}
+						catch (chd_error &)
+						{
+							mismatch[codecnum] = true;
+						}
+						decompress_ticks[codecnum] += osd_ticks() - start;
+						if (!compressors[codecnum]->lossy() && memcmp(src, &decompressed[0], hunk_size) != 0)
+							mismatch[codecnum] = true;
+					}
+		}
+
+		// report the results
+		std::string tempstr;
+		double tps = double(osd_ticks_per_second());
+		double total = double(end_hunk - first_hunk) * hunk_size;
+		printf("Benchmark complete                                  \n");
+		printf("Input:        %s\n", input_str->c_str());
+		printf("Hunk size:    %10s\n", big_int_string(tempstr, hunk_size));
+		printf("Hunks tested: %10s\n", big_int_string(tempstr, end_hunk - first_hunk));
+		printf("\n");
+		printf("Codec                    Ratio  Shrunk   Compress  Decompress\n");
+		printf("----------------------  ------  ------  ---------  ----------\n");
+		for (int codecnum = 0; codecnum < codecs.size(); codecnum++)
+		{
+			chd_codec_type type = codecs[codecnum];
+			std::string name;
+			name.push_back((type >> 24) & 0xff);
+			name.push_back((type >> 16) & 0xff);
+			name.push_back((type >> 8) & 0xff);
+			name.push_back(type & 0xff);
+			name.append(" (").append(chd_codec_list::codec_name(type)).append(")");
+			if (compressors[codecnum] == NULL)
+			{
+				printf("%-22s  not applicable to this input\n", name.c_str());
+				continue;
+			}
+			if (compressed_hunks[codecnum] == 0)
+			{
+				printf("%-22s  no compressed hunks to benchmark\n", name.c_str());
+				continue;
+			}
+
+			// compress throughput covers every hunk; decompress only those that compressed
+			double compressed_total = double(compressed_hunks[codecnum]) * hunk_size;
+			double compress_rate = (compress_ticks[codecnum] != 0) ? total / (compress_ticks[codecnum] / tps) / (1024.0 * 1024.0) : 0;
+			double decompress_rate = (decompress_ticks[codecnum] != 0) ? compressed_total / (decompress_ticks[codecnum] / tps) / (1024.0 * 1024.0) : 0;
+			printf("%-22s  %5.1f%%  %5.0f%%  %4.1f MB/s %6.1f MB/s%s\n", name.c_str(), 100.0 * double(compressed_bytes[codecnum]) / total,
+					100.0 * compressed_total / total, compress_rate, decompress_rate, mismatch[codecnum] ? "  MISMATCH" : "");
+		}
+	}
+	catch (...)
+	{
+		for (int codecnum = 0; codecnum < codecs.size(); codecnum++)
+		{
+			delete compressors[codecnum];
+			delete decompressors[codecnum];
+		}
+		if (input_file != NULL)
+			core_fclose(input_file);
+		throw;
+	}
+
+	// clean up
+	for (int codecnum = 0; codecnum < codecs.size(); codecnum++)
+	{
+		delete compressors[codecnum];
+		delete decompressors[codecnum];
+	}
+	if (input_file != NULL)
+		core_fclose(input_file);
+}
+
+
 //-------------------------------------------------
 //  main - entry point
 //-------------------------------------------------
@@ -0,0 +1,230 @@
+// license:BSD-3-Clause
+// copyright-holders:MAMEdev Team
+/***************************************************************************
+
+    hashbench.c
+
+    Hashing benchmark. Times the portable and CPU-specific CRC-32 and
+    SHA-1 implementations used by the hash creators over a range of
+    buffer sizes and verifies that they produce identical digests. The
+    other hashes are timed for comparison.
+
+****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "osdcore.h"
+#include "hashing.h"
+
+#include <vector>
+
+
+/***************************************************************************
+    CONSTANTS & DEFINES
+***************************************************************************/
+
+#define DEFAULT_BYTES           (256 * 1024 * 1024)
+
+
+/***************************************************************************
+    TYPE DEFINITIONS
+***************************************************************************/
+
+enum hash_type
+{
+	HASH_CRC32,
+	HASH_SHA1,
+	HASH_CRC16,
+	HASH_MD5,
+	HASH_COUNT
+};
+
+static const char *const s_hash_name[HASH_COUNT] =
+{
+	"crc32",
+	"sha1",
+	"crc16",
+	"md5"
+};
+
+// a digest of any of the types, for comparison
+struct bench_digest
+{
+	UINT8       raw[20];
+	bool operator==(const bench_digest &rhs) const { return memcmp(raw, rhs.raw, sizeof(raw)) == 0; }
+};
+
+
+/***************************************************************************
+    IMPLEMENTATION
+***************************************************************************/
+
+/*-------------------------------------------------
+    set_accelerated - select the implementations
+    for both accelerated hashes
+-------------------------------------------------*/
+
+static void set_accelerated(bool enable)
+{
+	crc32_creator::set_accelerated(enable);
+	sha1_creator::set_accelerated(enable);
+}
+
+
+/*-------------------------------------------------
+    hash_buffer - hash 'length' bytes in chunks
+    of 'chunk' bytes with the given hash
+-------------------------------------------------*/
+
+static bench_digest hash_buffer(hash_type type, const UINT8 *data, UINT32 length, UINT32 chunk)
+{
+	bench_digest result;
+	memset(&result, 0, sizeof(result));
+
+	switch (type)
+	{
+		case HASH_CRC32:
+		{
+			crc32_creator creator;
+			for (UINT32 offset = 0; offset < length; offset += chunk)
+				creator.append(data + offset, MIN(chunk, length - offset));
+			UINT32 crc = creator.finish();
+			memcpy(result.raw, &crc, sizeof(crc));
+			break;
+		}
+
+		case HASH_SHA1:
+		{
+			sha1_creator creator;
+			for (UINT32 offset = 0; offset < length; offset += chunk)
+				creator.append(data + offset, MIN(chunk, length - offset));
+			sha1_t sha1 = creator.finish();
+			memcpy(result.raw, sha1.m_raw, sizeof(sha1.m_raw));
+			break;
+		}
+
+		case HASH_CRC16:
+		{
+			crc16_creator creator;
+			for (UINT32 offset = 0; offset < length; offset += chunk)
+				creator.append(data + offset, MIN(chunk, length - offset));
+			UINT16 crc = creator.finish();
+			memcpy(result.raw, &crc, sizeof(crc));
+			break;
+		}
+
+		case HASH_MD5:
+		{
+			md5_creator creator;
+			for (UINT32 offset = 0; offset < length; offset += chunk)
+				creator.append(data + offset, MIN(chunk, length - offset));
+			md5_t md5 = creator.finish();
+			memcpy(result.raw, md5.m_raw, sizeof(md5.m_raw));
+			break;
+		}
+
+		default:
+			break;
+	}
+	return result;
+}
+
+
+/*-------------------------------------------------
+    run_pass - hash roughly 'bytes' bytes in
+    chunks of 'chunk' bytes, returning the elapsed
+    ticks
+-------------------------------------------------*/
+
+static osd_ticks_t run_pass(hash_type type, const std::vector<UINT8> &buffer, UINT32 chunk, UINT64 bytes)
+{
+	UINT32 length = buffer.size();
+	UINT64 count = bytes / length + 1;
+
+	osd_ticks_t start = osd_ticks();
+	for (UINT64 pass = 0; pass < count; pass++)
+		hash_buffer(type, &buffer[0], length, chunk);
+	return osd_ticks() - start;
+}
+
+
+/*-------------------------------------------------
+    verify - check that the portable and
+    accelerated implementations agree, including
+    on odd lengths and misaligned chunks
+-------------------------------------------------*/
+
+static bool verify(hash_type type, const std::vector<UINT8> &buffer)
+{
+	static const UINT32 chunks[] = { 1, 3, 15, 16, 63, 64, 65, 1000, 4096 };
+
+	for (UINT32 length = 0; length < 1024; length += 1 + length / 8)
+		for (int chunknum = 0; chunknum < ARRAY_LENGTH(chunks); chunknum++)
+		{
+			set_accelerated(false);
+			bench_digest expected = hash_buffer(type, &buffer[1], length, chunks[chunknum]);
+			set_accelerated(true);
+			if (!(hash_buffer(type, &buffer[1], length, chunks[chunknum]) == expected))
+				return false;
+		}
+
+	set_accelerated(false);
+	bench_digest expected = hash_buffer(type, &buffer[0], buffer.size(), buffer.size());
+	set_accelerated(true);
+	return hash_buffer(type, &buffer[0], buffer.size(), buffer.size()) == expected;
+}
+
+
+/*-------------------------------------------------
+    main - main entry point
+-------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+	static const UINT32 sizes[] = { 64, 1024, 64 * 1024, 4 * 1024 * 1024 };
+	UINT64 bytes = DEFAULT_BYTES;
+
+	if (argc > 2 || (argc == 2 && (bytes = strtoull(argv[1], NULL, 0)) == 0))
+	{
+		fprintf(stderr, "Usage:\nhashbench [bytes per test]\n");
+		return 1;
+	}
+
+	// fill a buffer with pseudo-random data
+	std::vector<UINT8> data(sizes[ARRAY_LENGTH(sizes) - 1]);
+	UINT32 seed = 12345;
+	for (int index = 0; index < (int)data.size(); index++)
+	{
+		seed = seed * 1103515245 + 12345;
+		data[index] = seed >> 16;
+	}
+
+	// find out what's available
+	set_accelerated(true);
+	printf("crc32: %s, sha1: %s\n", crc32_creator::implementation(), sha1_creator::implementation());
+
+	printf("%-6s %8s %16s %16s %8s %s\n", "hash", "size", "portable", "accelerated", "speedup", "verify");
+	double tps = (double)osd_ticks_per_second();
+	bool allok = true;
+	for (int type = 0; type < HASH_COUNT; type++)
+	{
+		hash_type curtype = hash_type(type);
+		bool ok = verify(curtype, data);
+		allok = allok && ok;
+
+		for (int sizenum = 0; sizenum < ARRAY_LENGTH(sizes); sizenum++)
+		{
+			std::vector<UINT8> buffer(data.begin(), data.begin() + sizes[sizenum]);
+
+			set_accelerated(false);
+			double gentime = run_pass(curtype, buffer, buffer.size(), bytes) / tps;
+			set_accelerated(true);
+			double acceltime = run_pass(curtype, buffer, buffer.size(), bytes) / tps;
+			printf("%-6s %8d %11.2f GB/s %11.2f GB/s %7.2fx %s\n", s_hash_name[type], sizes[sizenum],
+					(double)bytes / gentime / 1e9, (double)bytes / acceltime / 1e9, gentime / acceltime, ok ? "ok" : "MISMATCH");
+		}
+	}
+
+	return allok ? 0 : 1;
+}
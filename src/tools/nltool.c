@@ -29,6 +29,7 @@
 #ifdef PSTANDALONE_PROVIDED
 
 #include <ctime>
+#include <dirent.h>
 
 #define osd_ticks_t clock_t
 
@@ -39,6 +40,10 @@ osd_ticks_t osd_ticks(void) { return clock(); }
 
 #endif
 
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
+
 /***************************************************************************
  * MAME COMPATIBILITY ...
  *
@@ -103,7 +108,10 @@ public:
 		opt_logs("l", "logs",        "",      "colon separated list of terminals to log", this),
 		opt_file("f", "file",        "-",     "file to process (default is stdin)", this),
 		opt_type("y", "type",        "spice", "spice:eagle", "type of file to be converted: spice,eagle", this),
-		opt_cmd ("c", "cmd",         "run",   "run|convert|listdevices", this),
+		opt_cmd ("c", "cmd",         "run",   "run|convert|listdevices|static|bench", this),
+		opt_base("b", "baseline",    "",      "bench: JSON output of an earlier run to compare with", this),
+		opt_thr ("",  "threshold",   5.0,     "bench: slowdown against the baseline reported as regression (%)", this),
+		opt_lim ("",  "limit",       60.0,    "bench: real time limit per netlist (seconds), 0 for none", this),
 		opt_verb("v", "verbose",              "be verbose - this produces lots of output", this),
 		opt_help("h", "help",                 "display help", this)
 	{}
@@ -114,6 +122,9 @@ public:
 	poption_str    opt_file;
 	poption_str_limit opt_type;
 	poption_str    opt_cmd;
+	poption_str    opt_base;
+	poption_double opt_thr;
+	poption_double opt_lim;
 	poption_bool   opt_verb;
 	poption_bool   opt_help;
 };
@@ -233,13 +244,15 @@ protected:
 				}
 				break;
 			case NL_WARNING:
-				vprintf(format, ap);
-				printf("\n");
+				vfprintf(stderr, format, ap);
+				fprintf(stderr, "\n");
 				break;
 			case NL_ERROR:
-				vprintf(format, ap);
-				printf("\n");
-				throw;
+			{
+				pstring errstr = pstring(format).vprintf(ap);
+				fprintf(stderr, "%s\n", errstr.cstr());
+				throw netlist::fatalerror_e("%s", errstr.cstr());
+			}
 		}
 	}
 
@@ -260,6 +273,56 @@ void usage(tool_options_t &opts)
 	fprintf(stderr, "%s\n", opts.help().cstr());
 }
 
+#if (NL_KEEP_STATISTICS)
+/*-------------------------------------------------
+    queue_bucket_end, queue_next_bucket,
+    queue_pushes - power of two buckets of the
+    queue length histogram
+-------------------------------------------------*/
+
+static unsigned queue_bucket_end(const netlist::queue_t &queue, unsigned lo)
+{
+	return (lo == 0) ? 0 : std::min(lo * 2 - 1, (unsigned) queue.capacity());
+}
+
+static unsigned queue_next_bucket(unsigned lo)
+{
+	return (lo == 0) ? 1 : lo * 2;
+}
+
+static double queue_pushes(const netlist::queue_t &queue, unsigned lo, unsigned hi)
+{
+	double cnt = 0.0;
+	for (unsigned i = lo; i <= hi; i++)
+		cnt += (double) queue.stat_length(i);
+	return cnt;
+}
+
+/*-------------------------------------------------
+    queue_stats - print events per second and a
+    histogram of the queue length at push time
+-------------------------------------------------*/
+
+static void queue_stats(const netlist::queue_t &queue, double emutime)
+{
+	double events = (double) queue.stat_processed();
+	double pushes = queue_pushes(queue, 0, queue.capacity());
+
+	printf("%.0f events processed ==> %.3f M events/s\n", events, events / emutime / 1.0e6);
+	if (pushes == 0.0)
+		return;
+
+	printf("queue length at push:\n");
+	for (unsigned lo = 0; lo <= queue.capacity(); lo = queue_next_bucket(lo))
+	{
+		unsigned hi = queue_bucket_end(queue, lo);
+		double cnt = queue_pushes(queue, lo, hi);
+		if (cnt > 0.0)
+			printf("  %4d - %4d: %15.0f %6.2f%%\n", lo, hi, cnt, cnt * 100.0 / pushes);
+	}
+}
+#endif
+
 static void run(tool_options_t &opts)
 {
 	netlist_tool_t nt;
@@ -280,6 +343,284 @@ static void run(tool_options_t &opts)
 
 	double emutime = (double) (osd_ticks() - t) / (double) osd_ticks_per_second();
 	printf("%f seconds emulation took %f real time ==> %5.2f%%\n", ttr, emutime, ttr/emutime*100.0);
+
+#if (NL_KEEP_STATISTICS)
+	queue_stats(nt.queue(), emutime);
+#endif
+}
+
+/*-------------------------------------------------
+    static_solvers - emit code for static solvers
+    of all net groups of a netlist
+-------------------------------------------------*/
+
+static void static_solvers(tool_options_t &opts)
+{
+	netlist_tool_t nt;
+
+	nt.init();
+	nt.m_verbose = opts.opt_verb();
+	nt.read_netlist(filetobuf(opts.opt_file()), opts.opt_name());
+
+	printf("// generated by nltool from %s\n\n", opts.opt_file().cstr());
+	printf("%s", nt.solver()->create_static_solvers().cstr());
+}
+
+/*-------------------------------------------------
+    bench_files - add a netlist file or all
+    netlist files in a directory to the list
+-------------------------------------------------*/
+
+static void bench_files(pstring_list_t &files, const pstring &path)
+{
+	pstring_list_t found;
+
+#ifdef PSTANDALONE_PROVIDED
+	DIR *dir = opendir(path);
+	if (dir == NULL)
+	{
+		files.add(path);
+		return;
+	}
+	for (const struct dirent *entry = readdir(dir); entry != NULL; entry = readdir(dir))
+	{
+		pstring name(entry->d_name);
+		if (name.len() > 2 && name.right(2) == ".c")
+			found.add(path + "/" + name);
+	}
+	closedir(dir);
+#else
+	osd_directory *dir = osd_opendir(path);
+	if (dir == NULL)
+	{
+		files.add(path);
+		return;
+	}
+	for (const osd_directory_entry *entry = osd_readdir(dir); entry != NULL; entry = osd_readdir(dir))
+	{
+		pstring name(entry->name);
+		if (entry->type == ENTTYPE_FILE && name.len() > 2 && name.right(2) == ".c")
+			found.add(path + "/" + name);
+	}
+	osd_closedir(dir);
+#endif
+
+	psort_list(found);
+	for (std::size_t i = 0; i < found.size(); i++)
+		files.add(found[i]);
+}
+
+/*-------------------------------------------------
+    peak_memory - peak resident set size of the
+    whole process so far in kB, 0 if unknown
+-------------------------------------------------*/
+
+static long peak_memory()
+{
+#if defined(_WIN32)
+	return 0;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+#if defined(__APPLE__)
+	return usage.ru_maxrss / 1024;
+#else
+	return usage.ru_maxrss;
+#endif
+#endif
+}
+
+/*-------------------------------------------------
+    json_string - quote a string for JSON
+-------------------------------------------------*/
+
+static pstring json_string(const pstring &str)
+{
+	pstring ret = "\"";
+	for (const char *p = str.cstr(); *p != 0; p++)
+	{
+		if (*p == '"' || *p == '\\')
+			ret += pstring::sprintf("\\%c", *p);
+		else if (*p == '\n')
+			ret += "\\n";
+		else if (*p == '\t')
+			ret += "\\t";
+		else if ((unsigned char) *p < 0x20)
+			ret += pstring::sprintf("\\u%04x", (unsigned char) *p);
+		else
+			ret += *p;
+	}
+	return ret + "\"";
+}
+
+/*-------------------------------------------------
+    json_value - extract the value of a key from
+    a line written by bench; strings are returned
+    quoted, "" if the key is missing
+-------------------------------------------------*/
+
+static pstring json_value(const pstring &line, const char *key)
+{
+	int start = line.find(pstring::sprintf("\"%s\": ", key));
+	if (start < 0)
+		return "";
+	start += strlen(key) + 4;
+
+	int end = start;
+	if (line.substr(start, 1) == "\"")
+	{
+		for (end++; end < line.len() && line.substr(end, 1) != "\""; end++)
+			if (line.substr(end, 1) == "\\")
+				end++;
+		return line.substr(start, end + 1 - start);
+	}
+	while (end < line.len() && line.substr(end, 1) != "," && line.substr(end, 1) != "}")
+		end++;
+	return line.substr(start, end - start).trim();
+}
+
+/*-------------------------------------------------
+    bench - run netlists for a fixed time and
+    print performance figures as JSON, one line
+    per netlist, followed by the peak memory of
+    the whole run
+
+    -f is a comma separated list of netlist files
+    and directories. "file@name" runs netlist
+    "name" in the file, otherwise the first
+    netlist in each file is run. Netlists which
+    fail or exceed the real time limit are
+    reported with an error and skipped.
+-------------------------------------------------*/
+
+static int bench(tool_options_t &opts)
+{
+	const double ttr = opts.opt_ttr();
+	const double threshold = opts.opt_thr();
+	const double limit = opts.opt_lim();
+	int regressions = 0;
+
+	pstring_list_t baseline;
+	if (opts.opt_base() != "")
+		baseline = pstring_list_t(filetobuf(opts.opt_base()), "\n", true);
+
+	pstring_list_t args(opts.opt_file(), ",", true);
+	pstring_list_t files;
+	for (std::size_t i = 0; i < args.size(); i++)
+		bench_files(files, args[i]);
+
+	printf("{\n  \"time_to_run\": %f,\n  \"netlists\": [\n", ttr);
+	fflush(stdout);
+	for (std::size_t i = 0; i < files.size(); i++)
+	{
+		pstring file = files[i];
+		pstring name = opts.opt_name();
+		int at = file.find("@");
+		if (at >= 0)
+		{
+			name = file.substr(at + 1);
+			file = file.left(at);
+		}
+		pstring line = "{\"file\": " + json_string(file) + ", \"name\": " + json_string(name);
+		pstring label = (name != "") ? file + "@" + name : file;
+
+		fprintf(stderr, "bench %s\n", label.cstr());
+		try
+		{
+			netlist_tool_t nt;
+
+			nt.init();
+			nt.m_verbose = opts.opt_verb();
+			nt.read_netlist(filetobuf(file), name);
+
+			/* run in slices of 1/100 of the time to run to enforce the limit */
+			osd_ticks_t t = osd_ticks();
+			const netlist::netlist_time slice = netlist::netlist_time::from_double(ttr / 100.0);
+			double emutime = 0.0;
+			for (int s = 0; s < 100; s++)
+			{
+				nt.process_queue(slice);
+				emutime = (double) (osd_ticks() - t) / (double) osd_ticks_per_second();
+				if (limit > 0.0 && emutime > limit)
+					throw netlist::fatalerror_e("real time limit of %f s exceeded after %f s emulated", limit, ttr * (s + 1) / 100.0);
+			}
+			nt.stop();
+			emutime = (double) (osd_ticks() - t) / (double) osd_ticks_per_second();
+
+			unsigned groups = (nt.solver() != NULL) ? nt.solver()->group_count() : 0;
+
+			line += pstring::sprintf(", \"time_to_run\": %f, \"real_time\": %f", ttr, emutime);
+#if (NL_KEEP_STATISTICS)
+			/* event counts and solver time are only measured when statistics are compiled in */
+			const netlist::queue_t &queue = nt.queue();
+			double events = (double) queue.stat_processed();
+			double solver_time = (nt.solver() != NULL) ? (double) nt.solver()->stat_time() / (double) pticks_per_second() : 0.0;
+			line += pstring::sprintf(", \"events\": %.0f, \"events_per_s\": %.0f", events, emutime > 0.0 ? events / emutime : 0.0);
+			line += pstring::sprintf(", \"solver_groups\": %d, \"solver_share\": %.2f",
+					groups, emutime > 0.0 ? 100.0 * solver_time / emutime : 0.0);
+#else
+			line += ", \"events\": null, \"events_per_s\": null";
+			line += pstring::sprintf(", \"solver_groups\": %d, \"solver_share\": null", groups);
+#endif
+#if (NL_KEEP_STATISTICS)
+			line += ", \"queue_length\": {";
+			pstring sep = "";
+			for (unsigned lo = 0; lo <= queue.capacity(); lo = queue_next_bucket(lo))
+			{
+				unsigned hi = queue_bucket_end(queue, lo);
+				double cnt = queue_pushes(queue, lo, hi);
+				if (cnt > 0.0)
+				{
+					line += sep + pstring::sprintf("\"%d-%d\": %.0f", lo, hi, cnt);
+					sep = ", ";
+				}
+			}
+			line += "}";
+#else
+			line += ", \"queue_length\": null";
+#endif
+
+			/* compare real time per emulated second with the baseline */
+			for (std::size_t j = 0; j < baseline.size(); j++)
+			{
+				const pstring &bl = baseline[j];
+				if (json_value(bl, "file") != json_string(file) || json_value(bl, "name") != json_string(name))
+					continue;
+				double base_time = json_value(bl, "real_time").as_double();
+				double base_ttr = json_value(bl, "time_to_run").as_double();
+				if (base_time <= 0.0 || base_ttr <= 0.0)
+					break;
+				double change = 100.0 * (emutime / ttr) / (base_time / base_ttr) - 100.0;
+				bool regression = (change > threshold);
+				line += pstring::sprintf(", \"baseline_real_time\": %f, \"change\": %.2f, \"regression\": %s",
+						base_time * ttr / base_ttr, change, regression ? "true" : "false");
+				if (regression)
+				{
+					fprintf(stderr, "REGRESSION: %s is %.2f%% slower\n", label.cstr(), change);
+					regressions++;
+				}
+				break;
+			}
+		}
+		catch (netlist::fatalerror_e &e)
+		{
+			line += ", \"error\": " + json_string(e.text());
+		}
+		catch (...)
+		{
+			line += ", \"error\": \"unknown exception\"";
+		}
+		/* flush so a crash in a later netlist keeps the results so far */
+		printf("    %s}%s\n", line.cstr(), (i + 1 < files.size()) ? "," : "");
+		fflush(stdout);
+	}
+	/* the peak only grows over the run, so it is not attributed to single netlists */
+	long peak = peak_memory();
+	printf("  ],\n  \"peak_memory_kb\": %s,\n  \"regressions\": %d\n}\n",
+			(peak > 0) ? pstring::sprintf("%ld", peak).cstr() : "null", regressions);
+
+	return (regressions > 0) ? 1 : 0;
 }
 
 /*-------------------------------------------------
@@ -358,6 +699,8 @@ static const char *pmf_verbose[] =
 
 int main(int argc, char *argv[])
 {
+	int exitcode = 0;
+
 #if (!PSTANDALONE)
 	track_memory(true);
 	{
@@ -385,6 +728,10 @@ int main(int argc, char *argv[])
 		listdevices();
 	else if (cmd == "run")
 		run(opts);
+	else if (cmd == "static")
+		static_solvers(opts);
+	else if (cmd == "bench")
+		exitcode = bench(opts);
 	else if (cmd == "convert")
 	{
 		pstring contents = filetobuf(opts.opt_file());
@@ -408,5 +755,5 @@ int main(int argc, char *argv[])
 	}
 	dump_unfreed_mem();
 #endif
-	return 0;
+	return exitcode;
 }
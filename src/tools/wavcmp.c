@@ -0,0 +1,189 @@
+// license:BSD-3-Clause
+// copyright-holders:MAMEdev Team
+/***************************************************************************
+
+    wavcmp.c
+
+    WAV comparison. Compares two 16-bit PCM files as written by -wavwrite
+    sample by sample, e.g. to verify that a change to a sound core does
+    not change its output.
+
+****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "osdcore.h"
+
+#include <vector>
+
+
+/***************************************************************************
+    TYPE DEFINITIONS
+***************************************************************************/
+
+struct wav_file
+{
+	UINT32              rate;
+	UINT16              channels;
+	std::vector<INT16>  samples;
+};
+
+
+/***************************************************************************
+    IMPLEMENTATION
+***************************************************************************/
+
+/*-------------------------------------------------
+    read_le16/read_le32 - little endian fields
+-------------------------------------------------*/
+
+static UINT16 read_le16(const UINT8 *p)
+{
+	return p[0] | (p[1] << 8);
+}
+
+static UINT32 read_le32(const UINT8 *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | (p[3] << 24);
+}
+
+
+/*-------------------------------------------------
+    load_wav - read the format and the samples
+    of a 16-bit PCM WAV file
+-------------------------------------------------*/
+
+static bool load_wav(const char *filename, wav_file &wav)
+{
+	FILE *file = fopen(filename, "rb");
+	if (file == NULL)
+	{
+		fprintf(stderr, "Could not open %s\n", filename);
+		return false;
+	}
+
+	UINT8 header[12];
+	bool have_format = false;
+	bool result = false;
+	if (fread(header, 1, sizeof(header), file) != sizeof(header) || memcmp(header, "RIFF", 4) != 0 || memcmp(header + 8, "WAVE", 4) != 0)
+	{
+		fprintf(stderr, "%s is not a WAV file\n", filename);
+		goto done;
+	}
+
+	// walk the chunks until we have the data
+	for (;;)
+	{
+		UINT8 chunk[8];
+		if (fread(chunk, 1, sizeof(chunk), file) != sizeof(chunk))
+		{
+			fprintf(stderr, "%s has no data chunk\n", filename);
+			goto done;
+		}
+		UINT32 length = read_le32(&chunk[4]);
+
+		if (memcmp(chunk, "fmt ", 4) == 0)
+		{
+			UINT8 format[16];
+			if (length < sizeof(format) || fread(format, 1, sizeof(format), file) != sizeof(format))
+			{
+				fprintf(stderr, "%s has a bad format chunk\n", filename);
+				goto done;
+			}
+			if (read_le16(&format[0]) != 1 || read_le16(&format[14]) != 16)
+			{
+				fprintf(stderr, "%s is not 16-bit PCM\n", filename);
+				goto done;
+			}
+			wav.channels = read_le16(&format[2]);
+			wav.rate = read_le32(&format[4]);
+			have_format = true;
+			length -= sizeof(format);
+		}
+		else if (memcmp(chunk, "data", 4) == 0)
+		{
+			if (!have_format)
+			{
+				fprintf(stderr, "%s has no format chunk\n", filename);
+				goto done;
+			}
+
+			// files written by an aborted session may have a short data chunk
+			std::vector<UINT8> data(length);
+			data.resize(fread(&data[0], 1, length, file));
+			wav.samples.resize(data.size() / 2);
+			for (size_t i = 0; i < wav.samples.size(); i++)
+				wav.samples[i] = (INT16)read_le16(&data[i * 2]);
+			result = true;
+			goto done;
+		}
+
+		// skip the rest of the chunk, chunks are word aligned
+		if (fseek(file, (length + 1) & ~1, SEEK_CUR) != 0)
+		{
+			fprintf(stderr, "%s is truncated\n", filename);
+			goto done;
+		}
+	}
+
+done:
+	fclose(file);
+	return result;
+}
+
+
+/*-------------------------------------------------
+    main - main entry point
+-------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+	if (argc < 3)
+	{
+		fprintf(stderr, "Usage:\nwavcmp <wav1> <wav2>\n");
+		return 10;
+	}
+
+	wav_file wav1, wav2;
+	if (!load_wav(argv[1], wav1) || !load_wav(argv[2], wav2))
+		return 10;
+
+	if (wav1.channels != wav2.channels || wav1.rate != wav2.rate)
+	{
+		printf("Formats differ: %d channels at %d Hz vs %d channels at %d Hz\n", wav1.channels, wav1.rate, wav2.channels, wav2.rate);
+		return 1;
+	}
+
+	// compare the common part
+	size_t count = MIN(wav1.samples.size(), wav2.samples.size());
+	size_t first = count, differ = 0;
+	int maxdiff = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		int diff = abs(wav1.samples[i] - wav2.samples[i]);
+		if (diff != 0)
+		{
+			if (first == count)
+				first = i;
+			differ++;
+			maxdiff = MAX(maxdiff, diff);
+		}
+	}
+
+	UINT16 channels = MAX(wav1.channels, 1);
+	printf("%d frames compared\n", (int)(count / channels));
+	if (wav1.samples.size() != wav2.samples.size())
+		printf("Lengths differ: %d vs %d frames\n", (int)(wav1.samples.size() / channels), (int)(wav2.samples.size() / channels));
+	if (differ != 0)
+	{
+		printf("First difference at frame %d (%.6f s) channel %d: %d vs %d\n", (int)(first / channels), (double)(first / channels) / wav1.rate,
+				(int)(first % channels), wav1.samples[first], wav2.samples[first]);
+		printf("%d samples differ, maximum difference %d\n", (int)differ, maxdiff);
+	}
+
+	if (differ != 0 || wav1.samples.size() != wav2.samples.size())
+		return 1;
+	printf("Files are identical\n");
+	return 0;
+}
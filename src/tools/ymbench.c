@@ -0,0 +1,450 @@
+// license:BSD-3-Clause
+// copyright-holders:MAMEdev Team
+/***************************************************************************
+
+    ymbench.c
+
+    Yamaha FM sound core benchmark. Drives the YM2151, YM2203, YM2612 and
+    YM3812 cores with random patches and key on/off writes spread over
+    60 Hz frames, the way a sound CPU does, and times the update calls.
+    The output can be written to a WAV file and compared with wavcmp to
+    verify that a change to a core does not change its output.
+
+****************************************************************************/
+
+#include "emu.h"
+#include "ym2151.h"
+#include "fm.h"
+#include "fmopl.h"
+
+#include <vector>
+
+
+/***************************************************************************
+    CONSTANTS & DEFINES
+***************************************************************************/
+
+#define DEFAULT_SECONDS         20
+#define FRAME_RATE              60
+
+
+/***************************************************************************
+    TYPE DEFINITIONS
+***************************************************************************/
+
+struct chip_desc
+{
+	const char *    name;
+	UINT32          clock;
+	UINT32          divider;                // sample rate is clock / divider
+	int             outputs;
+	int             channels;
+
+	void *          (*init)(device_t &device, UINT32 clock, UINT32 rate);
+	void            (*update)(void *chip, stream_sample_t **buffers, int samples);
+	void            (*patch)(void *chip, int channel);
+	void            (*key)(void *chip, int channel, bool on, bool newnote);
+};
+
+
+/***************************************************************************
+    GLOBAL VARIABLES
+***************************************************************************/
+
+const attotime attotime::zero;
+
+static UINT32 s_seed;
+
+
+/***************************************************************************
+    IMPLEMENTATION
+***************************************************************************/
+
+/*-------------------------------------------------
+    rnd - return a random number in 0..range-1
+-------------------------------------------------*/
+
+static int rnd(int range)
+{
+	s_seed = s_seed * 1103515245 + 12345;
+	return (s_seed >> 16) % range;
+}
+
+
+/*-------------------------------------------------
+    update requests and SSG callbacks, normally
+    provided by the device interfaces
+-------------------------------------------------*/
+
+void ym2203_update_request(void *param) { }
+void ym2608_update_request(void *param) { }
+void ym2610_update_request(void *param) { }
+void ym2612_update_request(void *param) { }
+
+static void ssg_set_clock(void *param, int clock) { }
+static void ssg_write(void *param, int address, int data) { }
+static int ssg_read(void *param) { return 0; }
+static void ssg_reset(void *param) { }
+
+static const ssg_callbacks s_ssg_callbacks =
+{
+	&ssg_set_clock,
+	&ssg_write,
+	&ssg_read,
+	&ssg_reset
+};
+
+
+/*-------------------------------------------------
+    YM2151
+-------------------------------------------------*/
+
+static void *ym2151_bench_init(device_t &device, UINT32 clock, UINT32 rate)
+{
+	void *chip = ym2151_init(&device, clock, rate);
+	ym2151_reset_chip(chip);
+
+	// LFO with some AM and PM depth
+	ym2151_write_reg(chip, 0x18, 0xc0);
+	ym2151_write_reg(chip, 0x19, 0x20);
+	ym2151_write_reg(chip, 0x19, 0x90);
+	ym2151_write_reg(chip, 0x1b, 1);
+	return chip;
+}
+
+static void ym2151_bench_update(void *chip, stream_sample_t **buffers, int samples)
+{
+	ym2151_update_one(chip, buffers, samples);
+}
+
+static void ym2151_bench_patch(void *chip, int channel)
+{
+	ym2151_write_reg(chip, 0x20 + channel, 0xc0 | (rnd(8) << 3) | rnd(8));
+	ym2151_write_reg(chip, 0x38 + channel, rnd(2) ? (rnd(8) << 4) | rnd(4) : 0);
+	for (int op = 0; op < 4; op++)
+	{
+		int offset = channel + op * 8;
+		ym2151_write_reg(chip, 0x40 + offset, rnd(128));
+		ym2151_write_reg(chip, 0x60 + offset, rnd(op == 3 ? 20 : 60));
+		ym2151_write_reg(chip, 0x80 + offset, rnd(256));
+		ym2151_write_reg(chip, 0xa0 + offset, rnd(256));
+		ym2151_write_reg(chip, 0xc0 + offset, rnd(256));
+		ym2151_write_reg(chip, 0xe0 + offset, rnd(256));
+	}
+}
+
+static void ym2151_bench_key(void *chip, int channel, bool on, bool newnote)
+{
+	if (newnote)
+	{
+		ym2151_write_reg(chip, 0x28 + channel, rnd(128));
+		ym2151_write_reg(chip, 0x30 + channel, rnd(256));
+	}
+	ym2151_write_reg(chip, 0x08, channel | (on ? rnd(16) << 3 : 0));
+}
+
+
+/*-------------------------------------------------
+    YM2203/YM2612 - OPN register layout
+-------------------------------------------------*/
+
+static void opn_patch(void *chip, void (*write)(void *, int, int), int channel)
+{
+	int base = (channel % 3) + ((channel / 3) << 8);
+
+	(*write)(chip, base + 0xb0, rnd(64));
+	(*write)(chip, base + 0xb4, 0xc0 | rnd(64));
+	for (int op = 0; op < 4; op++)
+	{
+		int offset = base + op * 4;
+		(*write)(chip, 0x30 + offset, rnd(128));
+		(*write)(chip, 0x40 + offset, rnd(op == 3 ? 20 : 60));
+		(*write)(chip, 0x50 + offset, rnd(256));
+		(*write)(chip, 0x60 + offset, rnd(256));
+		(*write)(chip, 0x70 + offset, rnd(32));
+		(*write)(chip, 0x80 + offset, rnd(256));
+		(*write)(chip, 0x90 + offset, rnd(4) ? 0 : 0x08 | rnd(8));
+	}
+}
+
+static void opn_key(void *chip, void (*write)(void *, int, int), int channel, bool on, bool newnote)
+{
+	int base = (channel % 3) + ((channel / 3) << 8);
+
+	if (newnote)
+	{
+		(*write)(chip, base + 0xa4, rnd(64));
+		(*write)(chip, base + 0xa0, rnd(256));
+	}
+	(*write)(chip, 0x28, (channel % 3) | ((channel / 3) << 2) | (on ? rnd(16) << 4 : 0));
+}
+
+
+/*-------------------------------------------------
+    YM2203
+-------------------------------------------------*/
+
+static void *ym2203_bench_init(device_t &device, UINT32 clock, UINT32 rate)
+{
+	void *chip = ym2203_init(NULL, &device, clock, rate, NULL, NULL, &s_ssg_callbacks);
+	ym2203_reset_chip(chip);
+	return chip;
+}
+
+static void ym2203_bench_write(void *chip, int reg, int data)
+{
+	ym2203_write(chip, 0, reg);
+	ym2203_write(chip, 1, data);
+}
+
+static void ym2203_bench_update(void *chip, stream_sample_t **buffers, int samples)
+{
+	ym2203_update_one(chip, buffers[0], samples);
+}
+
+static void ym2203_bench_patch(void *chip, int channel)
+{
+	opn_patch(chip, ym2203_bench_write, channel);
+}
+
+static void ym2203_bench_key(void *chip, int channel, bool on, bool newnote)
+{
+	opn_key(chip, ym2203_bench_write, channel, on, newnote);
+}
+
+
+/*-------------------------------------------------
+    YM2612
+-------------------------------------------------*/
+
+static void *ym2612_bench_init(device_t &device, UINT32 clock, UINT32 rate)
+{
+	void *chip = ym2612_init(NULL, &device, clock, rate, NULL, NULL);
+	ym2612_reset_chip(chip);
+
+	// LFO on
+	ym2612_write(chip, 0, 0x22);
+	ym2612_write(chip, 1, 0x08 | rnd(8));
+	return chip;
+}
+
+static void ym2612_bench_write(void *chip, int reg, int data)
+{
+	ym2612_write(chip, (reg >> 7) & 2, reg & 0xff);
+	ym2612_write(chip, ((reg >> 7) & 2) | 1, data);
+}
+
+static void ym2612_bench_update(void *chip, stream_sample_t **buffers, int samples)
+{
+	ym2612_update_one(chip, buffers, samples);
+}
+
+static void ym2612_bench_patch(void *chip, int channel)
+{
+	opn_patch(chip, ym2612_bench_write, channel);
+}
+
+static void ym2612_bench_key(void *chip, int channel, bool on, bool newnote)
+{
+	opn_key(chip, ym2612_bench_write, channel, on, newnote);
+}
+
+
+/*-------------------------------------------------
+    YM3812
+-------------------------------------------------*/
+
+static void *ym3812_bench_init(device_t &device, UINT32 clock, UINT32 rate)
+{
+	void *chip = ym3812_init(&device, clock, rate);
+	ym3812_reset_chip(chip);
+
+	// waveform select on, AM/PM depth
+	ym3812_write(chip, 0, 0x01);
+	ym3812_write(chip, 1, 0x20);
+	ym3812_write(chip, 0, 0xbd);
+	ym3812_write(chip, 1, rnd(4) << 6);
+	return chip;
+}
+
+static void ym3812_bench_write(void *chip, int reg, int data)
+{
+	ym3812_write(chip, 0, reg);
+	ym3812_write(chip, 1, data);
+}
+
+static void ym3812_bench_update(void *chip, stream_sample_t **buffers, int samples)
+{
+	ym3812_update_one(chip, buffers[0], samples);
+}
+
+static void ym3812_bench_patch(void *chip, int channel)
+{
+	int slot = (channel % 3) + (channel / 3) * 8;
+
+	ym3812_bench_write(chip, 0xc0 + channel, rnd(16));
+	for (int op = 0; op < 2; op++)
+	{
+		int offset = slot + op * 3;
+		ym3812_bench_write(chip, 0x20 + offset, rnd(256));
+		ym3812_bench_write(chip, 0x40 + offset, rnd(op == 1 ? 16 : 64));
+		ym3812_bench_write(chip, 0x60 + offset, rnd(256));
+		ym3812_bench_write(chip, 0x80 + offset, rnd(256));
+		ym3812_bench_write(chip, 0xe0 + offset, rnd(4));
+	}
+}
+
+static void ym3812_bench_key(void *chip, int channel, bool on, bool newnote)
+{
+	static UINT8 s_block[9];
+
+	if (newnote)
+	{
+		ym3812_bench_write(chip, 0xa0 + channel, rnd(256));
+		s_block[channel] = rnd(32);
+	}
+	ym3812_bench_write(chip, 0xb0 + channel, s_block[channel] | (on ? 0x20 : 0));
+}
+
+
+/*-------------------------------------------------
+    chip table
+-------------------------------------------------*/
+
+static const chip_desc s_chips[] =
+{
+	{ "ym2151", 3579545,  64, 2, 8, ym2151_bench_init, ym2151_bench_update, ym2151_bench_patch, ym2151_bench_key },
+	{ "ym2203", 3579545,  72, 1, 3, ym2203_bench_init, ym2203_bench_update, ym2203_bench_patch, ym2203_bench_key },
+	{ "ym2612", 7670453, 144, 2, 6, ym2612_bench_init, ym2612_bench_update, ym2612_bench_patch, ym2612_bench_key },
+	{ "ym3812", 3579545,  72, 1, 9, ym3812_bench_init, ym3812_bench_update, ym3812_bench_patch, ym3812_bench_key }
+};
+
+
+/*-------------------------------------------------
+    write_le16/write_le32 - little endian fields
+-------------------------------------------------*/
+
+static void write_le16(UINT8 *p, UINT16 value)
+{
+	p[0] = value;
+	p[1] = value >> 8;
+}
+
+static void write_le32(UINT8 *p, UINT32 value)
+{
+	p[0] = value;
+	p[1] = value >> 8;
+	p[2] = value >> 16;
+	p[3] = value >> 24;
+}
+
+
+/*-------------------------------------------------
+    write_wav - write interleaved samples to a
+    16-bit PCM WAV file
+-------------------------------------------------*/
+
+static bool write_wav(const char *filename, const std::vector<INT16> &samples, int channels, UINT32 rate)
+{
+	FILE *file = fopen(filename, "wb");
+	if (file == NULL)
+	{
+		fprintf(stderr, "Could not create %s\n", filename);
+		return false;
+	}
+
+	UINT32 bytes = samples.size() * 2;
+	std::vector<UINT8> data(44 + bytes);
+	memcpy(&data[0], "RIFF", 4);
+	write_le32(&data[4], 36 + bytes);
+	memcpy(&data[8], "WAVEfmt ", 8);
+	write_le32(&data[16], 16);
+	write_le16(&data[20], 1);
+	write_le16(&data[22], channels);
+	write_le32(&data[24], rate);
+	write_le32(&data[28], rate * channels * 2);
+	write_le16(&data[32], channels * 2);
+	write_le16(&data[34], 16);
+	memcpy(&data[36], "data", 4);
+	write_le32(&data[40], bytes);
+	for (size_t index = 0; index < samples.size(); index++)
+		write_le16(&data[44 + index * 2], samples[index]);
+
+	bool result = (fwrite(&data[0], 1, data.size(), file) == data.size());
+	fclose(file);
+	if (!result)
+		fprintf(stderr, "Error writing %s\n", filename);
+	return result;
+}
+
+
+/*-------------------------------------------------
+    main - main entry point
+-------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+	const chip_desc *desc = NULL;
+	for (int index = 0; argc > 1 && index < (int)ARRAY_LENGTH(s_chips); index++)
+		if (strcmp(argv[1], s_chips[index].name) == 0)
+			desc = &s_chips[index];
+
+	if (argc < 3 || argc > 6 || desc == NULL)
+	{
+		fprintf(stderr, "Usage:\nymbench <ym2151|ym2203|ym2612|ym3812> <output.wav|-> [seconds] [active channels] [seed]\n");
+		return 1;
+	}
+
+	int seconds = (argc > 3) ? atoi(argv[3]) : DEFAULT_SECONDS;
+	int active = (argc > 4) ? atoi(argv[4]) : desc->channels;
+	s_seed = (argc > 5) ? strtoul(argv[5], NULL, 0) : 12345;
+	active = MAX(1, MIN(active, desc->channels));
+
+	UINT32 rate = desc->clock / desc->divider;
+	device_t device(desc->clock);
+	void *chip = (*desc->init)(device, desc->clock, rate);
+	for (int channel = 0; channel < desc->channels; channel++)
+		(*desc->patch)(chip, channel);
+
+	int total = seconds * rate;
+	std::vector<INT16> output(total * desc->outputs);
+	std::vector<stream_sample_t> left(rate), right(rate);
+	stream_sample_t *buffers[2] = { &left[0], &right[0] };
+	osd_ticks_t elapsed = 0;
+
+	for (int pos = 0; pos < total; )
+	{
+		// a frame with a few register writes in between, like a sound CPU
+		for (int frame = rate / FRAME_RATE; frame > 0 && pos < total; )
+		{
+			int samples = MIN(1 + rnd(frame), total - pos);
+			osd_ticks_t start = osd_ticks();
+			(*desc->update)(chip, buffers, samples);
+			elapsed += osd_ticks() - start;
+
+			for (int index = 0; index < samples; index++)
+				for (int output_num = 0; output_num < desc->outputs; output_num++)
+				{
+					stream_sample_t sample = buffers[output_num][index];
+					output[(pos + index) * desc->outputs + output_num] = MAX(-32768, MIN(sample, 32767));
+				}
+			pos += samples;
+			frame -= samples;
+
+			int channel = rnd(active);
+			switch (rnd(4))
+			{
+				case 0: (*desc->key)(chip, channel, true, true); break;
+				case 1: (*desc->key)(chip, channel, true, false); break;
+				case 2: (*desc->key)(chip, channel, false, false); break;
+				default: break;
+			}
+		}
+	}
+
+	double secs = (double)elapsed / (double)osd_ticks_per_second();
+	printf("%s: %d samples in %.3f s, %.1f x realtime\n", desc->name, total, secs, (secs > 0) ? seconds / secs : 0.0);
+	if (strcmp(argv[2], "-") != 0 && !write_wav(argv[2], output, desc->outputs, rate))
+		return 1;
+	return 0;
+}
@@ -0,0 +1,176 @@
+// license:BSD-3-Clause
+// copyright-holders:MAMEdev Team
+/***************************************************************************
+
+    emu.h
+
+    Minimal stand-in for the emulator core headers, just enough to build
+    the Yamaha FM sound cores into ymbench without a running machine.
+    Timers, save states and memory regions are inert.
+
+****************************************************************************/
+
+#pragma once
+
+#ifndef __YMBENCH_EMU_H__
+#define __YMBENCH_EMU_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include "osdcore.h"
+
+
+/***************************************************************************
+    CONSTANTS & DEFINES
+***************************************************************************/
+
+#ifndef M_PI
+#define M_PI                    3.14159265358979323846
+#endif
+
+#define NAME(x)                 x, #x
+#define FUNC(x)                 x, #x
+
+#define TIMER_CALLBACK(name)    void name(running_machine &machine, void *ptr, int param)
+
+#define auto_alloc(m, t)                    (new t())
+#define auto_alloc_clear(m, t)              (new t())
+#define auto_alloc_array(m, t, c)           (new t[c]())
+#define auto_alloc_array_clear(m, t, c)     (new t[c]())
+#define auto_free(m, v)                     ((void)(v))
+#define global_alloc(t)                     (new t())
+#define global_free(v)                      delete v
+
+
+/***************************************************************************
+    TYPE DEFINITIONS
+***************************************************************************/
+
+typedef INT32 stream_sample_t;
+typedef UINT32 offs_t;
+
+class running_machine;
+class device_t;
+typedef void (*timer_fn)(running_machine &machine, void *ptr, int param);
+
+
+// ======================> attotime
+
+// times are only compared for the busy flag, so a double will do
+class attotime
+{
+public:
+	attotime(double seconds = 0) : m_seconds(seconds) { }
+
+	static attotime from_hz(double frequency) { return attotime(1.0 / frequency); }
+	double as_double() const { return m_seconds; }
+
+	attotime operator+(const attotime &right) const { return attotime(m_seconds + right.m_seconds); }
+	attotime operator*(UINT32 factor) const { return attotime(m_seconds * factor); }
+	bool operator==(const attotime &right) const { return m_seconds == right.m_seconds; }
+	bool operator<(const attotime &right) const { return m_seconds < right.m_seconds; }
+
+	static const attotime zero;
+
+private:
+	double m_seconds;
+};
+
+
+// ======================> emu_timer
+
+class emu_timer
+{
+public:
+	void adjust(attotime duration, int param = 0, attotime period = attotime()) { }
+	bool enable(bool enable = true) { return true; }
+};
+
+
+// ======================> device_scheduler
+
+class device_scheduler
+{
+public:
+	emu_timer *timer_alloc(timer_fn callback, const char *name, void *ptr = NULL) { return new emu_timer; }
+	void timer_pulse(attotime period, timer_fn callback, const char *name, int param = 0, void *ptr = NULL) { }
+	void timer_set(attotime duration, timer_fn callback, const char *name, int param = 0, void *ptr = NULL) { }
+};
+
+
+// ======================> save_manager
+
+struct save_prepost_delegate
+{
+	template<class _Function, class _Object> save_prepost_delegate(_Function function, const char *name, _Object object) { }
+};
+
+class save_manager
+{
+public:
+	void register_presave(save_prepost_delegate func) { }
+	void register_postload(save_prepost_delegate func) { }
+};
+
+
+// ======================> memory_region
+
+class memory_region
+{
+public:
+	UINT8 *base() { return NULL; }
+	UINT32 bytes() const { return 0; }
+};
+
+
+// ======================> running_machine
+
+class running_machine
+{
+public:
+	device_t &root_device();
+	attotime time() const { return attotime(); }
+	device_scheduler &scheduler() { return m_scheduler; }
+	save_manager &save() { return m_save; }
+
+private:
+	device_scheduler m_scheduler;
+	save_manager m_save;
+};
+
+
+// ======================> device_t
+
+class device_t
+{
+public:
+	device_t(UINT32 clock = 0) : m_clock(clock) { }
+
+	running_machine &machine() const { return m_machine; }
+	const char *tag() const { return "ym"; }
+	UINT32 clock() const { return m_clock; }
+	memory_region *memregion(const char *tag) const { return &m_region; }
+
+	template<class _ItemType> void save_item(_ItemType &value, const char *valname, int index = 0) { }
+	template<class _ItemType> void save_pointer(_ItemType *value, const char *valname, UINT32 count, int index = 0) { }
+
+private:
+	mutable running_machine m_machine;
+	mutable memory_region m_region;
+	UINT32 m_clock;
+};
+
+inline device_t &running_machine::root_device() { static device_t root; return root; }
+
+
+/***************************************************************************
+    FUNCTION PROTOTYPES
+***************************************************************************/
+
+inline void CLIB_DECL logerror(const char *format, ...) { }
+
+
+#endif  /* __YMBENCH_EMU_H__ */